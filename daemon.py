@@ -14,6 +14,7 @@ from datetime import datetime
 PRECOMPUTE_BIN = "./precompute.exe" if sys.platform == "win32" else "./precompute"
 LOOKUP_BIN = "./candidate_lookup.exe" if sys.platform == "win32" else "./candidate_lookup"
 CHECK_BIN = "./candidate_check.exe" if sys.platform == "win32" else "./candidate_check"
+TABLE_CACHE_BIN = "./table_cache"
 
 gpu_queue = queue.Queue()
 cpu_queue = queue.Queue()
@@ -68,14 +69,15 @@ def start_gpu_worker(working_dir: str):
     t.start()
 
 
-def cpu_worker(working_dir: str):
+def cpu_worker(working_dir: str, table_cache: str):
     while True:
         job = cpu_queue.get()
         if job is None:
             break
         cipher_text, batch, batch_num, total_batches, total_tables = job
         
-        cmd = [LOOKUP_BIN, cipher_text, working_dir] + batch
+        cache_args = ["-c", table_cache] if table_cache else []
+        cmd = [LOOKUP_BIN] + cache_args + [cipher_text, working_dir] + batch
         result = subprocess.run(cmd, capture_output=True, text=True)
         
         lines = result.stdout.strip().split('\n') if result.stdout.strip() else []
@@ -99,17 +101,35 @@ def cpu_worker(working_dir: str):
         cpu_queue.task_done()
 
 
-def start_cpu_workers(working_dir: str, num_workers: int):
+def start_cpu_workers(working_dir: str, num_workers: int, table_cache: str):
     for _ in range(num_workers):
-        t = threading.Thread(target=cpu_worker, args=(working_dir,), daemon=True)
+        t = threading.Thread(target=cpu_worker, args=(working_dir, table_cache), daemon=True)
         t.start()
 
 
+def table_cache_loader(table_cache: str, tables: list, max_mb: int):
+    # Tables become visible to lookups one by one as they finish copying;
+    # lookups read the rest from disk meanwhile
+    cmd = [TABLE_CACHE_BIN, "-d", table_cache, "load"]
+    if max_mb:
+        cmd += ["-m", str(max_mb)]
+    start = time.time()
+    result = subprocess.run(cmd + tables, capture_output=True, text=True)
+    summary = result.stdout.strip().split('\n')[-1] if result.stdout.strip() else "no output"
+    log("CACHE", "tables", f"{summary} ({time.time() - start:.1f}s)")
+
+
+def start_table_cache(table_cache: str, tables: list, max_mb: int):
+    log("CACHE", "tables", f"Loading {len(tables)} tables into {table_cache}")
+    t = threading.Thread(target=table_cache_loader, args=(table_cache, tables, max_mb), daemon=True)
+    t.start()
+
+
 def get_tables(tables_dir: str):
     tables = []
     for root, dirs, files in os.walk(tables_dir):
         for f in files:
-            if f.endswith(".rt") or f.endswith(".rtc"):
+            if f.endswith((".rt", ".rte", ".rtef")):
                 tables.append(os.path.join(root, f))
     return sorted(tables)
 
@@ -142,6 +162,7 @@ def main(args, poll_rate: int = 5):
     working_dir = args.directory
     tables_dir = args.rainbow_tables
     num_workers = args.workers
+    table_cache = args.table_cache
 
     os.makedirs(working_dir, exist_ok=True)
 
@@ -155,14 +176,18 @@ def main(args, poll_rate: int = 5):
     print(f"  Tables:   {len(tables)}")
     print(f"  Workers:  {num_workers} CPU + 1 GPU")
     print(f"  Watching: {working_dir}/")
+    if table_cache:
+        print(f"  Cache:    {table_cache}")
     print()
 
     if len(tables) == 0:
         print(f"ERROR: No tables found in {tables_dir}")
         sys.exit(1)
 
+    if table_cache:
+        start_table_cache(table_cache, tables, args.table_cache_mb)
     start_gpu_worker(working_dir)
-    start_cpu_workers(working_dir, num_workers)
+    start_cpu_workers(working_dir, num_workers, table_cache)
 
     batch_size = 10
 
@@ -200,5 +225,9 @@ if __name__ == '__main__':
     parser.add_argument("-d", "--directory", default="working", help="Working directory")
     parser.add_argument("-rt", "--rainbow-tables", default="tables", help="Rainbow tables directory")
     parser.add_argument("-w", "--workers", type=int, default=2, help="CPU workers (1 per ciphertext)")
+    parser.add_argument("-tc", "--table-cache", default=None,
+                        help="Keep tables resident in this shared memory directory (e.g. /dev/shm/destroy)")
+    parser.add_argument("-tm", "--table-cache-mb", type=int, default=0,
+                        help="RAM budget for the table cache in MB (default: no limit)")
     args = parser.parse_args()
     main(args)
\ No newline at end of file
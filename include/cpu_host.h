@@ -0,0 +1,25 @@
+#ifndef CPU_HOST_H
+#define CPU_HOST_H
+
+#include <stdint.h>
+
+// CPU counterparts of the OpenCL host calls, for machines without a GPU.
+// Chains are walked by the bitsliced DES engine (des_bs.h), so only the
+// byte#7-7 keyspace (plaintext_space_total = 2^56) is supported.
+
+// Fills end_indices[pos] for every position pos < chain_len - 1 exactly
+// like gpu_precompute, on threads threads. Returns the number of end
+// indices or -1 on error.
+int cpu_precompute(const uint8_t *ciphertext, uint32_t chain_len, uint32_t reduction_offset,
+                   uint64_t plaintext_space_total, uint64_t *end_indices, int threads);
+
+// Walks each candidate chain from its start index to its position and
+// compares the hash there with target_hash, cheapest positions first and
+// stopping at the first match. Returns 1 with the 7-byte key in found_key,
+// 0 if every candidate is a false alarm, -1 on error.
+int cpu_check_false_alarms(const uint8_t *target_hash, const uint64_t *start_indices,
+                           const uint32_t *positions, uint32_t num_candidates,
+                           uint32_t reduction_offset, uint64_t plaintext_space_total,
+                           uint8_t *found_key);
+
+#endif
\ No newline at end of file
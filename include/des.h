@@ -3,7 +3,25 @@
 
 #include <stdint.h>
 
-// DES encrypt NetNTLMv1 challenge with 7-byte key
+// Key nibbles of a 7-byte key, for des_subkey_nibble_table
+#define DES_SUBKEY_NIBBLES 14
+
+// DES encrypt NetNTLMv1 challenge with 7-byte key. The round subkeys are
+// xored together from per-key-byte contribution tables (built on first
+// use) instead of running the key schedule.
 void des_encrypt_ntlmv1(const uint8_t *key_56, uint8_t *output);
 
+// Same, running the full key schedule for every key
+void des_encrypt_ntlmv1_setkey(const uint8_t *key_56, uint8_t *output);
+
+// Subkey contribution table for the kernels: table[n][v] is the 32 subkey
+// words of the key whose nibble n (0 = high nibble of key_56[0]) is v and
+// all other bits zero. The subkeys of any key are the xor of its 14 rows.
+void des_subkey_nibble_table(uint32_t table[DES_SUBKEY_NIBBLES][16][32]);
+
+// Initial permutation of an 8-byte block as the two words the rounds start
+// from (each rotated left by one). The challenge gives the IP constants
+// the kernels are built with.
+void des_ip_words(const uint8_t *block, uint32_t *x, uint32_t *y);
+
 #endif
\ No newline at end of file
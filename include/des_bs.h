@@ -0,0 +1,45 @@
+#ifndef DES_BS_H
+#define DES_BS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bitsliced DES chain walker for the byte#7-7 NetNTLMv1 tables. Bit i of
+// every chain's index lives in one machine word (64 chains), AVX2 register
+// (256) or AVX-512 register (512), and DES runs as a fixed sequence of
+// logic gates over all of them at once:
+//   - the key is the index itself (index_to_plaintext is a byte order),
+//     so the key schedule is only a choice of which index bits feed each
+//     S-box input and costs nothing;
+//   - the plaintext is the fixed challenge, so the initial permutation
+//     is constant and the final one is again just wiring;
+//   - the reduction (LE64(hash) + offset + pos) mod 2^56 is a bitsliced
+//     ripple-carry add of a per-chain position counter, whose output bits
+//     are the next key.
+// Chains only leave the bitsliced form when their walk is done.
+
+#define DES_BS_MAX_LANES 512
+
+typedef struct {
+    uint64_t index;     // in: index at the first step; out: index after the walk
+    uint32_t pos;       // reduction position of the first step
+    uint32_t steps;     // DES + reduction steps to take
+} des_bs_job;
+
+// Walks every job: steps times index = (LE64(DES_index(challenge)) +
+// reduction_offset + pos++) mod 2^56, as the precompute and false alarm
+// kernels do. A lane that finishes is refilled with the next job, so the
+// lanes stay busy until the last des_bs_lanes() jobs; ordering the jobs
+// by cost (longest first) keeps that tail short.
+void des_bs_walk(des_bs_job *jobs, size_t count, uint32_t reduction_offset);
+
+// Engine in use ("avx512", "avx2" or "64-bit", widest the CPU supports)
+// and the number of chains it walks at once
+const char *des_bs_engine(void);
+uint32_t des_bs_lanes(void);
+
+// Forces an engine by name (for benchmarks). Returns -1 if it is unknown
+// or the CPU lacks it.
+int des_bs_use(const char *name);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef EF_H
+#define EF_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Partitioned Elias-Fano coding of a sorted end column (.rtef).
+//
+// File layout:
+//   ef_header
+//   ef_block[num_blocks]       directory, one entry per EF_BLOCK_SIZE chains
+//   block data                 per block: low bits, then unary high bits
+//
+// Each block stores (end - first_end) for its chains: the low low_bits
+// bits packed densely, the remaining high bits as a unary bitvector
+// (bit high_i + i set for element i). Uniform 56-bit ends over 2^27
+// chains take ~31 bits per chain instead of 64. The directory lets
+// readers skip or binary search blocks without decoding them.
+
+#define EF_MAGIC "RTEF"
+#define EF_BLOCK_SIZE 256
+
+typedef struct {
+    char magic[4];
+    uint32_t block_size;
+    uint64_t num_chains;
+    uint64_t num_blocks;
+    uint64_t data_offset;      // file offset of block data
+} ef_header;
+
+typedef struct {
+    uint64_t first_end;
+    uint64_t offset;           // byte offset of block data from data_offset
+    uint32_t low_bits;
+    uint32_t count;
+} ef_block;
+
+// Worst-case encoded size in bytes for a block of n values
+size_t ef_block_max_bytes(uint32_t n);
+
+// Encodes n sorted values into out; fills blk (except offset).
+// Returns the number of bytes written.
+size_t ef_encode_block(const uint64_t *values, uint32_t n, ef_block *blk, uint64_t *out);
+
+// Decodes a whole block into out (blk->count values)
+void ef_decode_block(const ef_block *blk, const uint64_t *data, uint64_t *out);
+
+// Number of elements below value (rank), found without decoding the
+// block: a select over the unary high bits lands on the elements sharing
+// value's high part, and only those are compared by their low bits.
+// *equal (if not NULL) is set when the element at the rank is value.
+uint32_t ef_block_rank(const ef_block *blk, const uint64_t *data, uint64_t value, int *equal);
+
+// Element at index (select)
+uint64_t ef_block_get(const ef_block *blk, const uint64_t *data, uint32_t index);
+
+// Finds value in a block without decoding it. Returns 1 and sets *index
+// to its first position within the block if present.
+int ef_block_find(const ef_block *blk, const uint64_t *data, uint64_t value, uint32_t *index);
+
+#endif
\ No newline at end of file
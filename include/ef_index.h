@@ -0,0 +1,66 @@
+#ifndef EF_INDEX_H
+#define EF_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ef.h"
+#include "table.h"
+#include "set_file.h"
+
+// Resident end index (.rtix): the end column of every table coded as
+// partitioned Elias-Fano (the .rtef block coding) in one file, built
+// offline by rtindex and held in memory at lookup time. Lookups join the
+// sorted queries against it without touching the tables: the block
+// directory finds a query's block, rank/select inside the block finds
+// its chain ordinal, and only a match reads anything from disk, the
+// chain's start index (one 8-byte read from the .rt or .rts file).
+// Membership is exact, at ~31 bits per chain plus 0.75 for the directory.
+//
+// File layout (set_file.h), per table: ef_block[num_blocks], then block
+// data.
+
+#define EF_INDEX_MAGIC "RTIX"
+
+typedef struct {
+    set_file_table table;              // which table, and its end range
+    uint64_t num_blocks;               // of EF_BLOCK_SIZE chains
+    uint64_t block_offset;             // file offset of the directory
+    uint64_t data_offset;              // file offset of the block data
+    uint64_t data_bytes;
+} ef_index_entry;
+
+typedef struct {
+    const set_file_header *header;
+    const ef_index_entry *entries;
+    const uint8_t *data;
+    size_t size;
+} ef_index;
+
+typedef struct {
+    uint64_t queries;                  // in the table's end range
+    uint64_t blocks;                   // blocks searched
+    uint64_t reads;                    // start indices read
+} ef_index_stats;
+
+// Writes an index over the given .rt / .rte tables. Returns 0 on success.
+int ef_index_build(const char *out_path, char **table_paths, int num_tables);
+
+// Loads an index into memory (mapped and faulted in where supported)
+int ef_index_open(ef_index *ix, const char *path);
+void ef_index_close(ef_index *ix);
+
+// Entry for a table file, matched by file name and checked against its
+// size; NULL if the index does not (currently) cover it.
+const ef_index_entry *ef_index_find(const ef_index *ix, const char *table_path);
+
+// Joins the sorted queries against one table's coded ends and reads the
+// start index of each match from the table. Appends matches like
+// table_join_search, dropping those whose start cannot be read; returns
+// the number found, or -1 if the table cannot be opened.
+int ef_index_search(const ef_index *ix, const ef_index_entry *e, const char *table_path,
+                    const rt_query *queries, uint32_t num_queries,
+                    uint64_t *start_indices, uint32_t *positions,
+                    uint32_t *num_candidates, uint32_t max_candidates,
+                    ef_index_stats *stats);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef FUSE_H
+#define FUSE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Binary fuse filter (Graf & Lemire): approximate set membership over
+// 64-bit keys with no false negatives. Each key maps to three slots in
+// consecutive segments of a fingerprint array; a key is reported present
+// when the xor of its three fingerprints equals its own fingerprint.
+// With 8-bit fingerprints the filter takes ~9 bits per key and has a
+// 1/256 false positive rate; 16-bit fingerprints take ~18 bits per key
+// for 1/65536.
+
+typedef struct {
+    uint64_t seed;
+    uint32_t fp_bits;                // 8 or 16
+    uint32_t segment_length;
+    uint32_t segment_length_mask;
+    uint32_t segment_count_length;
+    uint32_t array_length;           // fingerprints
+    uint32_t reserved;
+} fuse_params;
+
+typedef struct {
+    fuse_params p;
+    const void *fingerprints;        // array_length * fp_bits / 8 bytes
+} fuse_filter;
+
+// Sizes the filter for n keys (n < 2^32) with fp_bits-bit fingerprints.
+// Returns -1 for an unsupported fingerprint width.
+int fuse_init(fuse_params *p, uint64_t n, uint32_t fp_bits);
+
+static inline size_t fuse_bytes(const fuse_params *p) {
+    return (size_t)p->array_length * (p->fp_bits / 8);
+}
+
+// Number of distinct keys in keys[i * stride], i < n, duplicates adjacent
+// (a sorted end column). Size the filter for this many.
+uint64_t fuse_count_distinct(const uint64_t *keys, uint32_t stride, uint64_t n);
+
+// Fills fingerprints (fuse_bytes(p) bytes) for the keys, skipping adjacent
+// duplicates; sets p->seed. Needs ~24 bytes of scratch per key. Returns 0
+// on success.
+int fuse_build(fuse_params *p, const uint64_t *keys, uint32_t stride, uint64_t n,
+               void *fingerprints);
+
+static inline uint64_t fuse_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// The three slots of a hashed key
+static inline void fuse_slots(const fuse_params *p, uint64_t hash, uint32_t *h0,
+                              uint32_t *h1, uint32_t *h2) {
+    uint64_t hi = (uint64_t)(((__uint128_t)hash * p->segment_count_length) >> 64);
+    *h0 = (uint32_t)hi;
+    *h1 = *h0 + p->segment_length;
+    *h2 = *h1 + p->segment_length;
+    *h1 ^= (uint32_t)(hash >> 18) & p->segment_length_mask;
+    *h2 ^= (uint32_t)hash & p->segment_length_mask;
+}
+
+static inline uint64_t fuse_hash(const fuse_params *p, uint64_t key) {
+    return fuse_mix(key + p->seed);
+}
+
+static inline int fuse_contains_hash(const fuse_filter *f, uint64_t hash) {
+    uint32_t h0, h1, h2;
+    fuse_slots(&f->p, hash, &h0, &h1, &h2);
+    uint64_t fp = hash ^ (hash >> 32);
+    if (f->p.fp_bits == 8) {
+        const uint8_t *F = f->fingerprints;
+        return (uint8_t)(fp ^ F[h0] ^ F[h1] ^ F[h2]) == 0;
+    }
+    const uint16_t *F = f->fingerprints;
+    return (uint16_t)(fp ^ F[h0] ^ F[h1] ^ F[h2]) == 0;
+}
+
+static inline int fuse_contains(const fuse_filter *f, uint64_t key) {
+    return fuse_contains_hash(f, fuse_hash(&f->p, key));
+}
+
+// Prefetches a hashed key's three slots ahead of fuse_contains_hash
+static inline void fuse_prefetch(const fuse_filter *f, uint64_t hash) {
+    uint32_t h0, h1, h2;
+    fuse_slots(&f->p, hash, &h0, &h1, &h2);
+    const uint8_t *F = f->fingerprints;
+    uint32_t width = f->p.fp_bits / 8;
+    __builtin_prefetch(F + (size_t)h0 * width);
+    __builtin_prefetch(F + (size_t)h1 * width);
+    __builtin_prefetch(F + (size_t)h2 * width);
+}
+
+#endif
\ No newline at end of file
@@ -13,8 +13,10 @@ typedef cl_int (*clGetDeviceInfo_fn)(cl_device_id, cl_device_info, size_t, void
 typedef cl_context (*clCreateContext_fn)(const cl_context_properties *, cl_uint, const cl_device_id *, void (*)(const char *, const void *, size_t, void *), void *, cl_int *);
 typedef cl_command_queue (*clCreateCommandQueue_fn)(cl_context, cl_device_id, cl_command_queue_properties, cl_int *);
 typedef cl_program (*clCreateProgramWithSource_fn)(cl_context, cl_uint, const char **, const size_t *, cl_int *);
+typedef cl_program (*clCreateProgramWithBinary_fn)(cl_context, cl_uint, const cl_device_id *, const size_t *, const unsigned char **, cl_int *, cl_int *);
 typedef cl_int (*clBuildProgram_fn)(cl_program, cl_uint, const cl_device_id *, const char *, void (*)(cl_program, void *), void *);
 typedef cl_int (*clGetProgramBuildInfo_fn)(cl_program, cl_device_id, cl_program_build_info, size_t, void *, size_t *);
+typedef cl_int (*clGetProgramInfo_fn)(cl_program, cl_program_info, size_t, void *, size_t *);
 typedef cl_kernel (*clCreateKernel_fn)(cl_program, const char *, cl_int *);
 typedef cl_mem (*clCreateBuffer_fn)(cl_context, cl_mem_flags, size_t, void *, cl_int *);
 typedef cl_int (*clSetKernelArg_fn)(cl_kernel, cl_uint, size_t, const void *);
@@ -35,8 +37,10 @@ extern clGetDeviceInfo_fn p_clGetDeviceInfo;
 extern clCreateContext_fn p_clCreateContext;
 extern clCreateCommandQueue_fn p_clCreateCommandQueue;
 extern clCreateProgramWithSource_fn p_clCreateProgramWithSource;
+extern clCreateProgramWithBinary_fn p_clCreateProgramWithBinary;
 extern clBuildProgram_fn p_clBuildProgram;
 extern clGetProgramBuildInfo_fn p_clGetProgramBuildInfo;
+extern clGetProgramInfo_fn p_clGetProgramInfo;
 extern clCreateKernel_fn p_clCreateKernel;
 extern clCreateBuffer_fn p_clCreateBuffer;
 extern clSetKernelArg_fn p_clSetKernelArg;
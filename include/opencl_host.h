@@ -6,6 +6,16 @@
 #include <stdint.h>
 #include <CL/cl.h>
 
+// DES variants of each kernel, timed on the device when the kernels load:
+// the key schedule per step, subkeys from contribution tables ("_sk") and
+// bitsliced DES over 32 chains per work item ("_bs", 2^56 keyspace only)
+enum {
+    GPU_DES_SCHEDULE,
+    GPU_DES_SUBKEYS,
+    GPU_DES_BITSLICED,
+    GPU_DES_VARIANTS
+};
+
 typedef struct {
     cl_platform_id platform;
     cl_device_id device;
@@ -15,13 +25,25 @@ typedef struct {
     cl_kernel kernel;
     cl_program fa_program;
     cl_kernel fa_kernel;
+    cl_mem subkeys;                 // des_subkey_nibble_table, for the _sk kernels
+    int kernel_variant;             // GPU_DES_* of kernel and fa_kernel
+    int fa_variant;
+    uint32_t reduction_offset;      // table the kernels are built and timed for
+    uint64_t plaintext_space_total; // (gpu_set_table_params; 0 = generic build)
     char device_name[128];
+    char driver_version[64];
     uint32_t compute_units;
     size_t max_work_group_size;
 } gpu_context;
 
 int gpu_init(gpu_context *ctx);
 void gpu_cleanup(gpu_context *ctx);
+// Table parameters to specialize the kernels for, passed to the compiler
+// as -D options along with the challenge: a power-of-two keyspace reduces
+// with a mask. Call before loading the kernels; runs with other parameters
+// still work, through the generic code.
+void gpu_set_table_params(gpu_context *ctx, uint32_t reduction_offset,
+                          uint64_t plaintext_space_total);
 int gpu_load_kernel(gpu_context *ctx, const char *source_file, const char *kernel_name);
 int gpu_load_false_alarm_kernel(gpu_context *ctx, const char *source_file);
 int gpu_precompute(gpu_context *ctx, const uint8_t *ciphertext, uint32_t chain_len,
@@ -0,0 +1,76 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "table.h"
+
+// Background table readers: tables are grouped by the device they live on
+// and each device gets its own reader stream(s), so several drives are read
+// in parallel while search workers consume whichever table is ready first.
+
+typedef enum {
+    SLOT_FREE,
+    SLOT_LOADING,
+    SLOT_READY,
+    SLOT_IN_USE,
+} prefetch_slot_state;
+
+typedef struct {
+    rt_table table;
+    int index;             // position in the path list
+    int status;            // 0 = loaded, -1 = load failed
+    prefetch_slot_state state;
+} prefetch_slot;
+
+typedef struct {
+    uint64_t id;           // st_dev of the tables in this group
+    int *tables;           // indices into the path list, in order
+    int num_tables;
+    int next;              // next table to hand to a reader
+} prefetch_device;
+
+typedef struct table_prefetcher table_prefetcher;
+
+typedef struct {
+    table_prefetcher *pf;
+    prefetch_device *device;
+    pthread_t thread;
+} prefetch_reader;
+
+struct table_prefetcher {
+    char **paths;
+    int num_paths;
+    prefetch_device *devices;
+    int num_devices;
+    prefetch_reader *readers;
+    int num_readers;
+    int depth;             // number of slots (tables held at once)
+    prefetch_slot *slots;
+    int delivered;         // tables handed to consumers
+    int stop;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+    // Stage timings (seconds of wall-clock time, final after prefetch_stop)
+    double io_time;        // time at least one table was loading
+    double exposed_time;   // time tables were loading and none was being searched
+    int loading;           // slots in SLOT_LOADING / SLOT_IN_USE, for the timings
+    int in_use;
+    double last_change;
+};
+
+// ram_budget bounds how many bytes of tables are held at once. At least one
+// slot per reader stream plus one per consumer is always used; consumers
+// <= 0 means one per device.
+int prefetch_start(table_prefetcher *pf, char **paths, int num_paths, uint64_t ram_budget,
+                   int streams_per_device, int consumers);
+
+// Blocks until any table is ready; returns NULL once every table has been
+// handed out. slot->status is -1 if the table failed to load. Every slot
+// returned must be released. Safe to call from several threads.
+prefetch_slot *prefetch_next(table_prefetcher *pf);
+void prefetch_release(table_prefetcher *pf, prefetch_slot *slot);
+void prefetch_stop(table_prefetcher *pf);
+
+#endif
\ No newline at end of file
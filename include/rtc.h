@@ -0,0 +1,61 @@
+#ifndef RTC_H
+#define RTC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// RainbowCrack compressed tables (.rtc, as written by rt2rtc).
+//
+// Not built in by default: the layout below is the documented one, but it
+// has not been checked against files produced by rt2rtc, so table_load
+// rejects .rtc files unless compiled with -DTABLE_RTC_EXPERIMENTAL. Files
+// with any other version, or whose index is inconsistent, are rejected.
+//
+// Layout (little-endian):
+//   rtc_header
+//   uint32_t index[(1 << index_bits) + 1]
+//                      index[p] = first chain whose end >> end_point_bits == p,
+//                      index[1 << index_bits] = chain_count
+//   records            chain_count fixed-size records sorted by end, each
+//                      (start_point_bits + end_point_bits + 7) / 8 bytes:
+//                      (start - start_point_min) | (end & low_mask) << start_point_bits
+//
+// The high end bits live only in the index, so a lookup jumps straight to
+// the chains sharing its prefix and binary searches that run.
+
+#define RTC_VERSION 1
+
+typedef struct {
+    uint32_t version;            // RTC_VERSION
+    uint16_t start_point_bits;
+    uint16_t end_point_bits;     // low end bits stored per chain
+    uint32_t index_bits;         // remaining high end bits, via the index
+    uint32_t reserved;
+    uint64_t chain_count;
+    uint64_t start_point_min;
+} rtc_header;
+
+typedef struct {
+    const rtc_header *header;
+    const uint32_t *index;
+    const uint8_t *records;
+    uint32_t record_bytes;
+    uint64_t num_prefixes;
+    uint64_t start_mask;
+    uint64_t low_mask;
+} rtc_view;
+
+// Validates the header against the file size, and the index: it must
+// never decrease and end at chain_count, so every run it gives lies within
+// the records. Returns 0 on success.
+int rtc_open(rtc_view *v, const void *data, size_t size);
+
+// Decodes chain i whose end prefix is known to be prefix
+void rtc_chain(const rtc_view *v, uint64_t i, uint64_t prefix, uint64_t *start, uint64_t *end);
+
+uint64_t rtc_start(const rtc_view *v, uint64_t i);
+
+// Finds end; returns 1 and sets *chain if present
+int rtc_find(const rtc_view *v, uint64_t end, uint64_t *chain);
+
+#endif
\ No newline at end of file
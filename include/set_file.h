@@ -0,0 +1,88 @@
+#ifndef SET_FILE_H
+#define SET_FILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "table.h"
+#include "uring.h"
+
+// Layout and I/O shared by the files built offline over a set of tables
+// and kept resident at lookup time: the filter set (.rtfs, table_filter.h)
+// and the end index (.rtix, ef_index.h).
+//
+// File layout:
+//   set_file_header
+//   entry[num_tables]           each starting with a set_file_table
+//   per table, 64-byte aligned: data written by the set's build_entry
+
+#define SET_FILE_NAME_LEN 240
+#define SET_FILE_ALIGN 64
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t num_tables;
+    uint32_t block_size;               // chains per EF block / filter region
+    uint64_t file_size;
+} set_file_header;
+
+// First member of every entry: the table it describes
+typedef struct {
+    char name[SET_FILE_NAME_LEN];      // table file name (no directory)
+    uint64_t file_size;                // identity checks against the table
+    uint64_t num_chains;
+    uint64_t first_end;
+    uint64_t last_end;
+} set_file_table;
+
+static inline uint64_t set_file_align(uint64_t offset) {
+    return (offset + SET_FILE_ALIGN - 1) / SET_FILE_ALIGN * SET_FILE_ALIGN;
+}
+
+// Fills the rest of one table's entry (its set_file_table is filled in
+// already) and writes its data at or after *offset, advancing it past
+// the data. Returns 0 on success.
+typedef int (*set_file_build_fn)(FILE *out, const rt_table *table, const char *path,
+                                 void *entry, uint64_t *offset, void *arg);
+
+// Writes a set file over the given .rt / .rte tables, which must be sorted
+// by end and have distinct file names. The directory of entry_size-byte
+// entries is written last. Returns the file size, or -1 (the partial file
+// is removed); *total_chains is the chain count over all tables.
+int64_t set_file_build(const char *out_path, const char *magic, uint32_t version,
+                       uint32_t block_size, char **table_paths, int num_tables,
+                       size_t entry_size, set_file_build_fn build_entry, void *arg,
+                       uint64_t *total_chains);
+
+// Maps a set file (faulted in where supported) and checks its header and
+// that the directory of entry_size-byte entries fits. Returns 0 on success.
+int set_file_open(const char *path, const char *magic, uint32_t version, uint32_t block_size,
+                  size_t entry_size, const uint8_t **data, size_t *size);
+void set_file_close(const uint8_t *data, size_t size);
+
+// Entry for a table file, matched by file name and checked against its
+// size; NULL if the set has no (current) entry for it.
+const void *set_file_find(const uint8_t *data, size_t entry_size, const char *table_path);
+
+// Narrows the sorted queries to [*q, *q_end), those inside the table's
+// end range; the rest cannot match.
+void set_file_query_range(const set_file_table *t, const rt_query *queries,
+                          uint32_t num_queries, uint32_t *q, uint32_t *q_end);
+
+int set_file_write_at(FILE *f, uint64_t offset, const void *data, size_t len);
+int set_file_read_at(int fd, void *buf, size_t len, uint64_t offset);
+
+typedef struct {
+    void *buf;
+    uint32_t len;
+    uint64_t offset;
+} set_file_read;
+
+// Reads every request from fd: queue_depth reads in flight through ring,
+// or one pread at a time when ring is NULL. Returns 0 if all completed in
+// full.
+int set_file_read_batch(uring *ring, unsigned queue_depth, int fd, const set_file_read *reads,
+                        uint32_t count);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef STREE_H
+#define STREE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Static search tree over a table's end column (.rtst sidecar, built by
+// rtconvert and picked up by table_load when it sits next to the table).
+//
+// File layout:
+//   stree_header               256 bytes
+//   levels, root first         num_levels levels of 64-byte nodes
+//
+// A node holds 8 keys, one cache line. Key j of the level at height h
+// (h = 1 just above the chains) is the largest end of chains
+// [j * 8^h, (j + 1) * 8^h); a level's last node is padded with
+// STREE_PAD. Descending takes one node per level: the number of keys
+// below the query picks the child, and the leaf is a run of 8 chains in
+// the table itself. The top levels are small enough to stay in cache, so
+// a cold lookup misses on the last few levels and the leaf only, instead
+// of on nearly every step of a binary search over the full column.
+
+#define STREE_MAGIC "RTST"
+#define STREE_FANOUT 8
+#define STREE_MAX_LEVELS 27
+#define STREE_PAD 0x7fffffffffffffffULL   // above any end (signed SIMD compares)
+
+typedef struct {
+    char magic[4];
+    uint32_t fanout;
+    uint64_t num_chains;
+    uint64_t first_end;
+    uint64_t last_end;          // table identity check, and the root's bound
+    uint32_t num_levels;
+    uint32_t reserved;
+    uint64_t level_offset[STREE_MAX_LEVELS];   // in keys from the end of the header
+} stree_header;
+
+typedef struct {
+    const stree_header *header;
+    const uint64_t *keys;
+} stree_view;
+
+// Validates the header against the file size. Returns 0 on success.
+int stree_open(stree_view *v, const void *data, size_t size);
+
+// First chain with end >= key (num_chains if none). ends/stride as in
+// rt_table. Nodes are compared with AVX2 where the CPU has it.
+uint64_t stree_lower_bound(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                           uint64_t key);
+
+// Lower bounds for count keys at once. The searches descend in lockstep,
+// prefetching the node each one picked on a level before any of them
+// reads the next, so their cache misses overlap.
+void stree_lower_bound_batch(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                             const uint64_t *keys, uint32_t count, uint64_t *chains);
+
+// Writes the tree for n sorted ends to out. Tables of STREE_FANOUT chains
+// or fewer get no tree. Returns the file size or -1.
+int64_t stree_write(FILE *out, const uint64_t *ends, uint32_t stride, uint64_t n);
+
+#endif
\ No newline at end of file
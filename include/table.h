@@ -2,14 +2,171 @@
 #define TABLE_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include "ef.h"
+#include "rtc.h"
+#include "stree.h"
+#include "table_meta.h"
+
+typedef enum {
+    TABLE_FORMAT_RT,       // interleaved [start][end] pairs (.rt)
+    TABLE_FORMAT_SPLIT,    // end column (.rte) + start column (.rts)
+    TABLE_FORMAT_EF,       // Elias-Fano coded end column (.rtef) + start column (.rts)
+    TABLE_FORMAT_RTC,      // RainbowCrack compressed table (.rtc), see rtc.h
+} table_format;
+
+typedef enum {
+    TABLE_IO_MMAP,         // read-only mapping through the page cache
+    TABLE_IO_BUFFERED,     // read()/fread into private memory
+    TABLE_IO_URING,        // io_uring reads with O_DIRECT (bypasses the page cache)
+} table_io_backend;
 
 typedef struct {
-    uint64_t *data;        // raw interleaved data
+    uint64_t *data;        // raw file data: interleaved pairs, or the end column
     uint64_t num_chains;
+    size_t size;           // bytes backing data
+    int mapped;            // data is a read-only mapping of the file
+    size_t map_size;       // mapping length (rounded up on hugetlbfs)
+    table_format format;
+    const uint64_t *ends;  // end of chain i is ends[i * stride] (NULL for EF/RTC)
+    uint32_t stride;
+    int starts_fd;         // split/EF tables: start column, read per match
+    const ef_header *ef;   // EF tables: header, directory and block data
+    const ef_block *ef_blocks;
+    const uint8_t *ef_data;
+    rtc_view rtc;          // RTC tables: header, prefix index and records
+    uint32_t *radix;       // radix directory: chains with end >> radix_shift == b
+    uint32_t radix_shift;  //   are radix[b] .. radix[b + 1] - 1 (NULL until built)
+    uint64_t radix_max;    // largest end in the table
+    stree_view stree;      // search tree sidecar (.rtst), header NULL if none
+    void *stree_data;
+    size_t stree_size;
+    int paged;             // opened by table_open_paged: only the sidecar is resident
+    int fd;                // paged tables: the table file, read a page at a time
+    const table_meta_header *meta;
+    const uint64_t *fences;
+    void *meta_data;
+    size_t meta_size;
+    uint64_t *page;        // last page read (page_index), UINT64_MAX for none
+    uint64_t page_index;
 } rt_table;
 
+table_format table_format_of(const char *filename);
+
+// Selects how table_load and table_stream_search read files. queue_depth
+// and block_size tune the io_uring backend (0 keeps the defaults); block
+// size is rounded up to the 4 KB O_DIRECT alignment. io_uring falls back
+// to buffered reads where unavailable.
+void table_set_io(table_io_backend backend, unsigned queue_depth, size_t block_size);
+int table_io_parse(const char *name, table_io_backend *backend);
+const char *table_io_name(table_io_backend backend);
+
+// Serves tables from the resident table cache in dir (see table_cache.h)
+// when it holds an up-to-date copy; other tables are read as usual.
+// Returns -1 if dir holds no cache.
+int table_set_cache(const char *dir);
+
+// Start column path (.rts) for a split or EF table
+void table_starts_path(const char *ends_path, char *starts_path, size_t size);
+
+// Search tree sidecar path (.rtst) for an .rt or split table
+void table_stree_path(const char *table_path, char *stree_path, size_t size);
+
+// Metadata sidecar path (.rtm) for an .rt or split table
+void table_meta_path(const char *table_path, char *meta_path, size_t size);
+
+// Maps the table file read-only where supported (no private copy, pages
+// stay in the page cache between runs); falls back to malloc+fread. The
+// buffered and io_uring backends always read into private memory. Tables
+// in the resident cache are mapped from shared memory regardless.
+// Split tables load only the end column; starts are read on demand.
+// A search tree sidecar next to an .rt or split table is mapped too and
+// used by table_search and table_search_batch.
 int table_load(rt_table *table, const char *filename);
+// Opens an .rt or split table through its metadata sidecar without reading
+// the table: table_search, table_search_batch and table_join_search read
+// the 4 KB pages they need with pread, and table_start reads single
+// starts. Returns -1 if there is no sidecar or it does not match the file,
+// or if the table is in the resident cache (table_load maps it from there).
+// A page that does not start at its fence is a read failure.
+int table_open_paged(rt_table *table, const char *filename);
+
+// A paged search costs a random 4 KB read per query; reading the whole
+// table sequentially wins once the queries cover more than about one page
+// in TABLE_PAGED_PAGE_RATIO.
+#define TABLE_PAGED_PAGE_RATIO 8
+static inline int table_paged_pays_off(const rt_table *table, uint64_t num_queries) {
+    return num_queries * TABLE_PAGED_PAGE_RATIO < table->meta->num_fences;
+}
+
+// Faults the whole table into memory (blocks on I/O for mapped tables).
+int table_populate(rt_table *table);
 void table_free(rt_table *table);
+// Uses the search tree sidecar if there is one, else the radix directory
+// when built, else binary search.
 uint64_t table_search(rt_table *table, uint64_t end_index, int *found);
 
+// Builds the radix directory over the top bits of the end column (about
+// 32 chains per bucket) so table_search finds a chain with one directory
+// lookup and an interpolation probe or two instead of ~27 binary search
+// steps. One sequential pass over the ends; a no-op for EF/RTC tables,
+// which keep their own block index. Without it table_search falls back
+// to binary search.
+int table_build_index(rt_table *table);
+
+// The directory build streams the whole end column, which costs about as
+// much as num_chains / 16 binary searches; below that many queries
+// binary search alone is faster.
+#define TABLE_INDEX_QUERY_RATIO 16
+static inline int table_index_pays_off(const rt_table *table, uint64_t num_queries) {
+    return num_queries * TABLE_INDEX_QUERY_RATIO >= table->num_chains;
+}
+
+// Searches every end index in groups of SEARCH_BATCH_GROUP that advance
+// in lockstep, prefetching each search's next probe before touching any of
+// them, so a group's cache misses are in flight together instead of one at
+// a time. Uses the search tree sidecar if there is one, else the radix
+// directory when built, else binary search.
+// Appends matches in position order (position = index into end_indices);
+// returns the number found.
+#define SEARCH_BATCH_GROUP 32
+int table_search_batch(rt_table *table, const uint64_t *end_indices, uint32_t num_indices,
+                       uint64_t *start_indices, uint32_t *positions,
+                       uint32_t *num_candidates, uint32_t max_candidates);
+
+// Start index of chain i. Returns -1 if it cannot be read (split and
+// paged tables read it from disk); callers drop the candidate.
+int table_start(rt_table *table, uint64_t chain, uint64_t *start);
+
+// Precomputed end index with its chain position, sorted by end for joins
+typedef struct {
+    uint64_t end;
+    uint32_t pos;
+} rt_query;
+
+// Builds the query array sorted by end (ties by position). Caller frees.
+rt_query *queries_build(const uint64_t *end_indices, uint32_t num_indices);
+
+// Merge-joins a loaded table against the sorted queries in one forward
+// pass. EF tables skip blocks without queries and decode the rest one
+// block at a time; RTC tables skip whole end prefixes the same way.
+// Gaps between matches in .rt and split tables are crossed by galloping
+// (the search tree sidecar measured no faster here).
+// Appends matches; returns the number found.
+int table_join_search(rt_table *table, const rt_query *queries, uint32_t num_queries,
+                      uint64_t *start_indices, uint32_t *positions,
+                      uint32_t *num_candidates, uint32_t max_candidates);
+
+// Streams the table file sequentially in chunk_size-byte reads and
+// merge-joins each chunk against the sorted queries, so memory use is
+// bounded by chunk_size instead of the table size. Split tables stream
+// only the end column. With the io_uring backend, queue_depth blocks are
+// kept in flight in registered buffers and each is joined as soon as it
+// completes, in file order. The mmap backend maps the file and joins it
+// front to back. Appends matches to start_indices/positions; returns the
+// number found or -1 on I/O error.
+int table_stream_search(const char *filename, const rt_query *queries, uint32_t num_queries,
+                        size_t chunk_size, uint64_t *start_indices, uint32_t *positions,
+                        uint32_t *num_candidates, uint32_t max_candidates);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef TABLE_CACHE_H
+#define TABLE_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Resident table cache: table files are copied once into shared memory
+// (a tmpfs directory such as /dev/shm, or a hugetlbfs mount for 2 MB/1 GB
+// pages) and stay there across processes. Lookups map the cached copy
+// read-only instead of reading the table from disk. A registry file in
+// the cache directory records which tables are cached and how often each
+// has been used. Linux only.
+
+#define TABLE_CACHE_MAGIC "RTCR"
+#define TABLE_CACHE_MAX_TABLES 4096
+#define TABLE_CACHE_REGISTRY "registry"
+
+typedef struct {
+    char path[1024];       // canonical path of the source table
+    char name[24];         // cached file name in the cache directory
+    uint64_t size;         // source file size
+    int64_t mtime;         // source mtime; a changed table is not served
+    uint64_t hits;         // number of times a lookup attached to it
+    int64_t last_hit;
+    int64_t loaded;
+    uint32_t ready;        // set once the copy is complete
+    uint32_t reserved;
+} table_cache_entry;
+
+typedef struct {
+    char magic[4];
+    uint32_t capacity;
+    uint64_t page_size;    // file sizes are rounded to this (hugetlbfs)
+    uint32_t count;
+    uint32_t reserved;
+    table_cache_entry entries[];
+} table_cache_header;
+
+typedef struct {
+    char dir[1024];
+    int fd;
+    table_cache_header *hdr;
+    size_t size;
+} table_cache;
+
+// Opens the registry in dir; create makes the directory and registry
+// if they do not exist yet.
+int table_cache_open(table_cache *cache, const char *dir, int create);
+void table_cache_close(table_cache *cache);
+
+// Copies a table file into the cache. Returns 0 when copied, 1 when an
+// up-to-date copy was already there, -1 on error.
+int table_cache_add(table_cache *cache, const char *path);
+
+// Cached copy of path opened read-only, or -1 if it is not cached or the
+// source changed since. Counts a hit. *map_size is the length to map
+// (the file size rounded up to the cache page size).
+int table_cache_file(table_cache *cache, const char *path, uint64_t *size, size_t *map_size);
+
+// 1 if an up-to-date copy of path is cached (does not count a hit)
+int table_cache_has(table_cache *cache, const char *path);
+
+// Removes every cached copy and the registry.
+int table_cache_drop(table_cache *cache);
+
+// Fraction of the cached copy currently resident in memory (0..1)
+double table_cache_residency(table_cache *cache, const table_cache_entry *entry);
+
+#endif
\ No newline at end of file
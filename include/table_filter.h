@@ -0,0 +1,70 @@
+#ifndef TABLE_FILTER_H
+#define TABLE_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fuse.h"
+#include "table.h"
+#include "set_file.h"
+
+// Filter set (.rtfs): one binary fuse filter per table over its end
+// column, built offline by rtfilter and kept resident at lookup time.
+// A lookup probes the filter of each table with every end index and
+// only reads the table where the filter says yes: the fence array (the
+// end of every TABLE_FILTER_FENCE-th chain) narrows a filter hit down to
+// one small region, which is read with a single pread and searched to
+// confirm the match and fetch the start index. Nearly all probes miss,
+// so a table is proven not to hold them without being read at all.
+//
+// File layout (set_file.h), per table: fence array, then fingerprints.
+
+#define TABLE_FILTER_MAGIC "RTFS"
+#define TABLE_FILTER_FENCE 256         // chains per region: 4 KB of an .rt table
+
+typedef struct {
+    set_file_table table;              // which table, and its end range
+    uint64_t num_keys;                 // distinct ends
+    uint64_t fence_offset;             // file offsets of the two arrays
+    uint64_t filter_offset;
+    uint64_t num_fences;
+    fuse_params fuse;
+} table_filter_entry;
+
+typedef struct {
+    const set_file_header *header;
+    const table_filter_entry *entries;
+    const uint8_t *data;
+    size_t size;
+} table_filter_set;
+
+typedef struct {
+    uint64_t probes;
+    uint64_t filter_hits;
+    uint64_t reads;                    // regions read to confirm hits
+    uint64_t read_bytes;
+    uint64_t confirmed;
+} table_filter_stats;
+
+// Writes a filter set over the given .rt / .rte tables. fp_bits (8 or
+// 16) trades size for the false positive rate. Returns 0 on success.
+int table_filter_build(const char *out_path, char **table_paths, int num_tables,
+                       uint32_t fp_bits);
+
+// Loads a filter set into memory (mapped and faulted in where supported)
+int table_filter_open(table_filter_set *fs, const char *path);
+void table_filter_close(table_filter_set *fs);
+
+// Entry for a table file, matched by file name and checked against its
+// size; NULL if the set has no (current) filter for it.
+const table_filter_entry *table_filter_find(const table_filter_set *fs, const char *table_path);
+
+// Probes the sorted queries against one table's filter and confirms the
+// hits from the table file. Appends matches like table_join_search;
+// returns the number found or -1 if the table cannot be read.
+int table_filter_search(const table_filter_set *fs, const table_filter_entry *e,
+                        const char *table_path, const rt_query *queries, uint32_t num_queries,
+                        uint64_t *start_indices, uint32_t *positions,
+                        uint32_t *num_candidates, uint32_t max_candidates,
+                        table_filter_stats *stats);
+
+#endif
\ No newline at end of file
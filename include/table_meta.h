@@ -0,0 +1,54 @@
+#ifndef TABLE_META_H
+#define TABLE_META_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Table metadata sidecar (.rtm, built by rtconvert and kept next to the
+// table): chain count, end range, sortedness, a fence array holding the
+// first end of every 4 KB page of the table file and a checksum of the
+// sidecar itself.
+// table_open_paged reads only this; a search then finds the page(s) that
+// can hold an end from the fences and reads just those with pread, and a
+// query set whose end range misses the table's skips it unread.
+//
+// File layout:
+//   table_meta_header
+//   uint64_t fences[num_fences]
+
+#define TABLE_META_MAGIC "RTMD"
+#define TABLE_META_PAGE 4096
+#define TABLE_META_SORTED 1        // flags: ends are non-decreasing
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t file_size;            // table file (the .rte for split tables)
+    uint64_t num_chains;
+    uint64_t first_end;
+    uint64_t last_end;
+    uint64_t checksum;             // table_meta_checksum of the sidecar, taken with this 0
+    uint32_t flags;
+    uint32_t record_size;          // bytes per chain: 16 (.rt) or 8 (.rte)
+    uint32_t chains_per_page;
+    uint32_t reserved;
+    uint64_t num_fences;
+} table_meta_header;
+
+// 64-bit FNV-1a over 8-byte words (and any tail bytes)
+uint64_t table_meta_checksum(const void *data, size_t size);
+
+// Writes the sidecar for a loaded table file of size bytes with n chains;
+// ends/stride as in rt_table. out must be seekable (the header is written
+// again once the checksum is known). Sets *flags to the header's flags;
+// returns the sidecar size or -1.
+int64_t table_meta_write(FILE *out, size_t size, const uint64_t *ends, uint32_t stride,
+                         uint64_t n, uint32_t *flags);
+
+// Validates a sidecar against its own size and checksum. Returns 0 on
+// success.
+int table_meta_open(const void *data, size_t size, const table_meta_header **header,
+                    const uint64_t **fences);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Minimal io_uring wrapper (raw syscalls, no liburing) for table reads.
+// Only built on Linux; uring_init fails elsewhere.
+
+#ifdef __linux__
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+typedef struct {
+    int fd;
+    unsigned entries;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    struct io_uring_sqe *sqes;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+    void *sq_ring, *cq_ring;
+    size_t sq_ring_len, cq_ring_len, sqes_len;
+    unsigned pending;          // prepared but not yet submitted
+} uring;
+#else
+typedef struct {
+    int fd;
+} uring;
+struct iovec;
+#endif
+
+int uring_init(uring *r, unsigned entries);
+void uring_exit(uring *r);
+
+// Registers fixed buffers for uring_prep_read with buf_index >= 0
+int uring_register_buffers(uring *r, const struct iovec *iov, unsigned count);
+
+// Queues a read; buf_index < 0 reads into an unregistered buffer
+int uring_prep_read(uring *r, int fd, void *buf, unsigned len, uint64_t offset,
+                    int buf_index, uint64_t user_data);
+
+// Submits queued reads and waits for at least wait_nr completions
+int uring_submit(uring *r, unsigned wait_nr);
+
+// Pops one completion; returns 0 if none are available
+int uring_reap(uring *r, uint64_t *user_data, int *res);
+
+#endif
\ No newline at end of file
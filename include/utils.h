@@ -16,6 +16,8 @@ void bytes_to_hex(const uint8_t *bytes, size_t len, char *hex, size_t hex_size);
 
 // Utility
 uint64_t get_plaintext_space(void);
+double get_time_sec(void);
+int cpu_count(void);
 void get_table_id(const char *table_path, char *table_id, size_t size);
 
 // Endpoints
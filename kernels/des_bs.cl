@@ -0,0 +1,1202 @@
+// Bitsliced DES for the NetNTLMv1 kernels, built ahead of precompute.cl
+// and false_alarm.cl for their _bs variants. Bit i of 32 chains' index
+// lives in one uint (one chain per lane), and DES runs as a fixed sequence
+// of logic gates over all 32 at once, as in the CPU engine (des_bs.c):
+// the key is the index itself, so the key schedule is only a choice of
+// which slices feed each S-box input; the challenge is fixed, so its
+// initial permutation is a set of constant slices; and the reduction is a
+// ripple-carry add of each chain's position counter. No table lookups, so
+// nothing serializes on __constant memory.
+//
+// The S-box circuits are the ones des_bs_engine.h uses; des_bench checks
+// those against the table-driven DES. Each call xors its outputs straight
+// into the P permuted slices of the left half.
+
+#define DES_BS_LANES 32
+#define DES_BS_COUNTER_BITS 33      // reduction_offset + pos < 2^33
+
+// Challenge after IP, slice i = bit i. The host passes its challenge as
+// -D options; the defaults are 1122334455667788, as in des_bs.c.
+#ifndef DES_BS_L0
+#define DES_BS_L0 0xaa1eaa1eU
+#define DES_BS_R0 0x66016601U
+#endif
+
+// S1: 108 gates
+inline void des_bs_s1(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = ~a5;
+    uint x1 = x0 ^ a2;
+    uint x2 = x1 ^ a5;
+    uint x3 = x2 & a3;
+    uint x4 = x1 ^ x3;
+    uint x5 = a5 & a3;
+    uint x6 = x1 ^ x5;
+    uint x7 = x4 ^ x6;
+    uint x8 = x7 & a4;
+    uint x9 = x4 ^ x8;
+    uint x10 = ~x4;
+    uint x11 = x0 & a3;
+    uint x12 = a2 ^ x11;
+    uint x13 = x10 ^ x12;
+    uint x14 = x13 & a4;
+    uint x15 = x10 ^ x14;
+    uint x16 = x9 ^ x15;
+    uint x17 = x16 & a6;
+    uint x18 = x9 ^ x17;
+    uint x19 = ~(a2 & ~x0);
+    uint x20 = x19 ^ x11;
+    uint x21 = x12 ^ x20;
+    uint x22 = x21 & a4;
+    uint x23 = x12 ^ x22;
+    uint x24 = ~x1;
+    uint x25 = x21 ^ x24;
+    uint x26 = x25 & a3;
+    uint x27 = x21 ^ x26;
+    uint x28 = ~x19;
+    uint x29 = x1 ^ x28;
+    uint x30 = x29 & a3;
+    uint x31 = x1 ^ x30;
+    uint x32 = x27 ^ x31;
+    uint x33 = x32 & a4;
+    uint x34 = x27 ^ x33;
+    uint x35 = x23 ^ x34;
+    uint x36 = x35 & a6;
+    uint x37 = x23 ^ x36;
+    uint x38 = x18 ^ x37;
+    uint x39 = x38 & a1;
+    uint x40 = x18 ^ x39;
+    uint x41 = ~x12;
+    uint x42 = x25 ^ x11;
+    uint x43 = x41 ^ x42;
+    uint x44 = x43 & a4;
+    uint x45 = x41 ^ x44;
+    uint x46 = a5 ^ x3;
+    uint x47 = x24 & a3;
+    uint x48 = x19 ^ x47;
+    uint x49 = x42 & a4;
+    uint x50 = x46 ^ x49;
+    uint x51 = x45 ^ x50;
+    uint x52 = x51 & a6;
+    uint x53 = x45 ^ x52;
+    uint x54 = x43 & a3;
+    uint x55 = x25 ^ x54;
+    uint x56 = ~x21;
+    uint x57 = x1 ^ x26;
+    uint x58 = x55 ^ x57;
+    uint x59 = x58 & a4;
+    uint x60 = x55 ^ x59;
+    uint x61 = x48 ^ a4;
+    uint x62 = x60 ^ x61;
+    uint x63 = x62 & a6;
+    uint x64 = x60 ^ x63;
+    uint x65 = x53 ^ x64;
+    uint x66 = x65 & a1;
+    uint x67 = x53 ^ x66;
+    uint x68 = x4 & a4;
+    uint x69 = x55 ^ x68;
+    uint x70 = x43 ^ x26;
+    uint x71 = x19 & a4;
+    uint x72 = x70 ^ x71;
+    uint x73 = x69 ^ x72;
+    uint x74 = x73 & a6;
+    uint x75 = x69 ^ x74;
+    uint x76 = x56 ^ x5;
+    uint x77 = x25 & a4;
+    uint x78 = x76 ^ x77;
+    uint x79 = x20 & a4;
+    uint x80 = x57 ^ x79;
+    uint x81 = x78 ^ x80;
+    uint x82 = x81 & a6;
+    uint x83 = x78 ^ x82;
+    uint x84 = x75 ^ x83;
+    uint x85 = x84 & a1;
+    uint x86 = x75 ^ x85;
+    uint x87 = x2 ^ x5;
+    uint x88 = x76 ^ x71;
+    uint x89 = ~x55;
+    uint x90 = x89 ^ x22;
+    uint x91 = x88 ^ x90;
+    uint x92 = x91 & a6;
+    uint x93 = x88 ^ x92;
+    uint x94 = ~x87;
+    uint x95 = x10 ^ x94;
+    uint x96 = x95 & a4;
+    uint x97 = x10 ^ x96;
+    uint x98 = x25 ^ a3;
+    uint x99 = x1 & a4;
+    uint x100 = x98 ^ x99;
+    uint x101 = x97 ^ x100;
+    uint x102 = x101 & a6;
+    uint x103 = x97 ^ x102;
+    uint x104 = x93 ^ x103;
+    uint x105 = x104 & a1;
+    uint x106 = x93 ^ x105;
+    l[8] ^= x40;
+    l[16] ^= x67;
+    l[22] ^= x86;
+    l[30] ^= x106;
+}
+
+// S2: 96 gates
+inline void des_bs_s2(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = ~a4;
+    uint x1 = x0 ^ a3;
+    uint x2 = a4 ^ a2;
+    uint x3 = x1 ^ x2;
+    uint x4 = x3 & a1;
+    uint x5 = x1 ^ x4;
+    uint x6 = ~x2;
+    uint x7 = x0 | a2;
+    uint x8 = x0 & ~a2;
+    uint x9 = a2 & a3;
+    uint x10 = x7 ^ x9;
+    uint x11 = x6 ^ x10;
+    uint x12 = x11 & a1;
+    uint x13 = x6 ^ x12;
+    uint x14 = x5 ^ x13;
+    uint x15 = x14 & a6;
+    uint x16 = x5 ^ x15;
+    uint x17 = x10 ^ a1;
+    uint x18 = x8 & a1;
+    uint x19 = x3 ^ x18;
+    uint x20 = x17 ^ x19;
+    uint x21 = x20 & a6;
+    uint x22 = x17 ^ x21;
+    uint x23 = x16 ^ x22;
+    uint x24 = x23 & a5;
+    uint x25 = x16 ^ x24;
+    uint x26 = ~a3;
+    uint x27 = x26 ^ x0;
+    uint x28 = x27 & a2;
+    uint x29 = x26 ^ x28;
+    uint x30 = x0 & a2;
+    uint x31 = a3 ^ x30;
+    uint x32 = x29 ^ x31;
+    uint x33 = x32 & a6;
+    uint x34 = x29 ^ x33;
+    uint x35 = x1 ^ a2;
+    uint x36 = x7 & a5;
+    uint x37 = x34 ^ x36;
+    uint x38 = a4 & a2;
+    uint x39 = a3 ^ x38;
+    uint x40 = x39 ^ a6;
+    uint x41 = ~x39;
+    uint x42 = x41 ^ x6;
+    uint x43 = x42 & a6;
+    uint x44 = x41 ^ x43;
+    uint x45 = x40 ^ x44;
+    uint x46 = x45 & a5;
+    uint x47 = x40 ^ x46;
+    uint x48 = x37 ^ x47;
+    uint x49 = x48 & a1;
+    uint x50 = x37 ^ x49;
+    uint x51 = x0 ^ x11;
+    uint x52 = x51 ^ a1;
+    uint x53 = x26 & a2;
+    uint x54 = x41 & a6;
+    uint x55 = x52 ^ x54;
+    uint x56 = ~x51;
+    uint x57 = x56 ^ x6;
+    uint x58 = x57 & a1;
+    uint x59 = x56 ^ x58;
+    uint x60 = x26 | a4;
+    uint x61 = x60 ^ x53;
+    uint x62 = x61 ^ a1;
+    uint x63 = x59 ^ x62;
+    uint x64 = x63 & a6;
+    uint x65 = x59 ^ x64;
+    uint x66 = x55 ^ x65;
+    uint x67 = x66 & a5;
+    uint x68 = x55 ^ x67;
+    uint x69 = x0 | a3;
+    uint x70 = x69 ^ a2;
+    uint x71 = x70 ^ x51;
+    uint x72 = x71 & a6;
+    uint x73 = x70 ^ x72;
+    uint x74 = ~x35;
+    uint x75 = a4 | a3;
+    uint x76 = x75 ^ x9;
+    uint x77 = x74 ^ x76;
+    uint x78 = x77 & a6;
+    uint x79 = x74 ^ x78;
+    uint x80 = x73 ^ x79;
+    uint x81 = x80 & a5;
+    uint x82 = x73 ^ x81;
+    uint x83 = x75 & a2;
+    uint x84 = x27 ^ x83;
+    uint x85 = x69 & a2;
+    uint x86 = x53 & a6;
+    uint x87 = x84 ^ x86;
+    uint x88 = x26 ^ x85;
+    uint x89 = x88 ^ a6;
+    uint x90 = x87 ^ x89;
+    uint x91 = x90 & a5;
+    uint x92 = x87 ^ x91;
+    uint x93 = x82 ^ x92;
+    uint x94 = x93 & a1;
+    uint x95 = x82 ^ x94;
+    l[12] ^= x50;
+    l[27] ^= x68;
+    l[1] ^= x95;
+    l[17] ^= x25;
+}
+
+// S3: 94 gates
+inline void des_bs_s3(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = ~a5;
+    uint x1 = x0 ^ a2;
+    uint x2 = x0 | a6;
+    uint x3 = x2 & a2;
+    uint x4 = x1 ^ x3;
+    uint x5 = x4 & a3;
+    uint x6 = x1 ^ x5;
+    uint x7 = ~(a6 & ~a5);
+    uint x8 = x0 ^ a6;
+    uint x9 = x7 ^ x8;
+    uint x10 = x9 & a2;
+    uint x11 = x7 ^ x10;
+    uint x12 = x8 ^ a2;
+    uint x13 = x11 ^ x12;
+    uint x14 = x13 & a3;
+    uint x15 = x11 ^ x14;
+    uint x16 = x6 ^ x15;
+    uint x17 = x16 & a4;
+    uint x18 = x6 ^ x17;
+    uint x19 = ~x8;
+    uint x20 = x8 ^ x14;
+    uint x21 = x20 ^ a4;
+    uint x22 = x18 ^ x21;
+    uint x23 = x22 & a1;
+    uint x24 = x18 ^ x23;
+    uint x25 = x0 & a4;
+    uint x26 = a6 ^ x25;
+    uint x27 = ~a6;
+    uint x28 = a5 & a3;
+    uint x29 = x26 ^ x28;
+    uint x30 = x29 ^ a2;
+    uint x31 = x27 & a4;
+    uint x32 = x0 ^ x31;
+    uint x33 = x32 ^ a3;
+    uint x34 = a6 & a5;
+    uint x35 = x7 ^ x31;
+    uint x36 = x2 ^ a4;
+    uint x37 = x35 ^ x36;
+    uint x38 = x37 & a3;
+    uint x39 = x35 ^ x38;
+    uint x40 = x33 ^ x39;
+    uint x41 = x40 & a2;
+    uint x42 = x33 ^ x41;
+    uint x43 = x30 ^ x42;
+    uint x44 = x43 & a1;
+    uint x45 = x30 ^ x44;
+    uint x46 = a6 ^ x9;
+    uint x47 = x46 & a2;
+    uint x48 = a6 ^ x47;
+    uint x49 = x48 ^ x13;
+    uint x50 = x49 & a4;
+    uint x51 = x48 ^ x50;
+    uint x52 = x27 ^ a2;
+    uint x53 = x27 & a2;
+    uint x54 = x0 ^ x53;
+    uint x55 = x52 ^ x54;
+    uint x56 = x55 & a4;
+    uint x57 = x52 ^ x56;
+    uint x58 = x51 ^ x57;
+    uint x59 = x58 & a1;
+    uint x60 = x51 ^ x59;
+    uint x61 = ~x34;
+    uint x62 = x61 ^ x53;
+    uint x63 = x12 ^ x62;
+    uint x64 = x63 & a4;
+    uint x65 = x12 ^ x64;
+    uint x66 = x65 ^ a1;
+    uint x67 = x60 ^ x66;
+    uint x68 = x67 & a3;
+    uint x69 = x60 ^ x68;
+    uint x70 = x8 ^ x3;
+    uint x71 = x49 & a3;
+    uint x72 = x70 ^ x71;
+    uint x73 = x34 & a2;
+    uint x74 = x9 ^ x73;
+    uint x75 = x74 ^ a3;
+    uint x76 = x72 ^ x75;
+    uint x77 = x76 & a4;
+    uint x78 = x72 ^ x77;
+    uint x79 = ~x54;
+    uint x80 = x79 ^ x19;
+    uint x81 = x80 & a3;
+    uint x82 = x79 ^ x81;
+    uint x83 = x8 ^ x47;
+    uint x84 = x3 ^ x83;
+    uint x85 = x84 & a3;
+    uint x86 = x3 ^ x85;
+    uint x87 = x82 ^ x86;
+    uint x88 = x87 & a4;
+    uint x89 = x82 ^ x88;
+    uint x90 = x78 ^ x89;
+    uint x91 = x90 & a1;
+    uint x92 = x78 ^ x91;
+    l[23] ^= x24;
+    l[15] ^= x69;
+    l[29] ^= x92;
+    l[5] ^= x45;
+}
+
+// S4: 72 gates
+inline void des_bs_s4(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = ~a4;
+    uint x1 = x0 ^ a3;
+    uint x2 = a4 ^ x1;
+    uint x3 = x2 & a5;
+    uint x4 = a4 ^ x3;
+    uint x5 = ~x1;
+    uint x6 = a4 & a5;
+    uint x7 = x5 ^ x6;
+    uint x8 = x4 ^ x7;
+    uint x9 = x8 & a2;
+    uint x10 = x4 ^ x9;
+    uint x11 = ~(a3 & ~x0);
+    uint x12 = x11 ^ a3;
+    uint x13 = x12 & a5;
+    uint x14 = x11 ^ x13;
+    uint x15 = x1 ^ x13;
+    uint x16 = x14 ^ x15;
+    uint x17 = x16 & a2;
+    uint x18 = x14 ^ x17;
+    uint x19 = x10 ^ x18;
+    uint x20 = x19 & a1;
+    uint x21 = x10 ^ x20;
+    uint x22 = x5 & a5;
+    uint x23 = x2 ^ x22;
+    uint x24 = x12 & a2;
+    uint x25 = x23 ^ x24;
+    uint x26 = x0 & a5;
+    uint x27 = a3 ^ x26;
+    uint x28 = x0 ^ a5;
+    uint x29 = x27 ^ x28;
+    uint x30 = x29 & a2;
+    uint x31 = x27 ^ x30;
+    uint x32 = x25 ^ x31;
+    uint x33 = x32 & a1;
+    uint x34 = x25 ^ x33;
+    uint x35 = x21 ^ x34;
+    uint x36 = x35 & a6;
+    uint x37 = x21 ^ x36;
+    uint x38 = ~x21;
+    uint x39 = x34 ^ x38;
+    uint x40 = x39 & a6;
+    uint x41 = x34 ^ x40;
+    uint x42 = x2 ^ x16;
+    uint x43 = x42 & a5;
+    uint x44 = x2 ^ x43;
+    uint x45 = x11 & a2;
+    uint x46 = x44 ^ x45;
+    uint x47 = a3 & a5;
+    uint x48 = x1 ^ x47;
+    uint x49 = ~x27;
+    uint x50 = x48 ^ x49;
+    uint x51 = x50 & a2;
+    uint x52 = x48 ^ x51;
+    uint x53 = x46 ^ x52;
+    uint x54 = x53 & a1;
+    uint x55 = x46 ^ x54;
+    uint x56 = x27 & a2;
+    uint x57 = x7 ^ x56;
+    uint x58 = x0 ^ x22;
+    uint x59 = x42 & a2;
+    uint x60 = x58 ^ x59;
+    uint x61 = x57 ^ x60;
+    uint x62 = x61 & a1;
+    uint x63 = x57 ^ x62;
+    uint x64 = x55 ^ x63;
+    uint x65 = x64 & a6;
+    uint x66 = x55 ^ x65;
+    uint x67 = ~x63;
+    uint x68 = x67 ^ x55;
+    uint x69 = x68 & a6;
+    uint x70 = x67 ^ x69;
+    l[25] ^= x37;
+    l[19] ^= x41;
+    l[9] ^= x66;
+    l[0] ^= x70;
+}
+
+// S5: 110 gates
+inline void des_bs_s5(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = a5 ^ a2;
+    uint x1 = a5 & a1;
+    uint x2 = x0 ^ x1;
+    uint x3 = ~a2;
+    uint x4 = x0 ^ x3;
+    uint x5 = x4 & a1;
+    uint x6 = x0 ^ x5;
+    uint x7 = a1 & a3;
+    uint x8 = x2 ^ x7;
+    uint x9 = ~(a2 & ~a5);
+    uint x10 = x3 ^ x9;
+    uint x11 = x10 & a1;
+    uint x12 = x3 ^ x11;
+    uint x13 = x10 ^ x0;
+    uint x14 = x13 & a1;
+    uint x15 = x10 ^ x14;
+    uint x16 = x12 ^ x15;
+    uint x17 = x16 & a3;
+    uint x18 = x12 ^ x17;
+    uint x19 = x8 ^ x18;
+    uint x20 = x19 & a6;
+    uint x21 = x8 ^ x20;
+    uint x22 = x4 | a2;
+    uint x23 = x22 ^ a5;
+    uint x24 = x23 & a1;
+    uint x25 = x22 ^ x24;
+    uint x26 = x15 ^ x25;
+    uint x27 = x26 & a3;
+    uint x28 = x15 ^ x27;
+    uint x29 = ~x0;
+    uint x30 = x13 ^ x24;
+    uint x31 = x9 & a3;
+    uint x32 = x30 ^ x31;
+    uint x33 = x28 ^ x32;
+    uint x34 = x33 & a6;
+    uint x35 = x28 ^ x34;
+    uint x36 = x21 ^ x35;
+    uint x37 = x36 & a4;
+    uint x38 = x21 ^ x37;
+    uint x39 = a5 ^ a1;
+    uint x40 = x3 & a1;
+    uint x41 = x4 ^ x40;
+    uint x42 = x39 ^ x41;
+    uint x43 = x42 & a3;
+    uint x44 = x39 ^ x43;
+    uint x45 = x0 & a3;
+    uint x46 = x26 ^ x45;
+    uint x47 = x44 ^ x46;
+    uint x48 = x47 & a6;
+    uint x49 = x44 ^ x48;
+    uint x50 = ~x6;
+    uint x51 = x0 ^ a1;
+    uint x52 = x50 ^ x51;
+    uint x53 = x52 & a3;
+    uint x54 = x50 ^ x53;
+    uint x55 = x54 ^ a6;
+    uint x56 = x49 ^ x55;
+    uint x57 = x56 & a4;
+    uint x58 = x49 ^ x57;
+    uint x59 = ~x30;
+    uint x60 = x3 ^ x14;
+    uint x61 = x59 ^ x60;
+    uint x62 = x61 & a3;
+    uint x63 = x59 ^ x62;
+    uint x64 = x60 ^ x0;
+    uint x65 = x64 & a3;
+    uint x66 = x60 ^ x65;
+    uint x67 = x63 ^ x66;
+    uint x68 = x67 & a6;
+    uint x69 = x63 ^ x68;
+    uint x70 = ~x60;
+    uint x71 = x70 ^ x31;
+    uint x72 = x22 ^ a1;
+    uint x73 = x72 ^ x65;
+    uint x74 = x71 ^ x73;
+    uint x75 = x74 & a6;
+    uint x76 = x71 ^ x75;
+    uint x77 = x69 ^ x76;
+    uint x78 = x77 & a4;
+    uint x79 = x69 ^ x78;
+    uint x80 = x10 ^ a2;
+    uint x81 = x80 & a1;
+    uint x82 = x10 ^ x81;
+    uint x83 = ~x39;
+    uint x84 = x82 ^ x83;
+    uint x85 = x84 & a3;
+    uint x86 = x82 ^ x85;
+    uint x87 = x10 & a3;
+    uint x88 = x51 ^ x87;
+    uint x89 = x86 ^ x88;
+    uint x90 = x89 & a6;
+    uint x91 = x86 ^ x90;
+    uint x92 = x13 ^ x5;
+    uint x93 = x29 ^ x11;
+    uint x94 = x92 ^ x93;
+    uint x95 = x94 & a3;
+    uint x96 = x92 ^ x95;
+    uint x97 = x80 ^ x14;
+    uint x98 = x22 & a1;
+    uint x99 = x3 ^ x98;
+    uint x100 = x97 ^ x99;
+    uint x101 = x100 & a3;
+    uint x102 = x97 ^ x101;
+    uint x103 = x96 ^ x102;
+    uint x104 = x103 & a6;
+    uint x105 = x96 ^ x104;
+    uint x106 = x91 ^ x105;
+    uint x107 = x106 & a4;
+    uint x108 = x91 ^ x107;
+    l[7] ^= x38;
+    l[13] ^= x58;
+    l[24] ^= x79;
+    l[2] ^= x108;
+}
+
+// S6: 97 gates
+inline void des_bs_s6(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = ~a5;
+    uint x1 = x0 ^ a2;
+    uint x2 = x1 ^ a6;
+    uint x3 = x0 & a3;
+    uint x4 = x2 ^ x3;
+    uint x5 = x0 | a2;
+    uint x6 = a5 ^ x5;
+    uint x7 = x6 & a6;
+    uint x8 = a5 ^ x7;
+    uint x9 = x8 ^ a3;
+    uint x10 = x4 ^ x9;
+    uint x11 = x10 & a4;
+    uint x12 = x4 ^ x11;
+    uint x13 = ~x2;
+    uint x14 = ~x6;
+    uint x15 = ~x1;
+    uint x16 = x14 ^ x15;
+    uint x17 = x16 & a6;
+    uint x18 = x14 ^ x17;
+    uint x19 = x13 ^ x18;
+    uint x20 = x19 & a3;
+    uint x21 = x13 ^ x20;
+    uint x22 = x5 & a6;
+    uint x23 = x6 ^ x22;
+    uint x24 = x23 ^ x1;
+    uint x25 = x24 & a3;
+    uint x26 = x23 ^ x25;
+    uint x27 = x21 ^ x26;
+    uint x28 = x27 & a4;
+    uint x29 = x21 ^ x28;
+    uint x30 = x12 ^ x29;
+    uint x31 = x30 & a1;
+    uint x32 = x12 ^ x31;
+    uint x33 = a2 & a3;
+    uint x34 = x1 ^ x33;
+    uint x35 = ~a2;
+    uint x36 = x1 & a3;
+    uint x37 = x35 ^ x36;
+    uint x38 = x34 ^ x37;
+    uint x39 = x38 & a4;
+    uint x40 = x34 ^ x39;
+    uint x41 = x38 & a1;
+    uint x42 = x40 ^ x41;
+    uint x43 = a2 ^ x3;
+    uint x44 = x37 ^ x43;
+    uint x45 = x44 & a4;
+    uint x46 = x37 ^ x45;
+    uint x47 = x5 & a3;
+    uint x48 = a2 ^ x47;
+    uint x49 = x16 & a4;
+    uint x50 = x48 ^ x49;
+    uint x51 = x46 ^ x50;
+    uint x52 = x51 & a1;
+    uint x53 = x46 ^ x52;
+    uint x54 = x42 ^ x53;
+    uint x55 = x54 & a6;
+    uint x56 = x42 ^ x55;
+    uint x57 = x7 ^ x23;
+    uint x58 = x57 & a4;
+    uint x59 = x7 ^ x58;
+    uint x60 = x0 & a2;
+    uint x61 = x16 & a3;
+    uint x62 = x59 ^ x61;
+    uint x63 = x14 & a6;
+    uint x64 = x15 ^ x63;
+    uint x65 = x64 ^ x1;
+    uint x66 = x65 & a4;
+    uint x67 = x64 ^ x66;
+    uint x68 = x23 & a3;
+    uint x69 = x67 ^ x68;
+    uint x70 = x62 ^ x69;
+    uint x71 = x70 & a1;
+    uint x72 = x62 ^ x71;
+    uint x73 = x35 & a3;
+    uint x74 = a5 ^ x73;
+    uint x75 = a5 & a3;
+    uint x76 = x15 ^ x75;
+    uint x77 = x60 ^ x73;
+    uint x78 = x76 ^ x77;
+    uint x79 = x78 & a6;
+    uint x80 = x76 ^ x79;
+    uint x81 = x74 ^ x80;
+    uint x82 = x81 & a4;
+    uint x83 = x74 ^ x82;
+    uint x84 = x0 ^ x36;
+    uint x85 = x15 ^ x3;
+    uint x86 = x84 ^ x85;
+    uint x87 = x86 & a6;
+    uint x88 = x84 ^ x87;
+    uint x89 = ~x43;
+    uint x90 = x89 ^ a6;
+    uint x91 = x88 ^ x90;
+    uint x92 = x91 & a4;
+    uint x93 = x88 ^ x92;
+    uint x94 = x83 ^ x93;
+    uint x95 = x94 & a1;
+    uint x96 = x83 ^ x95;
+    l[3] ^= x56;
+    l[28] ^= x32;
+    l[10] ^= x72;
+    l[18] ^= x96;
+}
+
+// S7: 99 gates
+inline void des_bs_s7(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = a2 ^ a5;
+    uint x1 = a2 & a4;
+    uint x2 = a5 ^ x1;
+    uint x3 = ~x0;
+    uint x4 = ~a2;
+    uint x5 = a5 & a4;
+    uint x6 = x3 ^ x5;
+    uint x7 = x2 ^ x6;
+    uint x8 = x7 & a3;
+    uint x9 = x2 ^ x8;
+    uint x10 = x4 | a5;
+    uint x11 = a2 ^ x10;
+    uint x12 = x11 & a4;
+    uint x13 = a2 ^ x12;
+    uint x14 = x4 & ~a5;
+    uint x15 = x14 ^ x12;
+    uint x16 = x13 ^ x15;
+    uint x17 = x16 & a3;
+    uint x18 = x13 ^ x17;
+    uint x19 = x9 ^ x18;
+    uint x20 = x19 & a1;
+    uint x21 = x9 ^ x20;
+    uint x22 = ~x2;
+    uint x23 = x22 ^ a3;
+    uint x24 = x16 & a4;
+    uint x25 = x0 ^ x24;
+    uint x26 = ~x10;
+    uint x27 = x26 ^ x24;
+    uint x28 = x25 ^ x27;
+    uint x29 = x28 & a3;
+    uint x30 = x25 ^ x29;
+    uint x31 = x23 ^ x30;
+    uint x32 = x31 & a1;
+    uint x33 = x23 ^ x32;
+    uint x34 = x21 ^ x33;
+    uint x35 = x34 & a6;
+    uint x36 = x21 ^ x35;
+    uint x37 = x4 & a4;
+    uint x38 = x3 ^ x37;
+    uint x39 = ~a5;
+    uint x40 = a2 & a3;
+    uint x41 = x38 ^ x40;
+    uint x42 = x41 ^ x9;
+    uint x43 = x42 & a1;
+    uint x44 = x41 ^ x43;
+    uint x45 = ~x14;
+    uint x46 = x10 & a4;
+    uint x47 = x39 ^ x46;
+    uint x48 = x14 & a4;
+    uint x49 = x3 ^ x48;
+    uint x50 = x47 ^ x49;
+    uint x51 = x50 & a3;
+    uint x52 = x47 ^ x51;
+    uint x53 = x0 ^ x1;
+    uint x54 = x3 ^ x53;
+    uint x55 = x54 & a3;
+    uint x56 = x3 ^ x55;
+    uint x57 = x52 ^ x56;
+    uint x58 = x57 & a1;
+    uint x59 = x52 ^ x58;
+    uint x60 = x44 ^ x59;
+    uint x61 = x60 & a6;
+    uint x62 = x44 ^ x61;
+    uint x63 = x25 ^ a3;
+    uint x64 = x3 & a4;
+    uint x65 = a2 ^ x64;
+    uint x66 = x45 & a3;
+    uint x67 = x65 ^ x66;
+    uint x68 = x63 ^ x67;
+    uint x69 = x68 & a1;
+    uint x70 = x63 ^ x69;
+    uint x71 = a2 ^ a4;
+    uint x72 = x64 & a3;
+    uint x73 = x71 ^ x72;
+    uint x74 = x4 ^ x46;
+    uint x75 = x74 ^ a3;
+    uint x76 = x73 ^ x75;
+    uint x77 = x76 & a1;
+    uint x78 = x73 ^ x77;
+    uint x79 = x70 ^ x78;
+    uint x80 = x79 & a6;
+    uint x81 = x70 ^ x80;
+    uint x82 = ~x6;
+    uint x83 = x39 ^ a4;
+    uint x84 = x82 ^ x83;
+    uint x85 = x84 & a3;
+    uint x86 = x82 ^ x85;
+    uint x87 = x86 ^ a1;
+    uint x88 = x45 & a4;
+    uint x89 = x3 ^ x88;
+    uint x90 = x89 ^ x85;
+    uint x91 = ~x15;
+    uint x92 = x91 ^ a3;
+    uint x93 = x90 ^ x92;
+    uint x94 = x93 & a1;
+    uint x95 = x90 ^ x94;
+    uint x96 = x87 ^ x95;
+    uint x97 = x96 & a6;
+    uint x98 = x87 ^ x97;
+    l[31] ^= x36;
+    l[11] ^= x62;
+    l[21] ^= x81;
+    l[6] ^= x98;
+}
+
+// S8: 93 gates
+inline void des_bs_s8(uint *l, uint a1, uint a2, uint a3, uint a4, uint a5, uint a6) {
+    uint x0 = ~a5;
+    uint x1 = x0 | a2;
+    uint x2 = x0 ^ a2;
+    uint x3 = x1 ^ x2;
+    uint x4 = x3 & a4;
+    uint x5 = x1 ^ x4;
+    uint x6 = ~x1;
+    uint x7 = x6 ^ x0;
+    uint x8 = x7 & a4;
+    uint x9 = x6 ^ x8;
+    uint x10 = x5 ^ x9;
+    uint x11 = x10 & a3;
+    uint x12 = x5 ^ x11;
+    uint x13 = x6 ^ a2;
+    uint x14 = x13 & a4;
+    uint x15 = x6 ^ x14;
+    uint x16 = x0 & a3;
+    uint x17 = x15 ^ x16;
+    uint x18 = x12 ^ x17;
+    uint x19 = x18 & a1;
+    uint x20 = x12 ^ x19;
+    uint x21 = ~x2;
+    uint x22 = ~x3;
+    uint x23 = x1 & a4;
+    uint x24 = x21 ^ x23;
+    uint x25 = x24 ^ a3;
+    uint x26 = x2 & a4;
+    uint x27 = a2 ^ x26;
+    uint x28 = x13 & a3;
+    uint x29 = x27 ^ x28;
+    uint x30 = x25 ^ x29;
+    uint x31 = x30 & a1;
+    uint x32 = x25 ^ x31;
+    uint x33 = x20 ^ x32;
+    uint x34 = x33 & a6;
+    uint x35 = x20 ^ x34;
+    uint x36 = ~x13;
+    uint x37 = x22 & a4;
+    uint x38 = x36 ^ x37;
+    uint x39 = x21 & a3;
+    uint x40 = x38 ^ x39;
+    uint x41 = x2 ^ x11;
+    uint x42 = x40 ^ x41;
+    uint x43 = x42 & a1;
+    uint x44 = x40 ^ x43;
+    uint x45 = ~x40;
+    uint x46 = a2 ^ a4;
+    uint x47 = x46 ^ x16;
+    uint x48 = x45 ^ x47;
+    uint x49 = x48 & a1;
+    uint x50 = x45 ^ x49;
+    uint x51 = x44 ^ x50;
+    uint x52 = x51 & a6;
+    uint x53 = x44 ^ x52;
+    uint x54 = a5 & a4;
+    uint x55 = x21 ^ x54;
+    uint x56 = x55 ^ x16;
+    uint x57 = x22 ^ a4;
+    uint x58 = x7 & a3;
+    uint x59 = x57 ^ x58;
+    uint x60 = x56 ^ x59;
+    uint x61 = x60 & a1;
+    uint x62 = x56 ^ x61;
+    uint x63 = x6 & a4;
+    uint x64 = x22 ^ x63;
+    uint x65 = x15 ^ x64;
+    uint x66 = x65 & a3;
+    uint x67 = x15 ^ x66;
+    uint x68 = x21 & a4;
+    uint x69 = x0 ^ x68;
+    uint x70 = x69 ^ x55;
+    uint x71 = x70 & a3;
+    uint x72 = x69 ^ x71;
+    uint x73 = x67 ^ x72;
+    uint x74 = x73 & a1;
+    uint x75 = x67 ^ x74;
+    uint x76 = x62 ^ x75;
+    uint x77 = x76 & a6;
+    uint x78 = x62 ^ x77;
+    uint x79 = ~x32;
+    uint x80 = x64 ^ x9;
+    uint x81 = x80 & a3;
+    uint x82 = x64 ^ x81;
+    uint x83 = a2 ^ x68;
+    uint x84 = x21 ^ x83;
+    uint x85 = x84 & a3;
+    uint x86 = x21 ^ x85;
+    uint x87 = x82 ^ x86;
+    uint x88 = x87 & a1;
+    uint x89 = x82 ^ x88;
+    uint x90 = x79 ^ x89;
+    uint x91 = x90 & a6;
+    uint x92 = x79 ^ x91;
+    l[4] ^= x35;
+    l[26] ^= x53;
+    l[14] ^= x78;
+    l[20] ^= x92;
+}
+
+// DES of the key slices k[56] under the fixed challenge; l and r end up
+// holding L16 and R16. The initial permutation of the challenge is folded
+// into the starting slices, and the key schedule into the S-box inputs.
+inline void des_bs_encrypt(const uint *k, uint *l, uint *r) {
+    #pragma unroll
+    for (int i = 0; i < 32; i++) {
+        l[i] = (DES_BS_L0 >> i) & 1 ? 0xffffffff : 0;
+        r[i] = (DES_BS_R0 >> i) & 1 ? 0xffffffff : 0;
+    }
+
+    // Round 1
+    des_bs_s1(l, r[31] ^ k[47], r[0] ^ k[11], r[1] ^ k[26],
+              r[2] ^ k[3], r[3] ^ k[13], r[4] ^ k[41]);
+    des_bs_s2(l, r[3] ^ k[27], r[4] ^ k[6], r[5] ^ k[54],
+              r[6] ^ k[48], r[7] ^ k[39], r[8] ^ k[19]);
+    des_bs_s3(l, r[7] ^ k[53], r[8] ^ k[25], r[9] ^ k[33],
+              r[10] ^ k[34], r[11] ^ k[17], r[12] ^ k[5]);
+    des_bs_s4(l, r[11] ^ k[4], r[12] ^ k[55], r[13] ^ k[24],
+              r[14] ^ k[32], r[15] ^ k[40], r[16] ^ k[20]);
+    des_bs_s5(l, r[15] ^ k[36], r[16] ^ k[31], r[17] ^ k[21],
+              r[18] ^ k[8], r[19] ^ k[23], r[20] ^ k[52]);
+    des_bs_s6(l, r[19] ^ k[14], r[20] ^ k[29], r[21] ^ k[51],
+              r[22] ^ k[9], r[23] ^ k[35], r[24] ^ k[30]);
+    des_bs_s7(l, r[23] ^ k[2], r[24] ^ k[37], r[25] ^ k[22],
+              r[26] ^ k[0], r[27] ^ k[42], r[28] ^ k[38]);
+    des_bs_s8(l, r[27] ^ k[16], r[28] ^ k[43], r[29] ^ k[44],
+              r[30] ^ k[1], r[31] ^ k[7], r[0] ^ k[28]);
+
+    // Round 2
+    des_bs_s1(r, l[31] ^ k[54], l[0] ^ k[18], l[1] ^ k[33],
+              l[2] ^ k[10], l[3] ^ k[20], l[4] ^ k[48]);
+    des_bs_s2(r, l[3] ^ k[34], l[4] ^ k[13], l[5] ^ k[4],
+              l[6] ^ k[55], l[7] ^ k[46], l[8] ^ k[26]);
+    des_bs_s3(r, l[7] ^ k[3], l[8] ^ k[32], l[9] ^ k[40],
+              l[10] ^ k[41], l[11] ^ k[24], l[12] ^ k[12]);
+    des_bs_s4(r, l[11] ^ k[11], l[12] ^ k[5], l[13] ^ k[6],
+              l[14] ^ k[39], l[15] ^ k[47], l[16] ^ k[27]);
+    des_bs_s5(r, l[15] ^ k[43], l[16] ^ k[38], l[17] ^ k[28],
+              l[18] ^ k[15], l[19] ^ k[30], l[20] ^ k[0]);
+    des_bs_s6(r, l[19] ^ k[21], l[20] ^ k[36], l[21] ^ k[31],
+              l[22] ^ k[16], l[23] ^ k[42], l[24] ^ k[37]);
+    des_bs_s7(r, l[23] ^ k[9], l[24] ^ k[44], l[25] ^ k[29],
+              l[26] ^ k[7], l[27] ^ k[49], l[28] ^ k[45]);
+    des_bs_s8(r, l[27] ^ k[23], l[28] ^ k[50], l[29] ^ k[51],
+              l[30] ^ k[8], l[31] ^ k[14], l[0] ^ k[35]);
+
+    // Round 3
+    des_bs_s1(l, r[31] ^ k[11], r[0] ^ k[32], r[1] ^ k[47],
+              r[2] ^ k[24], r[3] ^ k[34], r[4] ^ k[5]);
+    des_bs_s2(l, r[3] ^ k[48], r[4] ^ k[27], r[5] ^ k[18],
+              r[6] ^ k[12], r[7] ^ k[3], r[8] ^ k[40]);
+    des_bs_s3(l, r[7] ^ k[17], r[8] ^ k[46], r[9] ^ k[54],
+              r[10] ^ k[55], r[11] ^ k[13], r[12] ^ k[26]);
+    des_bs_s4(l, r[11] ^ k[25], r[12] ^ k[19], r[13] ^ k[20],
+              r[14] ^ k[53], r[15] ^ k[4], r[16] ^ k[41]);
+    des_bs_s5(l, r[15] ^ k[2], r[16] ^ k[52], r[17] ^ k[42],
+              r[18] ^ k[29], r[19] ^ k[44], r[20] ^ k[14]);
+    des_bs_s6(l, r[19] ^ k[35], r[20] ^ k[50], r[21] ^ k[45],
+              r[22] ^ k[30], r[23] ^ k[1], r[24] ^ k[51]);
+    des_bs_s7(l, r[23] ^ k[23], r[24] ^ k[31], r[25] ^ k[43],
+              r[26] ^ k[21], r[27] ^ k[8], r[28] ^ k[0]);
+    des_bs_s8(l, r[27] ^ k[37], r[28] ^ k[9], r[29] ^ k[38],
+              r[30] ^ k[22], r[31] ^ k[28], r[0] ^ k[49]);
+
+    // Round 4
+    des_bs_s1(r, l[31] ^ k[25], l[0] ^ k[46], l[1] ^ k[4],
+              l[2] ^ k[13], l[3] ^ k[48], l[4] ^ k[19]);
+    des_bs_s2(r, l[3] ^ k[5], l[4] ^ k[41], l[5] ^ k[32],
+              l[6] ^ k[26], l[7] ^ k[17], l[8] ^ k[54]);
+    des_bs_s3(r, l[7] ^ k[6], l[8] ^ k[3], l[9] ^ k[11],
+              l[10] ^ k[12], l[11] ^ k[27], l[12] ^ k[40]);
+    des_bs_s4(r, l[11] ^ k[39], l[12] ^ k[33], l[13] ^ k[34],
+              l[14] ^ k[10], l[15] ^ k[18], l[16] ^ k[55]);
+    des_bs_s5(r, l[15] ^ k[16], l[16] ^ k[7], l[17] ^ k[1],
+              l[18] ^ k[43], l[19] ^ k[31], l[20] ^ k[28]);
+    des_bs_s6(r, l[19] ^ k[49], l[20] ^ k[9], l[21] ^ k[0],
+              l[22] ^ k[44], l[23] ^ k[15], l[24] ^ k[38]);
+    des_bs_s7(r, l[23] ^ k[37], l[24] ^ k[45], l[25] ^ k[2],
+              l[26] ^ k[35], l[27] ^ k[22], l[28] ^ k[14]);
+    des_bs_s8(r, l[27] ^ k[51], l[28] ^ k[23], l[29] ^ k[52],
+              l[30] ^ k[36], l[31] ^ k[42], l[0] ^ k[8]);
+
+    // Round 5
+    des_bs_s1(l, r[31] ^ k[39], r[0] ^ k[3], r[1] ^ k[18],
+              r[2] ^ k[27], r[3] ^ k[5], r[4] ^ k[33]);
+    des_bs_s2(l, r[3] ^ k[19], r[4] ^ k[55], r[5] ^ k[46],
+              r[6] ^ k[40], r[7] ^ k[6], r[8] ^ k[11]);
+    des_bs_s3(l, r[7] ^ k[20], r[8] ^ k[17], r[9] ^ k[25],
+              r[10] ^ k[26], r[11] ^ k[41], r[12] ^ k[54]);
+    des_bs_s4(l, r[11] ^ k[53], r[12] ^ k[47], r[13] ^ k[48],
+              r[14] ^ k[24], r[15] ^ k[32], r[16] ^ k[12]);
+    des_bs_s5(l, r[15] ^ k[30], r[16] ^ k[21], r[17] ^ k[15],
+              r[18] ^ k[2], r[19] ^ k[45], r[20] ^ k[42]);
+    des_bs_s6(l, r[19] ^ k[8], r[20] ^ k[23], r[21] ^ k[14],
+              r[22] ^ k[31], r[23] ^ k[29], r[24] ^ k[52]);
+    des_bs_s7(l, r[23] ^ k[51], r[24] ^ k[0], r[25] ^ k[16],
+              r[26] ^ k[49], r[27] ^ k[36], r[28] ^ k[28]);
+    des_bs_s8(l, r[27] ^ k[38], r[28] ^ k[37], r[29] ^ k[7],
+              r[30] ^ k[50], r[31] ^ k[1], r[0] ^ k[22]);
+
+    // Round 6
+    des_bs_s1(r, l[31] ^ k[53], l[0] ^ k[17], l[1] ^ k[32],
+              l[2] ^ k[41], l[3] ^ k[19], l[4] ^ k[47]);
+    des_bs_s2(r, l[3] ^ k[33], l[4] ^ k[12], l[5] ^ k[3],
+              l[6] ^ k[54], l[7] ^ k[20], l[8] ^ k[25]);
+    des_bs_s3(r, l[7] ^ k[34], l[8] ^ k[6], l[9] ^ k[39],
+              l[10] ^ k[40], l[11] ^ k[55], l[12] ^ k[11]);
+    des_bs_s4(r, l[11] ^ k[10], l[12] ^ k[4], l[13] ^ k[5],
+              l[14] ^ k[13], l[15] ^ k[46], l[16] ^ k[26]);
+    des_bs_s5(r, l[15] ^ k[44], l[16] ^ k[35], l[17] ^ k[29],
+              l[18] ^ k[16], l[19] ^ k[0], l[20] ^ k[1]);
+    des_bs_s6(r, l[19] ^ k[22], l[20] ^ k[37], l[21] ^ k[28],
+              l[22] ^ k[45], l[23] ^ k[43], l[24] ^ k[7]);
+    des_bs_s7(r, l[23] ^ k[38], l[24] ^ k[14], l[25] ^ k[30],
+              l[26] ^ k[8], l[27] ^ k[50], l[28] ^ k[42]);
+    des_bs_s8(r, l[27] ^ k[52], l[28] ^ k[51], l[29] ^ k[21],
+              l[30] ^ k[9], l[31] ^ k[15], l[0] ^ k[36]);
+
+    // Round 7
+    des_bs_s1(l, r[31] ^ k[10], r[0] ^ k[6], r[1] ^ k[46],
+              r[2] ^ k[55], r[3] ^ k[33], r[4] ^ k[4]);
+    des_bs_s2(l, r[3] ^ k[47], r[4] ^ k[26], r[5] ^ k[17],
+              r[6] ^ k[11], r[7] ^ k[34], r[8] ^ k[39]);
+    des_bs_s3(l, r[7] ^ k[48], r[8] ^ k[20], r[9] ^ k[53],
+              r[10] ^ k[54], r[11] ^ k[12], r[12] ^ k[25]);
+    des_bs_s4(l, r[11] ^ k[24], r[12] ^ k[18], r[13] ^ k[19],
+              r[14] ^ k[27], r[15] ^ k[3], r[16] ^ k[40]);
+    des_bs_s5(l, r[15] ^ k[31], r[16] ^ k[49], r[17] ^ k[43],
+              r[18] ^ k[30], r[19] ^ k[14], r[20] ^ k[15]);
+    des_bs_s6(l, r[19] ^ k[36], r[20] ^ k[51], r[21] ^ k[42],
+              r[22] ^ k[0], r[23] ^ k[2], r[24] ^ k[21]);
+    des_bs_s7(l, r[23] ^ k[52], r[24] ^ k[28], r[25] ^ k[44],
+              r[26] ^ k[22], r[27] ^ k[9], r[28] ^ k[1]);
+    des_bs_s8(l, r[27] ^ k[7], r[28] ^ k[38], r[29] ^ k[35],
+              r[30] ^ k[23], r[31] ^ k[29], r[0] ^ k[50]);
+
+    // Round 8
+    des_bs_s1(r, l[31] ^ k[24], l[0] ^ k[20], l[1] ^ k[3],
+              l[2] ^ k[12], l[3] ^ k[47], l[4] ^ k[18]);
+    des_bs_s2(r, l[3] ^ k[4], l[4] ^ k[40], l[5] ^ k[6],
+              l[6] ^ k[25], l[7] ^ k[48], l[8] ^ k[53]);
+    des_bs_s3(r, l[7] ^ k[5], l[8] ^ k[34], l[9] ^ k[10],
+              l[10] ^ k[11], l[11] ^ k[26], l[12] ^ k[39]);
+    des_bs_s4(r, l[11] ^ k[13], l[12] ^ k[32], l[13] ^ k[33],
+              l[14] ^ k[41], l[15] ^ k[17], l[16] ^ k[54]);
+    des_bs_s5(r, l[15] ^ k[45], l[16] ^ k[8], l[17] ^ k[2],
+              l[18] ^ k[44], l[19] ^ k[28], l[20] ^ k[29]);
+    des_bs_s6(r, l[19] ^ k[50], l[20] ^ k[38], l[21] ^ k[1],
+              l[22] ^ k[14], l[23] ^ k[16], l[24] ^ k[35]);
+    des_bs_s7(r, l[23] ^ k[7], l[24] ^ k[42], l[25] ^ k[31],
+              l[26] ^ k[36], l[27] ^ k[23], l[28] ^ k[15]);
+    des_bs_s8(r, l[27] ^ k[21], l[28] ^ k[52], l[29] ^ k[49],
+              l[30] ^ k[37], l[31] ^ k[43], l[0] ^ k[9]);
+
+    // Round 9
+    des_bs_s1(l, r[31] ^ k[6], r[0] ^ k[27], r[1] ^ k[10],
+              r[2] ^ k[19], r[3] ^ k[54], r[4] ^ k[25]);
+    des_bs_s2(l, r[3] ^ k[11], r[4] ^ k[47], r[5] ^ k[13],
+              r[6] ^ k[32], r[7] ^ k[55], r[8] ^ k[3]);
+    des_bs_s3(l, r[7] ^ k[12], r[8] ^ k[41], r[9] ^ k[17],
+              r[10] ^ k[18], r[11] ^ k[33], r[12] ^ k[46]);
+    des_bs_s4(l, r[11] ^ k[20], r[12] ^ k[39], r[13] ^ k[40],
+              r[14] ^ k[48], r[15] ^ k[24], r[16] ^ k[4]);
+    des_bs_s5(l, r[15] ^ k[52], r[16] ^ k[15], r[17] ^ k[9],
+              r[18] ^ k[51], r[19] ^ k[35], r[20] ^ k[36]);
+    des_bs_s6(l, r[19] ^ k[2], r[20] ^ k[45], r[21] ^ k[8],
+              r[22] ^ k[21], r[23] ^ k[23], r[24] ^ k[42]);
+    des_bs_s7(l, r[23] ^ k[14], r[24] ^ k[49], r[25] ^ k[38],
+              r[26] ^ k[43], r[27] ^ k[30], r[28] ^ k[22]);
+    des_bs_s8(l, r[27] ^ k[28], r[28] ^ k[0], r[29] ^ k[1],
+              r[30] ^ k[44], r[31] ^ k[50], r[0] ^ k[16]);
+
+    // Round 10
+    des_bs_s1(r, l[31] ^ k[20], l[0] ^ k[41], l[1] ^ k[24],
+              l[2] ^ k[33], l[3] ^ k[11], l[4] ^ k[39]);
+    des_bs_s2(r, l[3] ^ k[25], l[4] ^ k[4], l[5] ^ k[27],
+              l[6] ^ k[46], l[7] ^ k[12], l[8] ^ k[17]);
+    des_bs_s3(r, l[7] ^ k[26], l[8] ^ k[55], l[9] ^ k[6],
+              l[10] ^ k[32], l[11] ^ k[47], l[12] ^ k[3]);
+    des_bs_s4(r, l[11] ^ k[34], l[12] ^ k[53], l[13] ^ k[54],
+              l[14] ^ k[5], l[15] ^ k[13], l[16] ^ k[18]);
+    des_bs_s5(r, l[15] ^ k[7], l[16] ^ k[29], l[17] ^ k[23],
+              l[18] ^ k[38], l[19] ^ k[49], l[20] ^ k[50]);
+    des_bs_s6(r, l[19] ^ k[16], l[20] ^ k[0], l[21] ^ k[22],
+              l[22] ^ k[35], l[23] ^ k[37], l[24] ^ k[1]);
+    des_bs_s7(r, l[23] ^ k[28], l[24] ^ k[8], l[25] ^ k[52],
+              l[26] ^ k[2], l[27] ^ k[44], l[28] ^ k[36]);
+    des_bs_s8(r, l[27] ^ k[42], l[28] ^ k[14], l[29] ^ k[15],
+              l[30] ^ k[31], l[31] ^ k[9], l[0] ^ k[30]);
+
+    // Round 11
+    des_bs_s1(l, r[31] ^ k[34], r[0] ^ k[55], r[1] ^ k[13],
+              r[2] ^ k[47], r[3] ^ k[25], r[4] ^ k[53]);
+    des_bs_s2(l, r[3] ^ k[39], r[4] ^ k[18], r[5] ^ k[41],
+              r[6] ^ k[3], r[7] ^ k[26], r[8] ^ k[6]);
+    des_bs_s3(l, r[7] ^ k[40], r[8] ^ k[12], r[9] ^ k[20],
+              r[10] ^ k[46], r[11] ^ k[4], r[12] ^ k[17]);
+    des_bs_s4(l, r[11] ^ k[48], r[12] ^ k[10], r[13] ^ k[11],
+              r[14] ^ k[19], r[15] ^ k[27], r[16] ^ k[32]);
+    des_bs_s5(l, r[15] ^ k[21], r[16] ^ k[43], r[17] ^ k[37],
+              r[18] ^ k[52], r[19] ^ k[8], r[20] ^ k[9]);
+    des_bs_s6(l, r[19] ^ k[30], r[20] ^ k[14], r[21] ^ k[36],
+              r[22] ^ k[49], r[23] ^ k[51], r[24] ^ k[15]);
+    des_bs_s7(l, r[23] ^ k[42], r[24] ^ k[22], r[25] ^ k[7],
+              r[26] ^ k[16], r[27] ^ k[31], r[28] ^ k[50]);
+    des_bs_s8(l, r[27] ^ k[1], r[28] ^ k[28], r[29] ^ k[29],
+              r[30] ^ k[45], r[31] ^ k[23], r[0] ^ k[44]);
+
+    // Round 12
+    des_bs_s1(r, l[31] ^ k[48], l[0] ^ k[12], l[1] ^ k[27],
+              l[2] ^ k[4], l[3] ^ k[39], l[4] ^ k[10]);
+    des_bs_s2(r, l[3] ^ k[53], l[4] ^ k[32], l[5] ^ k[55],
+              l[6] ^ k[17], l[7] ^ k[40], l[8] ^ k[20]);
+    des_bs_s3(r, l[7] ^ k[54], l[8] ^ k[26], l[9] ^ k[34],
+              l[10] ^ k[3], l[11] ^ k[18], l[12] ^ k[6]);
+    des_bs_s4(r, l[11] ^ k[5], l[12] ^ k[24], l[13] ^ k[25],
+              l[14] ^ k[33], l[15] ^ k[41], l[16] ^ k[46]);
+    des_bs_s5(r, l[15] ^ k[35], l[16] ^ k[2], l[17] ^ k[51],
+              l[18] ^ k[7], l[19] ^ k[22], l[20] ^ k[23]);
+    des_bs_s6(r, l[19] ^ k[44], l[20] ^ k[28], l[21] ^ k[50],
+              l[22] ^ k[8], l[23] ^ k[38], l[24] ^ k[29]);
+    des_bs_s7(r, l[23] ^ k[1], l[24] ^ k[36], l[25] ^ k[21],
+              l[26] ^ k[30], l[27] ^ k[45], l[28] ^ k[9]);
+    des_bs_s8(r, l[27] ^ k[15], l[28] ^ k[42], l[29] ^ k[43],
+              l[30] ^ k[0], l[31] ^ k[37], l[0] ^ k[31]);
+
+    // Round 13
+    des_bs_s1(l, r[31] ^ k[5], r[0] ^ k[26], r[1] ^ k[41],
+              r[2] ^ k[18], r[3] ^ k[53], r[4] ^ k[24]);
+    des_bs_s2(l, r[3] ^ k[10], r[4] ^ k[46], r[5] ^ k[12],
+              r[6] ^ k[6], r[7] ^ k[54], r[8] ^ k[34]);
+    des_bs_s3(l, r[7] ^ k[11], r[8] ^ k[40], r[9] ^ k[48],
+              r[10] ^ k[17], r[11] ^ k[32], r[12] ^ k[20]);
+    des_bs_s4(l, r[11] ^ k[19], r[12] ^ k[13], r[13] ^ k[39],
+              r[14] ^ k[47], r[15] ^ k[55], r[16] ^ k[3]);
+    des_bs_s5(l, r[15] ^ k[49], r[16] ^ k[16], r[17] ^ k[38],
+              r[18] ^ k[21], r[19] ^ k[36], r[20] ^ k[37]);
+    des_bs_s6(l, r[19] ^ k[31], r[20] ^ k[42], r[21] ^ k[9],
+              r[22] ^ k[22], r[23] ^ k[52], r[24] ^ k[43]);
+    des_bs_s7(l, r[23] ^ k[15], r[24] ^ k[50], r[25] ^ k[35],
+              r[26] ^ k[44], r[27] ^ k[0], r[28] ^ k[23]);
+    des_bs_s8(l, r[27] ^ k[29], r[28] ^ k[1], r[29] ^ k[2],
+              r[30] ^ k[14], r[31] ^ k[51], r[0] ^ k[45]);
+
+    // Round 14
+    des_bs_s1(r, l[31] ^ k[19], l[0] ^ k[40], l[1] ^ k[55],
+              l[2] ^ k[32], l[3] ^ k[10], l[4] ^ k[13]);
+    des_bs_s2(r, l[3] ^ k[24], l[4] ^ k[3], l[5] ^ k[26],
+              l[6] ^ k[20], l[7] ^ k[11], l[8] ^ k[48]);
+    des_bs_s3(r, l[7] ^ k[25], l[8] ^ k[54], l[9] ^ k[5],
+              l[10] ^ k[6], l[11] ^ k[46], l[12] ^ k[34]);
+    des_bs_s4(r, l[11] ^ k[33], l[12] ^ k[27], l[13] ^ k[53],
+              l[14] ^ k[4], l[15] ^ k[12], l[16] ^ k[17]);
+    des_bs_s5(r, l[15] ^ k[8], l[16] ^ k[30], l[17] ^ k[52],
+              l[18] ^ k[35], l[19] ^ k[50], l[20] ^ k[51]);
+    des_bs_s6(r, l[19] ^ k[45], l[20] ^ k[1], l[21] ^ k[23],
+              l[22] ^ k[36], l[23] ^ k[7], l[24] ^ k[2]);
+    des_bs_s7(r, l[23] ^ k[29], l[24] ^ k[9], l[25] ^ k[49],
+              l[26] ^ k[31], l[27] ^ k[14], l[28] ^ k[37]);
+    des_bs_s8(r, l[27] ^ k[43], l[28] ^ k[15], l[29] ^ k[16],
+              l[30] ^ k[28], l[31] ^ k[38], l[0] ^ k[0]);
+
+    // Round 15
+    des_bs_s1(l, r[31] ^ k[33], r[0] ^ k[54], r[1] ^ k[12],
+              r[2] ^ k[46], r[3] ^ k[24], r[4] ^ k[27]);
+    des_bs_s2(l, r[3] ^ k[13], r[4] ^ k[17], r[5] ^ k[40],
+              r[6] ^ k[34], r[7] ^ k[25], r[8] ^ k[5]);
+    des_bs_s3(l, r[7] ^ k[39], r[8] ^ k[11], r[9] ^ k[19],
+              r[10] ^ k[20], r[11] ^ k[3], r[12] ^ k[48]);
+    des_bs_s4(l, r[11] ^ k[47], r[12] ^ k[41], r[13] ^ k[10],
+              r[14] ^ k[18], r[15] ^ k[26], r[16] ^ k[6]);
+    des_bs_s5(l, r[15] ^ k[22], r[16] ^ k[44], r[17] ^ k[7],
+              r[18] ^ k[49], r[19] ^ k[9], r[20] ^ k[38]);
+    des_bs_s6(l, r[19] ^ k[0], r[20] ^ k[15], r[21] ^ k[37],
+              r[22] ^ k[50], r[23] ^ k[21], r[24] ^ k[16]);
+    des_bs_s7(l, r[23] ^ k[43], r[24] ^ k[23], r[25] ^ k[8],
+              r[26] ^ k[45], r[27] ^ k[28], r[28] ^ k[51]);
+    des_bs_s8(l, r[27] ^ k[2], r[28] ^ k[29], r[29] ^ k[30],
+              r[30] ^ k[42], r[31] ^ k[52], r[0] ^ k[14]);
+
+    // Round 16
+    des_bs_s1(r, l[31] ^ k[40], l[0] ^ k[4], l[1] ^ k[19],
+              l[2] ^ k[53], l[3] ^ k[6], l[4] ^ k[34]);
+    des_bs_s2(r, l[3] ^ k[20], l[4] ^ k[24], l[5] ^ k[47],
+              l[6] ^ k[41], l[7] ^ k[32], l[8] ^ k[12]);
+    des_bs_s3(r, l[7] ^ k[46], l[8] ^ k[18], l[9] ^ k[26],
+              l[10] ^ k[27], l[11] ^ k[10], l[12] ^ k[55]);
+    des_bs_s4(r, l[11] ^ k[54], l[12] ^ k[48], l[13] ^ k[17],
+              l[14] ^ k[25], l[15] ^ k[33], l[16] ^ k[13]);
+    des_bs_s5(r, l[15] ^ k[29], l[16] ^ k[51], l[17] ^ k[14],
+              l[18] ^ k[1], l[19] ^ k[16], l[20] ^ k[45]);
+    des_bs_s6(r, l[19] ^ k[7], l[20] ^ k[22], l[21] ^ k[44],
+              l[22] ^ k[2], l[23] ^ k[28], l[24] ^ k[23]);
+    des_bs_s7(r, l[23] ^ k[50], l[24] ^ k[30], l[25] ^ k[15],
+              l[26] ^ k[52], l[27] ^ k[35], l[28] ^ k[31]);
+    des_bs_s8(r, l[27] ^ k[9], l[28] ^ k[36], l[29] ^ k[37],
+              l[30] ^ k[49], l[31] ^ k[0], l[0] ^ k[21]);
+}
+
+// Bit i of LE64(ciphertext) (byte i / 8, bit i % 8) after des_bs_encrypt
+inline uint des_bs_hash_bit(const uint *l, const uint *r, int i) {
+    int slice = 31 - i / 8 - 8 * ((i % 8) >> 1);
+    return i & 1 ? l[slice] : r[slice];
+}
+
+// k = (LE64(ciphertext) + cnt) mod 2^56, then cnt + 1: the reduction for
+// the 2^56 keyspace, with cnt holding reduction_offset + pos per lane
+inline void des_bs_reduce(uint *k, const uint *l, const uint *r, uint *cnt) {
+    uint carry = 0;
+    #pragma unroll
+    for (int i = 0; i < 56; i++) {
+        uint h = des_bs_hash_bit(l, r, i);
+        if (i < DES_BS_COUNTER_BITS) {
+            uint c = cnt[i], t = h ^ c;
+            k[i] = t ^ carry;
+            carry = (h & c) | (t & carry);
+        } else {
+            k[i] = h ^ carry;
+            carry &= h;
+        }
+    }
+
+    carry = 0xffffffff;
+    #pragma unroll
+    for (int i = 0; i < DES_BS_COUNTER_BITS; i++) {
+        uint c = cnt[i];
+        cnt[i] = c ^ carry;
+        carry &= c;
+    }
+}
+
+// Moves bits 0..bits-1 of v into lane `lane` of the slices
+inline void des_bs_put(uint *s, int bits, ulong v, uint lane) {
+    #pragma unroll
+    for (int i = 0; i < 56; i++) {
+        if (i < bits) {
+            s[i] |= (uint)((v >> i) & 1) << lane;
+        }
+    }
+}
+
+inline ulong des_bs_get(const uint *s, uint lane) {
+    ulong v = 0;
+    #pragma unroll
+    for (int i = 0; i < 56; i++) {
+        v |= (ulong)((s[i] >> lane) & 1) << i;
+    }
+    return v;
+}
\ No newline at end of file
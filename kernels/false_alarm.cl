@@ -164,6 +164,22 @@ __constant uint RHs[16] = {
     0x00000101, 0x01000101, 0x00010101, 0x01010101,
 };
 
+// The host builds for its table parameters and challenge with -D options
+// (gpu_set_table_params). The defaults are challenge 1122334455667788 and
+// no table; kernels compare their arguments against the build, so other
+// tables still take the generic path.
+#ifndef DES_IP_X
+#define DES_IP_X 0xf0aaf0aa
+#define DES_IP_Y 0x00cd00cd
+#endif
+
+// A power-of-two keyspace (2^56 for byte#7-7 tables) reduces with a mask
+// instead of a 64-bit modulo
+#if defined(DES_PLAINTEXT_SPACE) && defined(DES_REDUCTION_OFFSET) && \
+    (DES_PLAINTEXT_SPACE & (DES_PLAINTEXT_SPACE - 1)) == 0
+#define DES_SPACE_MASK (DES_PLAINTEXT_SPACE - 1)
+#endif
+
 inline void des_setkey(uint *SK, uchar *key) {
     uint X, Y, T;
 
@@ -186,6 +202,7 @@ inline void des_setkey(uint *SK, uchar *key) {
     X &= 0x0FFFFFFF;
     Y &= 0x0FFFFFFF;
 
+    #pragma unroll
     for (int i = 0; i < 16; i++) {
         if (i < 2 || i == 8 || i == 15) {
             X = ((X << 1) | (X >> 27)) & 0x0FFFFFFF;
@@ -224,9 +241,10 @@ inline void des_setkey(uint *SK, uchar *key) {
 inline void des_encrypt(uint *SK, uchar *output) {
     uint X, Y, T;
     
-    X = 0xf0aaf0aa;
-    Y = 0x00cd00cd;
+    X = DES_IP_X;
+    Y = DES_IP_Y;
 
+    #pragma unroll
     for (int i = 0; i < 8; i++) {
         T = SK[i * 4] ^ Y;
         X ^= SB8[(T) & 0x3F] ^ SB6[(T >> 8) & 0x3F] ^
@@ -277,66 +295,243 @@ inline ulong hash_to_index(uchar *hash, uint reduction_offset, ulong plaintext_s
                 (ulong)hash[5] << 40 | (ulong)hash[4] << 32 |
                 (ulong)hash[3] << 24 | (ulong)hash[2] << 16 |
                 (ulong)hash[1] << 8  | (ulong)hash[0];
+#ifdef DES_SPACE_MASK
+    if (plaintext_space_total == DES_PLAINTEXT_SPACE && reduction_offset == DES_REDUCTION_OFFSET) {
+        return (ret + DES_REDUCTION_OFFSET + pos) & DES_SPACE_MASK;
+    }
+#endif
     return (ret + reduction_offset + pos) % plaintext_space_total;
 }
 
 inline void index_to_plaintext(ulong index, uchar *key_out) {
+    #pragma unroll
     for (int i = 6; i >= 0; i--) {
         key_out[i] = index % 256;
         index /= 256;
     }
 }
 
+// Subkeys from the host's contribution table (des_subkey_nibble_table):
+// the key schedule only moves key bits around, so the subkeys are the xor
+// of one 32-word row per key nibble, read straight off the index.
+inline void des_subkeys(__global const uint *g_subkeys, ulong index, uint *SK) {
+    for (int w = 0; w < 32; w++) {
+        SK[w] = 0;
+    }
+    #pragma unroll
+    for (int n = 0; n < 14; n++) {
+        __global const uint *row = g_subkeys + (n * 16 + ((index >> (52 - 4 * n)) & 15)) * 32;
+        for (int w = 0; w < 32; w++) {
+            SK[w] ^= row[w];
+        }
+    }
+}
+
+// The false alarm kernels run as persistent threads: the host starts only
+// as many work items as the device holds at once, and each takes the next
+// candidate (32 for the bitsliced kernel) from g_next until none are left.
+// The host hands them over by position, so the cheap walks go first.
+// Once a work item finds the key, the others stop at their next poll of
+// g_found_idx instead of walking their chains to the end.
+#define FOUND_POLL_STEPS 4096       // power of two
+
+inline int key_found(__global int *g_found_idx) {
+    return *(volatile __global int *)g_found_idx >= 0;
+}
+
 __kernel void check_false_alarms(
     __global uchar *g_target_hash,      // 8 bytes - the hash we're looking for
     __global ulong *g_start_indices,    // start index for each candidate
-    __global uint *g_positions,         // chain position for each candidate  
+    __global uint *g_positions,         // chain position for each candidate
     uint num_candidates,
     uint reduction_offset,
     ulong plaintext_space_total,
     __global int *g_found_idx,          // output: index of found candidate (-1 if not found)
-    __global uchar *g_found_key         // output: 7-byte key if found
+    __global uchar *g_found_key,        // output: 7-byte key if found
+    __global uint *g_next               // next candidate to take, starts at 0
 ) {
-    uint id = get_global_id(0);
-    
-    if (id >= num_candidates) {
-        return;
-    }
-    
-    ulong index = g_start_indices[id];
-    uint target_pos = g_positions[id];
-    
     uchar hash[8];
     uchar key[7];
     
-    // Walk chain from start to target position
-    for (uint p = 0; p <= target_pos; p++) {
+    while (!key_found(g_found_idx)) {
+        uint id = atomic_inc(g_next);
+        if (id >= num_candidates) {
+            return;
+        }
+        
+        ulong index = g_start_indices[id];
+        uint target_pos = g_positions[id];
+        
+        // Walk chain from start to target position
+        for (uint p = 0; p < target_pos; p++) {
+            if ((p & (FOUND_POLL_STEPS - 1)) == FOUND_POLL_STEPS - 1 && key_found(g_found_idx)) {
+                return;
+            }
+            index_to_plaintext(index, key);
+            netntlmv1_hash(key, hash);
+            index = hash_to_index(hash, reduction_offset, plaintext_space_total, p);
+        }
         index_to_plaintext(index, key);
         netntlmv1_hash(key, hash);
         
-        if (p == target_pos) {
-            // Check if hash matches target
-            int match = 1;
-            for (int i = 0; i < 8; i++) {
-                if (hash[i] != g_target_hash[i]) {
-                    match = 0;
-                    break;
+        // Check if hash matches target
+        int match = 1;
+        for (int i = 0; i < 8; i++) {
+            if (hash[i] != g_target_hash[i]) {
+                match = 0;
+                break;
+            }
+        }
+        
+        if (match) {
+            // Found it! Use atomic to avoid race conditions
+            if (atomic_cmpxchg(g_found_idx, -1, (int)id) == -1) {
+                // We won the race, write the key
+                for (int i = 0; i < 7; i++) {
+                    g_found_key[i] = key[i];
+                }
+            }
+            return;
+        }
+    }
+}
+
+// check_false_alarms with subkeys from the contribution table instead of
+// the key schedule (see precompute_sk)
+__kernel void check_false_alarms_sk(
+    __global uchar *g_target_hash,
+    __global ulong *g_start_indices,
+    __global uint *g_positions,
+    uint num_candidates,
+    uint reduction_offset,
+    ulong plaintext_space_total,
+    __global int *g_found_idx,
+    __global uchar *g_found_key,
+    __global uint *g_next,
+    __global const uint *g_subkeys
+) {
+    uchar hash[8];
+    uint SK[32];
+    
+    while (!key_found(g_found_idx)) {
+        uint id = atomic_inc(g_next);
+        if (id >= num_candidates) {
+            return;
+        }
+        
+        ulong index = g_start_indices[id];
+        uint target_pos = g_positions[id];
+        
+        for (uint p = 0; p < target_pos; p++) {
+            if ((p & (FOUND_POLL_STEPS - 1)) == FOUND_POLL_STEPS - 1 && key_found(g_found_idx)) {
+                return;
+            }
+            des_subkeys(g_subkeys, index, SK);
+            des_encrypt(SK, hash);
+            index = hash_to_index(hash, reduction_offset, plaintext_space_total, p);
+        }
+        des_subkeys(g_subkeys, index, SK);
+        des_encrypt(SK, hash);
+        
+        int match = 1;
+        for (int i = 0; i < 8; i++) {
+            if (hash[i] != g_target_hash[i]) {
+                match = 0;
+                break;
+            }
+        }
+        
+        if (match) {
+            if (atomic_cmpxchg(g_found_idx, -1, (int)id) == -1) {
+                uchar key[7];
+                index_to_plaintext(index, key);
+                for (int i = 0; i < 7; i++) {
+                    g_found_key[i] = key[i];
                 }
             }
+            return;
+        }
+    }
+}
+
+// check_false_alarms on the bitsliced DES (des_bs.cl): a work item walks
+// candidates 32g..32g+31 of each group g it takes together, comparing
+// each lane's hash against the target once its position comes up. The
+// candidates are sorted by position, so a group's lanes come due in order
+// and finish close together. Needs the 2^56 keyspace.
+__kernel void check_false_alarms_bs(
+    __global uchar *g_target_hash,
+    __global ulong *g_start_indices,
+    __global uint *g_positions,         // ascending
+    uint num_candidates,
+    uint reduction_offset,
+    ulong plaintext_space_total,
+    __global int *g_found_idx,
+    __global uchar *g_found_key,
+    __global uint *g_next               // next group of DES_BS_LANES candidates
+) {
+    uint k[56], cnt[DES_BS_COUNTER_BITS], l[32], r[32];
+    ulong target = 0;
+    
+    for (int i = 7; i >= 0; i--) {
+        target = target << 8 | g_target_hash[i];
+    }
+    
+    while (!key_found(g_found_idx)) {
+        uint group = atomic_inc(g_next);
+        if (group >= (num_candidates + DES_BS_LANES - 1) / DES_BS_LANES) {
+            return;
+        }
+        
+        uint base = group * DES_BS_LANES;
+        uint lanes = min((uint)DES_BS_LANES, num_candidates - base);
+        
+        #pragma unroll
+        for (int i = 0; i < 56; i++) {
+            k[i] = 0;
+        }
+        for (uint lane = 0; lane < lanes; lane++) {
+            des_bs_put(k, 56, g_start_indices[base + lane], lane);
+        }
+        // Every walk reduces at positions 0, 1, ...
+        #pragma unroll
+        for (int i = 0; i < DES_BS_COUNTER_BITS; i++) {
+            cnt[i] = (reduction_offset >> i) & 1 ? 0xffffffff : 0;
+        }
+        
+        uint next = 0;
+        uint next_pos = g_positions[base];
+        uint last_pos = g_positions[base + lanes - 1];
+        for (uint p = 0; ; p++) {
+            if ((p & (FOUND_POLL_STEPS - 1)) == FOUND_POLL_STEPS - 1 && key_found(g_found_idx)) {
+                return;
+            }
+            des_bs_encrypt(k, l, r);
             
-            if (match) {
-                // Found it! Use atomic to avoid race conditions
-                int old = atomic_cmpxchg(g_found_idx, -1, (int)id);
-                if (old == -1) {
-                    // We won the race, write the key
-                    for (int i = 0; i < 7; i++) {
-                        g_found_key[i] = key[i];
+            if (next_pos == p) {
+                // Lanes whose hash differs from the target in some bit
+                uint differ = 0;
+                #pragma unroll
+                for (int i = 0; i < 64; i++) {
+                    differ |= des_bs_hash_bit(l, r, i) ^ ((target >> i) & 1 ? 0xffffffff : 0);
+                }
+                
+                for (; next < lanes && g_positions[base + next] == p; next++) {
+                    if (!((differ >> next) & 1) &&
+                        atomic_cmpxchg(g_found_idx, -1, (int)(base + next)) == -1) {
+                        ulong index = des_bs_get(k, next);
+                        for (int i = 0; i < 7; i++) {
+                            g_found_key[i] = (uchar)(index >> (8 * (6 - i)));
+                        }
                     }
                 }
-                return;
+                next_pos = next < lanes ? g_positions[base + next] : 0;
+            }
+            
+            if (p == last_pos) {
+                break;
             }
+            des_bs_reduce(k, l, r, cnt);
         }
-        
-        index = hash_to_index(hash, reduction_offset, plaintext_space_total, p);
     }
 }
\ No newline at end of file
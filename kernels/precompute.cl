@@ -167,6 +167,22 @@ __constant uint RHs[16] = {
     0x00000101, 0x01000101, 0x00010101, 0x01010101,
 };
 
+// The host builds for its table parameters and challenge with -D options
+// (gpu_set_table_params). The defaults are challenge 1122334455667788 and
+// no table; kernels compare their arguments against the build, so other
+// tables still take the generic path.
+#ifndef DES_IP_X
+#define DES_IP_X 0xf0aaf0aa
+#define DES_IP_Y 0x00cd00cd
+#endif
+
+// A power-of-two keyspace (2^56 for byte#7-7 tables) reduces with a mask
+// instead of a 64-bit modulo
+#if defined(DES_PLAINTEXT_SPACE) && defined(DES_REDUCTION_OFFSET) && \
+    (DES_PLAINTEXT_SPACE & (DES_PLAINTEXT_SPACE - 1)) == 0
+#define DES_SPACE_MASK (DES_PLAINTEXT_SPACE - 1)
+#endif
+
 inline void des_setkey(uint *SK, uchar *key) {
     uint X, Y, T;
 
@@ -189,6 +205,7 @@ inline void des_setkey(uint *SK, uchar *key) {
     X &= 0x0FFFFFFF;
     Y &= 0x0FFFFFFF;
 
+    #pragma unroll
     for (int i = 0; i < 16; i++) {
         if (i < 2 || i == 8 || i == 15) {
             X = ((X << 1) | (X >> 27)) & 0x0FFFFFFF;
@@ -227,9 +244,10 @@ inline void des_setkey(uint *SK, uchar *key) {
 inline void des_encrypt(uint *SK, uchar *output) {
     uint X, Y, T;
     
-    X = 0xf0aaf0aa;
-    Y = 0x00cd00cd;
+    X = DES_IP_X;
+    Y = DES_IP_Y;
 
+    #pragma unroll
     for (int i = 0; i < 8; i++) {
         T = SK[i * 4] ^ Y;
         X ^= SB8[(T) & 0x3F] ^ SB6[(T >> 8) & 0x3F] ^
@@ -281,16 +299,38 @@ inline ulong hash_to_index(uchar *hash, uint reduction_offset, ulong plaintext_s
                 (ulong)hash[5] << 40 | (ulong)hash[4] << 32 |
                 (ulong)hash[3] << 24 | (ulong)hash[2] << 16 |
                 (ulong)hash[1] << 8  | (ulong)hash[0];
+#ifdef DES_SPACE_MASK
+    if (plaintext_space_total == DES_PLAINTEXT_SPACE && reduction_offset == DES_REDUCTION_OFFSET) {
+        return (ret + DES_REDUCTION_OFFSET + pos) & DES_SPACE_MASK;
+    }
+#endif
     return (ret + reduction_offset + pos) % plaintext_space_total;
 }
 
 inline void index_to_plaintext(ulong index, uchar *key_out) {
+    #pragma unroll
     for (int i = 6; i >= 0; i--) {
         key_out[i] = index % 256;
         index /= 256;
     }
 }
 
+// Subkeys from the host's contribution table (des_subkey_nibble_table):
+// the key schedule only moves key bits around, so the subkeys are the xor
+// of one 32-word row per key nibble, read straight off the index.
+inline void des_subkeys(__global const uint *g_subkeys, ulong index, uint *SK) {
+    for (int w = 0; w < 32; w++) {
+        SK[w] = 0;
+    }
+    #pragma unroll
+    for (int n = 0; n < 14; n++) {
+        __global const uint *row = g_subkeys + (n * 16 + ((index >> (52 - 4 * n)) & 15)) * 32;
+        for (int w = 0; w < 32; w++) {
+            SK[w] ^= row[w];
+        }
+    }
+}
+
 __kernel void precompute(
     __global uchar *g_hash,
     uint chain_len,
@@ -321,4 +361,94 @@ __kernel void precompute(
     }
     
     g_output[pos] = index;
+}
+
+// precompute with subkeys from the contribution table instead of the key
+// schedule. Which of the two is faster depends on the device, so the host
+// times both and keeps the winner.
+__kernel void precompute_sk(
+    __global uchar *g_hash,
+    uint chain_len,
+    uint reduction_offset,
+    ulong plaintext_space_total,
+    __global ulong *g_output,
+    __global const uint *g_subkeys
+) {
+    uint pos = get_global_id(0);
+    
+    if (pos >= chain_len - 1) {
+        return;
+    }
+    
+    uchar hash[8];
+    uint SK[32];
+    ulong index;
+    
+    for (int i = 0; i < 8; i++) {
+        hash[i] = g_hash[i];
+    }
+    
+    index = hash_to_index(hash, reduction_offset, plaintext_space_total, pos);
+    
+    for (uint p = pos + 1; p < chain_len - 1; p++) {
+        des_subkeys(g_subkeys, index, SK);
+        des_encrypt(SK, hash);
+        index = hash_to_index(hash, reduction_offset, plaintext_space_total, p);
+    }
+    
+    g_output[pos] = index;
+}
+
+// precompute on the bitsliced DES (des_bs.cl): work item g walks the
+// chains of positions 32g..32g+31 together. Their walks differ by at most
+// 31 steps; each lane's end index is read out as its walk finishes. Needs
+// the 2^56 keyspace, whose mod is free in the bitsliced add.
+__kernel void precompute_bs(
+    __global uchar *g_hash,
+    uint chain_len,
+    uint reduction_offset,
+    ulong plaintext_space_total,
+    __global ulong *g_output
+) {
+    uint num_indices = chain_len - 1;
+    uint base = get_global_id(0) * DES_BS_LANES;
+    
+    if (base >= num_indices) {
+        return;
+    }
+    
+    uchar hash[8];
+    uint k[56], cnt[DES_BS_COUNTER_BITS], l[32], r[32];
+    
+    for (int i = 0; i < 8; i++) {
+        hash[i] = g_hash[i];
+    }
+    
+    #pragma unroll
+    for (int i = 0; i < 56; i++) {
+        k[i] = 0;
+    }
+    #pragma unroll
+    for (int i = 0; i < DES_BS_COUNTER_BITS; i++) {
+        cnt[i] = 0;
+    }
+    for (uint lane = 0; lane < DES_BS_LANES; lane++) {
+        uint pos = base + lane;
+        des_bs_put(k, 56, hash_to_index(hash, reduction_offset, plaintext_space_total, pos), lane);
+        des_bs_put(cnt, DES_BS_COUNTER_BITS, (ulong)reduction_offset + pos + 1, lane);
+    }
+    
+    // Lane j walks chain_len - 2 - (base + j) steps
+    uint steps = chain_len - 2 - base;
+    for (uint s = 0; ; s++) {
+        uint lane = steps - s;
+        if (lane < DES_BS_LANES && base + lane < num_indices) {
+            g_output[base + lane] = des_bs_get(k, lane);
+        }
+        if (s == steps) {
+            break;
+        }
+        des_bs_encrypt(k, l, r);
+        des_bs_reduce(k, l, r, cnt);
+    }
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <string.h>
 #include "utils.h"
 #include "opencl_host.h"
+#include "cpu_host.h"
+#include "des_bs.h"
 
 #define MAX_CANDIDATES (4 * 1024 * 1024)
 
@@ -37,29 +39,29 @@ int main(int argc, char **argv) {
         return 0;
     }
 
-    gpu_context gpu = {0};
-    if (gpu_init(&gpu) != 0) {
-        fprintf(stderr, "GPU init failed\n");
-        free(start_indices);
-        free(positions);
-        return 1;
-    }
-
-    if (gpu_load_false_alarm_kernel(&gpu, "kernels/false_alarm.cl") != 0) {
-        fprintf(stderr, "Kernel load failed\n");
-        gpu_cleanup(&gpu);
-        free(start_indices);
-        free(positions);
-        return 1;
-    }
-
     uint64_t plaintext_space = get_plaintext_space();
     uint8_t key_bytes[7] = {0};
+    int result;
 
-    int result = gpu_check_false_alarms(&gpu, ciphertext, start_indices, positions,
-                                         total, REDUCTION_OFFSET, plaintext_space, key_bytes);
+    // Without a usable GPU the chains are walked on the CPU
+    gpu_context gpu = {0};
+    int have_gpu = gpu_init(&gpu) == 0;
+    if (have_gpu) gpu_set_table_params(&gpu, REDUCTION_OFFSET, plaintext_space);
+    if (have_gpu && gpu_load_false_alarm_kernel(&gpu, "kernels/false_alarm.cl") != 0) {
+        gpu_cleanup(&gpu);
+        have_gpu = 0;
+    }
+    if (have_gpu) {
+        result = gpu_check_false_alarms(&gpu, ciphertext, start_indices, positions,
+                                        total, REDUCTION_OFFSET, plaintext_space, key_bytes);
+    } else {
+        fprintf(stderr, "No GPU, checking %u candidates on the CPU (%s)\n", total,
+                des_bs_engine());
+        result = cpu_check_false_alarms(ciphertext, start_indices, positions, total,
+                                        REDUCTION_OFFSET, plaintext_space, key_bytes);
+    }
 
-    gpu_cleanup(&gpu);
+    if (have_gpu) gpu_cleanup(&gpu);
     free(start_indices);
     free(positions);
 
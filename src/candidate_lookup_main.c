@@ -1,20 +1,66 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "utils.h"
 #include "table.h"
 
 #define MAX_BATCH_CANDIDATES 100000
 
+// First query with end >= key
+static uint32_t queries_lower_bound(const rt_query *queries, uint32_t n, uint64_t key) {
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (queries[mid].end < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Opens a table through its metadata sidecar when that beats loading it:
+// returns 1 if the queries cannot match it (skip it unread), 0 with the
+// table open (paged or loaded), -1 on failure
+static int open_table(rt_table *table, const char *path, const rt_query *queries,
+                      uint32_t num_queries) {
+    if (num_queries > 0 && table_open_paged(table, path) == 0) {
+        uint32_t lo = queries_lower_bound(queries, num_queries, table->meta->first_end);
+        uint32_t hi = table->meta->last_end == UINT64_MAX ? num_queries :
+            queries_lower_bound(queries, num_queries, table->meta->last_end + 1);
+        if (lo >= hi) {
+            table_free(table);
+            return 1;
+        }
+        if (table_paged_pays_off(table, hi - lo)) return 0;
+        table_free(table);
+    }
+    return table_load(table, path);
+}
+
 int main(int argc, char **argv) {
+    const char *prog = argv[0];
+    const char *cache_dir = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:")) != -1) {
+        if (opt != 'c') return 1;
+        cache_dir = optarg;
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
+
     if (argc < 4) {
-        fprintf(stderr, "Usage: %s <ciphertext_hex> <work_dir> <table1.rt> [table2.rt ...]\n", argv[0]);
+        fprintf(stderr, "Usage: %s [-c cache_dir] <ciphertext_hex> <work_dir> <table1.rt> [table2.rt ...]\n", prog);
         return 1;
     }
 
     const char *ct_hex = argv[1];
     const char *work_dir = argv[2];
 
+    // Tables in the resident cache are mapped from shared memory
+    if (cache_dir && table_set_cache(cache_dir) != 0) {
+        fprintf(stderr, "No table cache in %s, reading tables from disk\n", cache_dir);
+    }
+
     uint32_t num_indices = CHAIN_LEN - 1;
     uint64_t *end_indices = malloc(num_indices * sizeof(uint64_t));
     if (!end_indices) {
@@ -28,11 +74,14 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    // Sorted once, then merge-joined against every table
+    rt_query *queries = queries_build(end_indices, num_indices);
     uint64_t *start_indices = malloc(MAX_BATCH_CANDIDATES * sizeof(uint64_t));
     uint32_t *positions = malloc(MAX_BATCH_CANDIDATES * sizeof(uint32_t));
-    if (!start_indices || !positions) {
+    if (!queries || !start_indices || !positions) {
         fprintf(stderr, "malloc failed\n");
         free(end_indices);
+        free(queries);
         free(start_indices);
         free(positions);
         return 1;
@@ -43,23 +92,19 @@ int main(int argc, char **argv) {
 
     for (int t = 0; t < num_tables; t++) {
         const char *table_path = argv[3 + t];
-        
+
         rt_table table = {0};
-        if (table_load(&table, table_path) != 0) {
-            fprintf(stderr, "Table load failed: %s\n", table_path);
+        int ret = open_table(&table, table_path, queries, num_indices);
+        if (ret != 0) {
+            if (ret < 0) fprintf(stderr, "Table load failed: %s\n", table_path);
             continue;
         }
 
         uint32_t count = 0;
-        for (uint32_t pos = 0; pos < num_indices; pos++) {
-            int found = 0;
-            uint64_t start_index = table_search(&table, end_indices[pos], &found);
-            if (found && count < MAX_BATCH_CANDIDATES) {
-                start_indices[count] = start_index;
-                positions[count] = pos;
-                printf("%016llX:%08X\n", (unsigned long long)start_index, pos);
-                count++;
-            }
+        table_join_search(&table, queries, num_indices, start_indices, positions,
+                          &count, MAX_BATCH_CANDIDATES);
+        for (uint32_t i = 0; i < count; i++) {
+            printf("%016llX:%08X\n", (unsigned long long)start_indices[i], positions[i]);
         }
 
         table_free(&table);
@@ -71,6 +116,7 @@ int main(int argc, char **argv) {
     }
 
     free(end_indices);
+    free(queries);
     free(start_indices);
     free(positions);
     return 0;
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "cpu_host.h"
+#include "des_bs.h"
+#include "des.h"
+#include "rainbow.h"
+#include "utils.h"
+
+// Candidates walked between checks for a match, in engine widths
+#define FALSE_ALARM_BATCH_LANES 16
+// Consecutive positions per precompute chunk, in engine widths
+#define PRECOMPUTE_CHUNK_LANES 4
+#define PRECOMPUTE_PROGRESS_STEPS 10
+
+typedef struct {
+    const uint8_t *ciphertext;
+    uint32_t chain_len;
+    uint32_t reduction_offset;
+    uint64_t plaintext_space_total;
+    uint64_t *end_indices;
+    uint32_t num_indices;
+    uint32_t chunk;                     // positions per chunk
+    uint32_t num_chunks;
+    uint32_t next_chunk;                // shared, atomic
+    uint64_t total_steps;
+    uint64_t done_steps;                // shared, atomic
+    uint32_t reported;                  // progress tenths printed, atomic
+    double start;
+} precompute_work;
+
+// Walks of position pos take chain_len - 2 - pos steps, so a chunk of
+// consecutive positions is near uniform (lanes finish together) and the
+// chunks get cheaper in position order. Threads draw chunks from a shared
+// counter in that order, longest first: whoever drew long walks early
+// picks up the short ones at the end, and the last chunks to finish are
+// the cheapest, so threads end within one short chunk of each other.
+static void *precompute_worker(void *arg) {
+    precompute_work *w = arg;
+    des_bs_job *jobs = malloc(w->chunk * sizeof(des_bs_job));
+    if (!jobs) return (void *)1;
+
+    for (;;) {
+        uint32_t c = __atomic_fetch_add(&w->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= w->num_chunks) break;
+        uint32_t first = c * w->chunk;
+        uint32_t count = w->num_indices - first < w->chunk ? w->num_indices - first : w->chunk;
+
+        uint64_t steps = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t pos = first + i;
+            jobs[i].index = hash_to_index(w->ciphertext, w->reduction_offset,
+                                          w->plaintext_space_total, pos);
+            jobs[i].pos = pos + 1;
+            jobs[i].steps = w->chain_len - 2 - pos;
+            steps += jobs[i].steps;
+        }
+        des_bs_walk(jobs, count, w->reduction_offset);
+        for (uint32_t i = 0; i < count; i++) w->end_indices[first + i] = jobs[i].index;
+
+        uint64_t done = __atomic_add_fetch(&w->done_steps, steps, __ATOMIC_RELAXED);
+        uint32_t tenth = (uint32_t)(done * PRECOMPUTE_PROGRESS_STEPS / w->total_steps);
+        uint32_t seen = __atomic_load_n(&w->reported, __ATOMIC_RELAXED);
+        while (tenth > seen && tenth < PRECOMPUTE_PROGRESS_STEPS) {
+            if (__atomic_compare_exchange_n(&w->reported, &seen, tenth, 0, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                printf("      %u%% (%.0f s)\n", tenth * 100 / PRECOMPUTE_PROGRESS_STEPS,
+                       get_time_sec() - w->start);
+                fflush(stdout);
+                break;
+            }
+        }
+    }
+
+    free(jobs);
+    return NULL;
+}
+
+int cpu_precompute(const uint8_t *ciphertext, uint32_t chain_len, uint32_t reduction_offset,
+                   uint64_t plaintext_space_total, uint64_t *end_indices, int threads) {
+    if (plaintext_space_total != 1ULL << 56 || chain_len < 2) return -1;
+    if (threads < 1) threads = 1;
+
+    precompute_work w = {0};
+    w.ciphertext = ciphertext;
+    w.chain_len = chain_len;
+    w.reduction_offset = reduction_offset;
+    w.plaintext_space_total = plaintext_space_total;
+    w.end_indices = end_indices;
+    w.num_indices = chain_len - 1;
+    w.chunk = des_bs_lanes() * PRECOMPUTE_CHUNK_LANES;
+    w.num_chunks = (w.num_indices + w.chunk - 1) / w.chunk;
+    w.total_steps = (uint64_t)w.num_indices * (w.num_indices - 1) / 2;
+    if (w.total_steps == 0) w.total_steps = 1;
+    if ((uint32_t)threads > w.num_chunks) threads = (int)w.num_chunks;
+
+    printf("      Running on CPU (%d threads, %s)...\n", threads, des_bs_engine());
+    fflush(stdout);
+    w.start = get_time_sec();
+
+    pthread_t *tids = malloc((size_t)threads * sizeof(pthread_t));
+    if (!tids) return -1;
+    int started = 0;
+    for (; started < threads - 1; started++) {
+        if (pthread_create(&tids[started], NULL, precompute_worker, &w) != 0) break;
+    }
+    int failed = precompute_worker(&w) != NULL;
+    for (int i = 0; i < started; i++) {
+        void *ret;
+        pthread_join(tids[i], &ret);
+        failed |= ret != NULL;
+    }
+    free(tids);
+    if (failed) return -1;
+
+    printf("      CPU computation finished in %.1f seconds\n", get_time_sec() - w.start);
+    return (int)w.num_indices;
+}
+
+static int job_cmp_steps(const void *a, const void *b) {
+    const des_bs_job *x = a, *y = b;
+    return (x->steps > y->steps) - (x->steps < y->steps);
+}
+
+static void index_to_key(uint64_t index, uint8_t *key) {
+    for (int i = PLAINTEXT_LEN_MAX - 1; i >= 0; i--) {
+        key[i] = (uint8_t)index;
+        index >>= 8;
+    }
+}
+
+int cpu_check_false_alarms(const uint8_t *target_hash, const uint64_t *start_indices,
+                           const uint32_t *positions, uint32_t num_candidates,
+                           uint32_t reduction_offset, uint64_t plaintext_space_total,
+                           uint8_t *found_key) {
+    if (plaintext_space_total != 1ULL << 56) return -1;
+    if (num_candidates == 0) return 0;
+
+    des_bs_job *jobs = malloc(num_candidates * sizeof(des_bs_job));
+    if (!jobs) return -1;
+    for (uint32_t i = 0; i < num_candidates; i++) {
+        jobs[i].index = start_indices[i];
+        jobs[i].pos = 0;
+        jobs[i].steps = positions[i];
+    }
+    // A key deep in a chain costs as much to confirm as it does to reject,
+    // so cheap candidates go first and the walk stops at the match
+    qsort(jobs, num_candidates, sizeof(des_bs_job), job_cmp_steps);
+
+    size_t batch = (size_t)des_bs_lanes() * FALSE_ALARM_BATCH_LANES;
+    int result = 0;
+    for (size_t first = 0; first < num_candidates && !result; first += batch) {
+        size_t count = num_candidates - first < batch ? num_candidates - first : batch;
+        des_bs_walk(jobs + first, count, reduction_offset);
+
+        // Each walk ends on the key at its position; one more DES tells
+        // whether that key hashes to the target
+        for (size_t i = first; i < first + count; i++) {
+            uint8_t key[PLAINTEXT_LEN_MAX], hash[8];
+            index_to_key(jobs[i].index, key);
+            des_encrypt_ntlmv1(key, hash);
+            if (memcmp(hash, target_hash, 8) == 0) {
+                memcpy(found_key, key, PLAINTEXT_LEN_MAX);
+                result = 1;
+                break;
+            }
+        }
+    }
+
+    free(jobs);
+    return result;
+}
\ No newline at end of file
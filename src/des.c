@@ -1,5 +1,6 @@
 #include "des.h"
 #include <string.h>
+#include <pthread.h>
 
 #define GET_UINT32_BE(n,b,i)                    \
     (n) = ((uint32_t)(b)[(i)] << 24)            \
@@ -266,13 +267,7 @@ static void des_setkey(uint32_t SK[32], const uint8_t key[8]) {
     }
 }
 
-void des_encrypt_ntlmv1(const uint8_t *key_56, uint8_t *output) {
-    uint32_t SK[32];
-    uint32_t X, Y, T;
-    uint32_t *sk_ptr;
-    uint8_t key[8];
-
-    // Expand 7-byte key to 8-byte
+static void des_expand_key(const uint8_t *key_56, uint8_t key[8]) {
     key[0] = (((key_56[0] >> 1) & 0x7f) << 1);
     key[1] = (((key_56[0] & 0x01) << 6 | ((key_56[1] >> 2) & 0x3f)) << 1);
     key[2] = (((key_56[1] & 0x03) << 5 | ((key_56[2] >> 3) & 0x1f)) << 1);
@@ -281,8 +276,58 @@ void des_encrypt_ntlmv1(const uint8_t *key_56, uint8_t *output) {
     key[5] = (((key_56[4] & 0x1f) << 2 | ((key_56[5] >> 6) & 0x03)) << 1);
     key[6] = (((key_56[5] & 0x3f) << 1 | ((key_56[6] >> 7) & 0x01)) << 1);
     key[7] = ((key_56[6] & 0x7f) << 1);
+}
 
-    des_setkey(SK, key);
+// des_setkey only moves key bits around (PC-1, the rotations and PC-2 are
+// all permutations), so the subkeys of a key are the xor of the subkeys of
+// its bytes taken one at a time: subkey_table[i][v] is des_setkey of the
+// key whose byte i is v and all others zero. 7 * 256 rows of 128 bytes.
+static uint32_t subkey_table[7][256][32] __attribute__((aligned(64)));
+static pthread_once_t subkey_table_once = PTHREAD_ONCE_INIT;
+
+static void subkey_table_init(void) {
+    for (int i = 0; i < 7; i++) {
+        for (int v = 0; v < 256; v++) {
+            uint8_t key_56[7] = {0}, key[8];
+            key_56[i] = (uint8_t)v;
+            des_expand_key(key_56, key);
+            des_setkey(subkey_table[i][v], key);
+        }
+    }
+}
+
+void des_subkey_nibble_table(uint32_t table[DES_SUBKEY_NIBBLES][16][32]) {
+    for (int n = 0; n < DES_SUBKEY_NIBBLES; n++) {
+        for (int v = 0; v < 16; v++) {
+            uint8_t key_56[7] = {0}, key[8];
+            key_56[n / 2] = (uint8_t)(n % 2 ? v : v << 4);
+            des_expand_key(key_56, key);
+            des_setkey(table[n][v], key);
+        }
+    }
+}
+
+void des_ip_words(const uint8_t *block, uint32_t *x, uint32_t *y) {
+    uint32_t X, Y, T;
+
+    GET_UINT32_BE(X, block, 0);
+    GET_UINT32_BE(Y, block, 4);
+
+    T = ((X >>  4) ^ Y) & 0x0F0F0F0F; Y ^= T; X ^= (T <<  4);
+    T = ((X >> 16) ^ Y) & 0x0000FFFF; Y ^= T; X ^= (T << 16);
+    T = ((Y >>  2) ^ X) & 0x33333333; X ^= T; Y ^= (T <<  2);
+    T = ((Y >>  8) ^ X) & 0x00FF00FF; X ^= T; Y ^= (T <<  8);
+    Y = (Y << 1) | (Y >> 31);
+    T = (X ^ Y) & 0xAAAAAAAA; Y ^= T; X ^= T;
+    X = (X << 1) | (X >> 31);
+
+    *x = X;
+    *y = Y;
+}
+
+static void des_encrypt_subkeys(const uint32_t SK[32], uint8_t *output) {
+    uint32_t X, Y, T;
+    const uint32_t *sk_ptr;
 
     // Pre-computed IP of challenge 1122334455667788
     X = 0xf0aaf0aa;
@@ -319,4 +364,29 @@ void des_encrypt_ntlmv1(const uint8_t *key_56, uint8_t *output) {
 
     PUT_UINT32_BE(Y, output, 0);
     PUT_UINT32_BE(X, output, 4);
+}
+
+void des_encrypt_ntlmv1(const uint8_t *key_56, uint8_t *output) {
+    typedef uint32_t sk_vec __attribute__((vector_size(16)));
+    sk_vec SK[8];
+
+    pthread_once(&subkey_table_once, subkey_table_init);
+    const sk_vec *row = (const sk_vec *)subkey_table[0][key_56[0]];
+    for (int w = 0; w < 8; w++) SK[w] = row[w];
+    for (int i = 1; i < 7; i++) {
+        row = (const sk_vec *)subkey_table[i][key_56[i]];
+        for (int w = 0; w < 8; w++) SK[w] ^= row[w];
+    }
+
+    des_encrypt_subkeys((const uint32_t *)SK, output);
+}
+
+void des_encrypt_ntlmv1_setkey(const uint8_t *key_56, uint8_t *output) {
+    uint32_t SK[32];
+    uint8_t key[8];
+
+    // Expand 7-byte key to 8-byte
+    des_expand_key(key_56, key);
+    des_setkey(SK, key);
+    des_encrypt_subkeys(SK, output);
 }
\ No newline at end of file
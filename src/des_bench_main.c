@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+#include "des.h"
+#include "des_bs.h"
+#include "rainbow.h"
+
+// Checks the scalar DES with subkey tables and every bitsliced DES engine
+// the CPU supports against the scalar DES with the full key schedule, and
+// reports chain steps (one DES + one reduction) per second for each.
+
+#define DEFAULT_STEPS 2000
+#define VERIFY_JOBS 3000
+#define VERIFY_MAX_STEPS 64
+#define BENCH_BATCHES 8            // engine widths per benchmark run
+
+static const char *engine_names[] = {"avx512", "avx2", "64-bit"};
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t rng_next(void) {
+    uint64_t z = (rng_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+typedef void (*des_fn)(const uint8_t *key_56, uint8_t *output);
+
+// The reference walk, as the kernels do it
+static uint64_t scalar_walk(des_fn des, uint64_t index, uint32_t pos, uint32_t steps,
+                            uint64_t plaintext_space) {
+    uint8_t key[PLAINTEXT_LEN_MAX], hash[8];
+    for (uint32_t s = 0; s < steps; s++) {
+        for (int i = PLAINTEXT_LEN_MAX - 1; i >= 0; i--) {
+            key[i] = (uint8_t)index;
+            index >>= 8;
+        }
+        des(key, hash);
+        index = hash_to_index(hash, REDUCTION_OFFSET, plaintext_space, pos + s);
+    }
+    return index;
+}
+
+int main(int argc, char **argv) {
+    uint32_t steps = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_STEPS;
+    if (steps == 0) {
+        fprintf(stderr, "Usage: %s [steps_per_chain]\n", argv[0]);
+        return 1;
+    }
+    uint64_t space = get_plaintext_space();
+
+    // Random walks of mixed lengths, so lanes are refilled mid-walk
+    des_bs_job *verify = malloc(VERIFY_JOBS * sizeof(des_bs_job));
+    uint64_t *expected = malloc(VERIFY_JOBS * sizeof(uint64_t));
+    des_bs_job *bench = malloc(DES_BS_MAX_LANES * BENCH_BATCHES * sizeof(des_bs_job));
+    if (!verify || !expected || !bench) {
+        fprintf(stderr, "malloc failed\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < VERIFY_JOBS; i++) {
+        verify[i].index = rng_next() % space;
+        verify[i].pos = (uint32_t)(rng_next() % CHAIN_LEN);
+        verify[i].steps = (uint32_t)(rng_next() % VERIFY_MAX_STEPS);
+        expected[i] = scalar_walk(des_encrypt_ntlmv1_setkey, verify[i].index, verify[i].pos,
+                                  verify[i].steps, space);
+    }
+
+    // Key schedule per step vs subkeys from the contribution tables
+    uint32_t scalar_steps = steps * 16;
+    uint64_t start = rng_next() % space;
+    double t0 = get_time_sec();
+    uint64_t sink = scalar_walk(des_encrypt_ntlmv1_setkey, start, 0, scalar_steps, space);
+    double setkey_rate = scalar_steps / (get_time_sec() - t0);
+    printf("%-8s %5s %10.2f Msteps/s  %6.1fx  (%llx)\n", "setkey", "1", setkey_rate / 1e6, 1.0,
+           (unsigned long long)sink);
+
+    int failed = 0;
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < VERIFY_JOBS; i++) {
+        mismatches += scalar_walk(des_encrypt_ntlmv1, verify[i].index, verify[i].pos,
+                                  verify[i].steps, space) != expected[i];
+    }
+    t0 = get_time_sec();
+    mismatches += scalar_walk(des_encrypt_ntlmv1, start, 0, scalar_steps, space) != sink;
+    double scalar_rate = scalar_steps / (get_time_sec() - t0);
+    printf("%-8s %5s %10.2f Msteps/s  %6.1fx  %s\n", "tables", "1", scalar_rate / 1e6,
+           scalar_rate / setkey_rate, mismatches ? "MISMATCH" : "verified");
+    if (mismatches) {
+        fprintf(stderr, "tables: %u walks differ from the key schedule DES\n", mismatches);
+        failed = 1;
+    }
+
+    for (size_t e = 0; e < sizeof(engine_names) / sizeof(engine_names[0]); e++) {
+        if (des_bs_use(engine_names[e]) != 0) {
+            printf("%-8s (not supported by this CPU)\n", engine_names[e]);
+            continue;
+        }
+
+        des_bs_job *jobs = malloc(VERIFY_JOBS * sizeof(des_bs_job));
+        if (!jobs) {
+            fprintf(stderr, "malloc failed\n");
+            return 1;
+        }
+        memcpy(jobs, verify, VERIFY_JOBS * sizeof(des_bs_job));
+        des_bs_walk(jobs, VERIFY_JOBS, REDUCTION_OFFSET);
+        mismatches = 0;
+        for (uint32_t i = 0; i < VERIFY_JOBS; i++) mismatches += jobs[i].index != expected[i];
+        free(jobs);
+
+        uint32_t count = des_bs_lanes() * BENCH_BATCHES;
+        for (uint32_t i = 0; i < count; i++) {
+            bench[i].index = rng_next() % space;
+            bench[i].pos = i;
+            bench[i].steps = steps;
+        }
+        t0 = get_time_sec();
+        des_bs_walk(bench, count, REDUCTION_OFFSET);
+        double rate = (double)count * steps / (get_time_sec() - t0);
+
+        printf("%-8s %5u %10.2f Msteps/s  %6.1fx  %s\n", des_bs_engine(), des_bs_lanes(),
+               rate / 1e6, rate / setkey_rate,
+               mismatches ? "MISMATCH" : "verified");
+        if (mismatches) {
+            fprintf(stderr, "%s: %u of %u walks differ from the key schedule DES\n",
+                    des_bs_engine(), mismatches, VERIFY_JOBS);
+            failed = 1;
+        }
+    }
+
+    free(verify);
+    free(expected);
+    free(bench);
+    return failed;
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include <string.h>
+#include "des_bs.h"
+
+// The AVX2 and AVX-512 engines are built on x86-64 whatever the compiler
+// flags and picked at run time when the CPU has them
+#if defined(__x86_64__)
+#define DES_BS_X86
+#endif
+
+#define DES_BS_COUNTER_BITS 33          // reduction_offset + pos < 2^33
+
+// Fixed challenge 1122334455667788 after IP, slice i = bit i
+#define DES_BS_L0 0xaa1eaa1eU
+#define DES_BS_R0 0x66016601U
+
+// Index bit feeding each round key bit: PC-1, the rotations and PC-2
+// applied to the key bytes index_to_plaintext makes from the index
+static const uint8_t des_bs_ks[16][48] = {
+    {47, 11, 26, 3, 13, 41, 27, 6, 54, 48, 39, 19, 53, 25, 33, 34, 17, 5, 4, 55, 24, 32, 40, 20,
+     36, 31, 21, 8, 23, 52, 14, 29, 51, 9, 35, 30, 2, 37, 22, 0, 42, 38, 16, 43, 44, 1, 7, 28},
+    {54, 18, 33, 10, 20, 48, 34, 13, 4, 55, 46, 26, 3, 32, 40, 41, 24, 12, 11, 5, 6, 39, 47, 27,
+     43, 38, 28, 15, 30, 0, 21, 36, 31, 16, 42, 37, 9, 44, 29, 7, 49, 45, 23, 50, 51, 8, 14, 35},
+    {11, 32, 47, 24, 34, 5, 48, 27, 18, 12, 3, 40, 17, 46, 54, 55, 13, 26, 25, 19, 20, 53, 4, 41,
+     2, 52, 42, 29, 44, 14, 35, 50, 45, 30, 1, 51, 23, 31, 43, 21, 8, 0, 37, 9, 38, 22, 28, 49},
+    {25, 46, 4, 13, 48, 19, 5, 41, 32, 26, 17, 54, 6, 3, 11, 12, 27, 40, 39, 33, 34, 10, 18, 55,
+     16, 7, 1, 43, 31, 28, 49, 9, 0, 44, 15, 38, 37, 45, 2, 35, 22, 14, 51, 23, 52, 36, 42, 8},
+    {39, 3, 18, 27, 5, 33, 19, 55, 46, 40, 6, 11, 20, 17, 25, 26, 41, 54, 53, 47, 48, 24, 32, 12,
+     30, 21, 15, 2, 45, 42, 8, 23, 14, 31, 29, 52, 51, 0, 16, 49, 36, 28, 38, 37, 7, 50, 1, 22},
+    {53, 17, 32, 41, 19, 47, 33, 12, 3, 54, 20, 25, 34, 6, 39, 40, 55, 11, 10, 4, 5, 13, 46, 26,
+     44, 35, 29, 16, 0, 1, 22, 37, 28, 45, 43, 7, 38, 14, 30, 8, 50, 42, 52, 51, 21, 9, 15, 36},
+    {10, 6, 46, 55, 33, 4, 47, 26, 17, 11, 34, 39, 48, 20, 53, 54, 12, 25, 24, 18, 19, 27, 3, 40,
+     31, 49, 43, 30, 14, 15, 36, 51, 42, 0, 2, 21, 52, 28, 44, 22, 9, 1, 7, 38, 35, 23, 29, 50},
+    {24, 20, 3, 12, 47, 18, 4, 40, 6, 25, 48, 53, 5, 34, 10, 11, 26, 39, 13, 32, 33, 41, 17, 54,
+     45, 8, 2, 44, 28, 29, 50, 38, 1, 14, 16, 35, 7, 42, 31, 36, 23, 15, 21, 52, 49, 37, 43, 9},
+    {6, 27, 10, 19, 54, 25, 11, 47, 13, 32, 55, 3, 12, 41, 17, 18, 33, 46, 20, 39, 40, 48, 24, 4,
+     52, 15, 9, 51, 35, 36, 2, 45, 8, 21, 23, 42, 14, 49, 38, 43, 30, 22, 28, 0, 1, 44, 50, 16},
+    {20, 41, 24, 33, 11, 39, 25, 4, 27, 46, 12, 17, 26, 55, 6, 32, 47, 3, 34, 53, 54, 5, 13, 18,
+     7, 29, 23, 38, 49, 50, 16, 0, 22, 35, 37, 1, 28, 8, 52, 2, 44, 36, 42, 14, 15, 31, 9, 30},
+    {34, 55, 13, 47, 25, 53, 39, 18, 41, 3, 26, 6, 40, 12, 20, 46, 4, 17, 48, 10, 11, 19, 27, 32,
+     21, 43, 37, 52, 8, 9, 30, 14, 36, 49, 51, 15, 42, 22, 7, 16, 31, 50, 1, 28, 29, 45, 23, 44},
+    {48, 12, 27, 4, 39, 10, 53, 32, 55, 17, 40, 20, 54, 26, 34, 3, 18, 6, 5, 24, 25, 33, 41, 46,
+     35, 2, 51, 7, 22, 23, 44, 28, 50, 8, 38, 29, 1, 36, 21, 30, 45, 9, 15, 42, 43, 0, 37, 31},
+    {5, 26, 41, 18, 53, 24, 10, 46, 12, 6, 54, 34, 11, 40, 48, 17, 32, 20, 19, 13, 39, 47, 55, 3,
+     49, 16, 38, 21, 36, 37, 31, 42, 9, 22, 52, 43, 15, 50, 35, 44, 0, 23, 29, 1, 2, 14, 51, 45},
+    {19, 40, 55, 32, 10, 13, 24, 3, 26, 20, 11, 48, 25, 54, 5, 6, 46, 34, 33, 27, 53, 4, 12, 17,
+     8, 30, 52, 35, 50, 51, 45, 1, 23, 36, 7, 2, 29, 9, 49, 31, 14, 37, 43, 15, 16, 28, 38, 0},
+    {33, 54, 12, 46, 24, 27, 13, 17, 40, 34, 25, 5, 39, 11, 19, 20, 3, 48, 47, 41, 10, 18, 26, 6,
+     22, 44, 7, 49, 9, 38, 0, 15, 37, 50, 21, 16, 43, 23, 8, 45, 28, 51, 2, 29, 30, 42, 52, 14},
+    {40, 4, 19, 53, 6, 34, 20, 24, 47, 41, 32, 12, 46, 18, 26, 27, 10, 55, 54, 48, 17, 25, 33, 13,
+     29, 51, 14, 1, 16, 45, 7, 22, 44, 2, 28, 23, 50, 30, 15, 52, 35, 31, 9, 36, 37, 49, 0, 21},
+};
+
+typedef uint64_t bs_word;
+
+#define bs_vec bs_word
+#define BS_WORDS 1
+#define BS_NAME(x) x##_64
+#define BS_FN static inline
+#include "des_bs_engine.h"
+#undef bs_vec
+#undef BS_WORDS
+#undef BS_NAME
+#undef BS_FN
+
+#ifdef DES_BS_X86
+typedef uint64_t bs_avx2 __attribute__((vector_size(32)));
+typedef uint64_t bs_avx512 __attribute__((vector_size(64)));
+
+#define bs_vec bs_avx2
+#define BS_WORDS 4
+#define BS_NAME(x) x##_avx2
+#define BS_FN static inline __attribute__((target("avx2")))
+#include "des_bs_engine.h"
+#undef bs_vec
+#undef BS_WORDS
+#undef BS_NAME
+#undef BS_FN
+
+#define bs_vec bs_avx512
+#define BS_WORDS 8
+#define BS_NAME(x) x##_avx512
+#define BS_FN static inline __attribute__((target("avx512f")))
+#include "des_bs_engine.h"
+#undef bs_vec
+#undef BS_WORDS
+#undef BS_NAME
+#undef BS_FN
+#endif
+
+typedef struct {
+    const char *name;
+    uint32_t words;                     // 64-bit words per slice
+    void (*run)(uint64_t *idx, uint64_t *cnt, uint32_t steps);
+} bs_engine;
+
+// Widest first
+static const bs_engine engines[] = {
+#ifdef DES_BS_X86
+    {"avx512", 8, run_avx512},
+    {"avx2", 4, run_avx2},
+#endif
+    {"64-bit", 1, run_64},
+};
+#define NUM_ENGINES (sizeof(engines) / sizeof(engines[0]))
+
+static const bs_engine *engine;
+
+static int engine_supported(const bs_engine *e) {
+#ifdef DES_BS_X86
+    if (strcmp(e->name, "avx512") == 0) return __builtin_cpu_supports("avx512f");
+    if (strcmp(e->name, "avx2") == 0) return __builtin_cpu_supports("avx2");
+#endif
+    (void)e;
+    return 1;
+}
+
+static const bs_engine *current_engine(void) {
+    if (!engine) {
+        for (size_t i = 0; i < NUM_ENGINES && !engine; i++) {
+            if (engine_supported(&engines[i])) engine = &engines[i];
+        }
+    }
+    return engine;
+}
+
+const char *des_bs_engine(void) {
+    return current_engine()->name;
+}
+
+uint32_t des_bs_lanes(void) {
+    return current_engine()->words * 64;
+}
+
+int des_bs_use(const char *name) {
+    for (size_t i = 0; i < NUM_ENGINES; i++) {
+        if (strcmp(engines[i].name, name) == 0 && engine_supported(&engines[i])) {
+            engine = &engines[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Moves a value into / out of one lane of bits slices of words words
+static void lane_put(uint64_t *slices, uint32_t words, uint32_t bits, uint32_t lane,
+                     uint64_t value) {
+    uint64_t *w = slices + lane / 64;
+    uint64_t mask = 1ULL << (lane % 64);
+    for (uint32_t b = 0; b < bits; b++, w += words) {
+        *w = (value >> b) & 1 ? *w | mask : *w & ~mask;
+    }
+}
+
+static uint64_t lane_get(const uint64_t *slices, uint32_t words, uint32_t bits, uint32_t lane) {
+    const uint64_t *w = slices + lane / 64;
+    uint64_t value = 0;
+    for (uint32_t b = 0; b < bits; b++, w += words) {
+        value |= ((*w >> (lane % 64)) & 1) << b;
+    }
+    return value;
+}
+
+// Lanes run in lockstep for as many steps as the closest one to done
+// still needs; finished lanes are read out and refilled from the queue,
+// idle ones run along and are ignored
+void des_bs_walk(des_bs_job *jobs, size_t count, uint32_t reduction_offset) {
+    const bs_engine *e = current_engine();
+    uint32_t lanes = e->words * 64;
+    uint64_t idx[56 * DES_BS_MAX_LANES / 64] __attribute__((aligned(64)));
+    uint64_t cnt[DES_BS_COUNTER_BITS * DES_BS_MAX_LANES / 64] __attribute__((aligned(64)));
+    size_t lane_job[DES_BS_MAX_LANES];
+    uint32_t remaining[DES_BS_MAX_LANES];
+    memset(idx, 0, sizeof(idx));
+    memset(cnt, 0, sizeof(cnt));
+
+    size_t next = 0;
+    uint32_t active = 0;
+    for (uint32_t i = 0; i < lanes; i++) remaining[i] = 0;
+
+    for (;;) {
+        for (uint32_t i = 0; i < lanes && next < count; i++) {
+            if (remaining[i] != 0) continue;
+            while (next < count && jobs[next].steps == 0) next++;
+            if (next == count) break;
+            des_bs_job *job = &jobs[next];
+            lane_put(idx, e->words, 56, i, job->index);
+            lane_put(cnt, e->words, DES_BS_COUNTER_BITS, i,
+                     (uint64_t)reduction_offset + job->pos);
+            lane_job[i] = next++;
+            remaining[i] = job->steps;
+            active++;
+        }
+        if (active == 0) break;
+
+        uint32_t steps = UINT32_MAX;
+        for (uint32_t i = 0; i < lanes; i++) {
+            if (remaining[i] != 0 && remaining[i] < steps) steps = remaining[i];
+        }
+        e->run(idx, cnt, steps);
+
+        for (uint32_t i = 0; i < lanes; i++) {
+            if (remaining[i] == 0) continue;
+            remaining[i] -= steps;
+            if (remaining[i] == 0) {
+                jobs[lane_job[i]].index = lane_get(idx, e->words, 56, i);
+                active--;
+            }
+        }
+    }
+}
\ No newline at end of file
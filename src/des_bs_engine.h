@@ -0,0 +1,914 @@
+// One bitsliced DES engine, included by des_bs.c once per vector width
+// with these defined:
+//   bs_vec       the vector type (one bit of 64 * BS_WORDS chains)
+//   BS_WORDS     64-bit words per bs_vec
+//   BS_NAME(x)   x with the engine's suffix
+//   BS_FN        storage class and target attributes
+//
+// The S-box circuits below were derived from the S-box tables by Shannon
+// decomposition with the variable order searched per S-box and gates
+// shared between the four outputs; des_bench checks every engine against
+// the table-driven DES. Each call xors its outputs straight into the P
+// permuted slices of the left half.
+
+// S1: 108 gates
+BS_FN void BS_NAME(s1)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = ~a5;
+    bs_vec x1 = x0 ^ a2;
+    bs_vec x2 = x1 ^ a5;
+    bs_vec x3 = x2 & a3;
+    bs_vec x4 = x1 ^ x3;
+    bs_vec x5 = a5 & a3;
+    bs_vec x6 = x1 ^ x5;
+    bs_vec x7 = x4 ^ x6;
+    bs_vec x8 = x7 & a4;
+    bs_vec x9 = x4 ^ x8;
+    bs_vec x10 = ~x4;
+    bs_vec x11 = x0 & a3;
+    bs_vec x12 = a2 ^ x11;
+    bs_vec x13 = x10 ^ x12;
+    bs_vec x14 = x13 & a4;
+    bs_vec x15 = x10 ^ x14;
+    bs_vec x16 = x9 ^ x15;
+    bs_vec x17 = x16 & a6;
+    bs_vec x18 = x9 ^ x17;
+    bs_vec x19 = ~(a2 & ~x0);
+    bs_vec x20 = x19 ^ x11;
+    bs_vec x21 = x12 ^ x20;
+    bs_vec x22 = x21 & a4;
+    bs_vec x23 = x12 ^ x22;
+    bs_vec x24 = ~x1;
+    bs_vec x25 = x21 ^ x24;
+    bs_vec x26 = x25 & a3;
+    bs_vec x27 = x21 ^ x26;
+    bs_vec x28 = ~x19;
+    bs_vec x29 = x1 ^ x28;
+    bs_vec x30 = x29 & a3;
+    bs_vec x31 = x1 ^ x30;
+    bs_vec x32 = x27 ^ x31;
+    bs_vec x33 = x32 & a4;
+    bs_vec x34 = x27 ^ x33;
+    bs_vec x35 = x23 ^ x34;
+    bs_vec x36 = x35 & a6;
+    bs_vec x37 = x23 ^ x36;
+    bs_vec x38 = x18 ^ x37;
+    bs_vec x39 = x38 & a1;
+    bs_vec x40 = x18 ^ x39;
+    bs_vec x41 = ~x12;
+    bs_vec x42 = x25 ^ x11;
+    bs_vec x43 = x41 ^ x42;
+    bs_vec x44 = x43 & a4;
+    bs_vec x45 = x41 ^ x44;
+    bs_vec x46 = a5 ^ x3;
+    bs_vec x47 = x24 & a3;
+    bs_vec x48 = x19 ^ x47;
+    bs_vec x49 = x42 & a4;
+    bs_vec x50 = x46 ^ x49;
+    bs_vec x51 = x45 ^ x50;
+    bs_vec x52 = x51 & a6;
+    bs_vec x53 = x45 ^ x52;
+    bs_vec x54 = x43 & a3;
+    bs_vec x55 = x25 ^ x54;
+    bs_vec x56 = ~x21;
+    bs_vec x57 = x1 ^ x26;
+    bs_vec x58 = x55 ^ x57;
+    bs_vec x59 = x58 & a4;
+    bs_vec x60 = x55 ^ x59;
+    bs_vec x61 = x48 ^ a4;
+    bs_vec x62 = x60 ^ x61;
+    bs_vec x63 = x62 & a6;
+    bs_vec x64 = x60 ^ x63;
+    bs_vec x65 = x53 ^ x64;
+    bs_vec x66 = x65 & a1;
+    bs_vec x67 = x53 ^ x66;
+    bs_vec x68 = x4 & a4;
+    bs_vec x69 = x55 ^ x68;
+    bs_vec x70 = x43 ^ x26;
+    bs_vec x71 = x19 & a4;
+    bs_vec x72 = x70 ^ x71;
+    bs_vec x73 = x69 ^ x72;
+    bs_vec x74 = x73 & a6;
+    bs_vec x75 = x69 ^ x74;
+    bs_vec x76 = x56 ^ x5;
+    bs_vec x77 = x25 & a4;
+    bs_vec x78 = x76 ^ x77;
+    bs_vec x79 = x20 & a4;
+    bs_vec x80 = x57 ^ x79;
+    bs_vec x81 = x78 ^ x80;
+    bs_vec x82 = x81 & a6;
+    bs_vec x83 = x78 ^ x82;
+    bs_vec x84 = x75 ^ x83;
+    bs_vec x85 = x84 & a1;
+    bs_vec x86 = x75 ^ x85;
+    bs_vec x87 = x2 ^ x5;
+    bs_vec x88 = x76 ^ x71;
+    bs_vec x89 = ~x55;
+    bs_vec x90 = x89 ^ x22;
+    bs_vec x91 = x88 ^ x90;
+    bs_vec x92 = x91 & a6;
+    bs_vec x93 = x88 ^ x92;
+    bs_vec x94 = ~x87;
+    bs_vec x95 = x10 ^ x94;
+    bs_vec x96 = x95 & a4;
+    bs_vec x97 = x10 ^ x96;
+    bs_vec x98 = x25 ^ a3;
+    bs_vec x99 = x1 & a4;
+    bs_vec x100 = x98 ^ x99;
+    bs_vec x101 = x97 ^ x100;
+    bs_vec x102 = x101 & a6;
+    bs_vec x103 = x97 ^ x102;
+    bs_vec x104 = x93 ^ x103;
+    bs_vec x105 = x104 & a1;
+    bs_vec x106 = x93 ^ x105;
+    l[8] ^= x40;
+    l[16] ^= x67;
+    l[22] ^= x86;
+    l[30] ^= x106;
+}
+
+// S2: 96 gates
+BS_FN void BS_NAME(s2)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = ~a4;
+    bs_vec x1 = x0 ^ a3;
+    bs_vec x2 = a4 ^ a2;
+    bs_vec x3 = x1 ^ x2;
+    bs_vec x4 = x3 & a1;
+    bs_vec x5 = x1 ^ x4;
+    bs_vec x6 = ~x2;
+    bs_vec x7 = x0 | a2;
+    bs_vec x8 = x0 & ~a2;
+    bs_vec x9 = a2 & a3;
+    bs_vec x10 = x7 ^ x9;
+    bs_vec x11 = x6 ^ x10;
+    bs_vec x12 = x11 & a1;
+    bs_vec x13 = x6 ^ x12;
+    bs_vec x14 = x5 ^ x13;
+    bs_vec x15 = x14 & a6;
+    bs_vec x16 = x5 ^ x15;
+    bs_vec x17 = x10 ^ a1;
+    bs_vec x18 = x8 & a1;
+    bs_vec x19 = x3 ^ x18;
+    bs_vec x20 = x17 ^ x19;
+    bs_vec x21 = x20 & a6;
+    bs_vec x22 = x17 ^ x21;
+    bs_vec x23 = x16 ^ x22;
+    bs_vec x24 = x23 & a5;
+    bs_vec x25 = x16 ^ x24;
+    bs_vec x26 = ~a3;
+    bs_vec x27 = x26 ^ x0;
+    bs_vec x28 = x27 & a2;
+    bs_vec x29 = x26 ^ x28;
+    bs_vec x30 = x0 & a2;
+    bs_vec x31 = a3 ^ x30;
+    bs_vec x32 = x29 ^ x31;
+    bs_vec x33 = x32 & a6;
+    bs_vec x34 = x29 ^ x33;
+    bs_vec x35 = x1 ^ a2;
+    bs_vec x36 = x7 & a5;
+    bs_vec x37 = x34 ^ x36;
+    bs_vec x38 = a4 & a2;
+    bs_vec x39 = a3 ^ x38;
+    bs_vec x40 = x39 ^ a6;
+    bs_vec x41 = ~x39;
+    bs_vec x42 = x41 ^ x6;
+    bs_vec x43 = x42 & a6;
+    bs_vec x44 = x41 ^ x43;
+    bs_vec x45 = x40 ^ x44;
+    bs_vec x46 = x45 & a5;
+    bs_vec x47 = x40 ^ x46;
+    bs_vec x48 = x37 ^ x47;
+    bs_vec x49 = x48 & a1;
+    bs_vec x50 = x37 ^ x49;
+    bs_vec x51 = x0 ^ x11;
+    bs_vec x52 = x51 ^ a1;
+    bs_vec x53 = x26 & a2;
+    bs_vec x54 = x41 & a6;
+    bs_vec x55 = x52 ^ x54;
+    bs_vec x56 = ~x51;
+    bs_vec x57 = x56 ^ x6;
+    bs_vec x58 = x57 & a1;
+    bs_vec x59 = x56 ^ x58;
+    bs_vec x60 = x26 | a4;
+    bs_vec x61 = x60 ^ x53;
+    bs_vec x62 = x61 ^ a1;
+    bs_vec x63 = x59 ^ x62;
+    bs_vec x64 = x63 & a6;
+    bs_vec x65 = x59 ^ x64;
+    bs_vec x66 = x55 ^ x65;
+    bs_vec x67 = x66 & a5;
+    bs_vec x68 = x55 ^ x67;
+    bs_vec x69 = x0 | a3;
+    bs_vec x70 = x69 ^ a2;
+    bs_vec x71 = x70 ^ x51;
+    bs_vec x72 = x71 & a6;
+    bs_vec x73 = x70 ^ x72;
+    bs_vec x74 = ~x35;
+    bs_vec x75 = a4 | a3;
+    bs_vec x76 = x75 ^ x9;
+    bs_vec x77 = x74 ^ x76;
+    bs_vec x78 = x77 & a6;
+    bs_vec x79 = x74 ^ x78;
+    bs_vec x80 = x73 ^ x79;
+    bs_vec x81 = x80 & a5;
+    bs_vec x82 = x73 ^ x81;
+    bs_vec x83 = x75 & a2;
+    bs_vec x84 = x27 ^ x83;
+    bs_vec x85 = x69 & a2;
+    bs_vec x86 = x53 & a6;
+    bs_vec x87 = x84 ^ x86;
+    bs_vec x88 = x26 ^ x85;
+    bs_vec x89 = x88 ^ a6;
+    bs_vec x90 = x87 ^ x89;
+    bs_vec x91 = x90 & a5;
+    bs_vec x92 = x87 ^ x91;
+    bs_vec x93 = x82 ^ x92;
+    bs_vec x94 = x93 & a1;
+    bs_vec x95 = x82 ^ x94;
+    l[12] ^= x50;
+    l[27] ^= x68;
+    l[1] ^= x95;
+    l[17] ^= x25;
+}
+
+// S3: 94 gates
+BS_FN void BS_NAME(s3)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = ~a5;
+    bs_vec x1 = x0 ^ a2;
+    bs_vec x2 = x0 | a6;
+    bs_vec x3 = x2 & a2;
+    bs_vec x4 = x1 ^ x3;
+    bs_vec x5 = x4 & a3;
+    bs_vec x6 = x1 ^ x5;
+    bs_vec x7 = ~(a6 & ~a5);
+    bs_vec x8 = x0 ^ a6;
+    bs_vec x9 = x7 ^ x8;
+    bs_vec x10 = x9 & a2;
+    bs_vec x11 = x7 ^ x10;
+    bs_vec x12 = x8 ^ a2;
+    bs_vec x13 = x11 ^ x12;
+    bs_vec x14 = x13 & a3;
+    bs_vec x15 = x11 ^ x14;
+    bs_vec x16 = x6 ^ x15;
+    bs_vec x17 = x16 & a4;
+    bs_vec x18 = x6 ^ x17;
+    bs_vec x19 = ~x8;
+    bs_vec x20 = x8 ^ x14;
+    bs_vec x21 = x20 ^ a4;
+    bs_vec x22 = x18 ^ x21;
+    bs_vec x23 = x22 & a1;
+    bs_vec x24 = x18 ^ x23;
+    bs_vec x25 = x0 & a4;
+    bs_vec x26 = a6 ^ x25;
+    bs_vec x27 = ~a6;
+    bs_vec x28 = a5 & a3;
+    bs_vec x29 = x26 ^ x28;
+    bs_vec x30 = x29 ^ a2;
+    bs_vec x31 = x27 & a4;
+    bs_vec x32 = x0 ^ x31;
+    bs_vec x33 = x32 ^ a3;
+    bs_vec x34 = a6 & a5;
+    bs_vec x35 = x7 ^ x31;
+    bs_vec x36 = x2 ^ a4;
+    bs_vec x37 = x35 ^ x36;
+    bs_vec x38 = x37 & a3;
+    bs_vec x39 = x35 ^ x38;
+    bs_vec x40 = x33 ^ x39;
+    bs_vec x41 = x40 & a2;
+    bs_vec x42 = x33 ^ x41;
+    bs_vec x43 = x30 ^ x42;
+    bs_vec x44 = x43 & a1;
+    bs_vec x45 = x30 ^ x44;
+    bs_vec x46 = a6 ^ x9;
+    bs_vec x47 = x46 & a2;
+    bs_vec x48 = a6 ^ x47;
+    bs_vec x49 = x48 ^ x13;
+    bs_vec x50 = x49 & a4;
+    bs_vec x51 = x48 ^ x50;
+    bs_vec x52 = x27 ^ a2;
+    bs_vec x53 = x27 & a2;
+    bs_vec x54 = x0 ^ x53;
+    bs_vec x55 = x52 ^ x54;
+    bs_vec x56 = x55 & a4;
+    bs_vec x57 = x52 ^ x56;
+    bs_vec x58 = x51 ^ x57;
+    bs_vec x59 = x58 & a1;
+    bs_vec x60 = x51 ^ x59;
+    bs_vec x61 = ~x34;
+    bs_vec x62 = x61 ^ x53;
+    bs_vec x63 = x12 ^ x62;
+    bs_vec x64 = x63 & a4;
+    bs_vec x65 = x12 ^ x64;
+    bs_vec x66 = x65 ^ a1;
+    bs_vec x67 = x60 ^ x66;
+    bs_vec x68 = x67 & a3;
+    bs_vec x69 = x60 ^ x68;
+    bs_vec x70 = x8 ^ x3;
+    bs_vec x71 = x49 & a3;
+    bs_vec x72 = x70 ^ x71;
+    bs_vec x73 = x34 & a2;
+    bs_vec x74 = x9 ^ x73;
+    bs_vec x75 = x74 ^ a3;
+    bs_vec x76 = x72 ^ x75;
+    bs_vec x77 = x76 & a4;
+    bs_vec x78 = x72 ^ x77;
+    bs_vec x79 = ~x54;
+    bs_vec x80 = x79 ^ x19;
+    bs_vec x81 = x80 & a3;
+    bs_vec x82 = x79 ^ x81;
+    bs_vec x83 = x8 ^ x47;
+    bs_vec x84 = x3 ^ x83;
+    bs_vec x85 = x84 & a3;
+    bs_vec x86 = x3 ^ x85;
+    bs_vec x87 = x82 ^ x86;
+    bs_vec x88 = x87 & a4;
+    bs_vec x89 = x82 ^ x88;
+    bs_vec x90 = x78 ^ x89;
+    bs_vec x91 = x90 & a1;
+    bs_vec x92 = x78 ^ x91;
+    l[23] ^= x24;
+    l[15] ^= x69;
+    l[29] ^= x92;
+    l[5] ^= x45;
+}
+
+// S4: 72 gates
+BS_FN void BS_NAME(s4)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = ~a4;
+    bs_vec x1 = x0 ^ a3;
+    bs_vec x2 = a4 ^ x1;
+    bs_vec x3 = x2 & a5;
+    bs_vec x4 = a4 ^ x3;
+    bs_vec x5 = ~x1;
+    bs_vec x6 = a4 & a5;
+    bs_vec x7 = x5 ^ x6;
+    bs_vec x8 = x4 ^ x7;
+    bs_vec x9 = x8 & a2;
+    bs_vec x10 = x4 ^ x9;
+    bs_vec x11 = ~(a3 & ~x0);
+    bs_vec x12 = x11 ^ a3;
+    bs_vec x13 = x12 & a5;
+    bs_vec x14 = x11 ^ x13;
+    bs_vec x15 = x1 ^ x13;
+    bs_vec x16 = x14 ^ x15;
+    bs_vec x17 = x16 & a2;
+    bs_vec x18 = x14 ^ x17;
+    bs_vec x19 = x10 ^ x18;
+    bs_vec x20 = x19 & a1;
+    bs_vec x21 = x10 ^ x20;
+    bs_vec x22 = x5 & a5;
+    bs_vec x23 = x2 ^ x22;
+    bs_vec x24 = x12 & a2;
+    bs_vec x25 = x23 ^ x24;
+    bs_vec x26 = x0 & a5;
+    bs_vec x27 = a3 ^ x26;
+    bs_vec x28 = x0 ^ a5;
+    bs_vec x29 = x27 ^ x28;
+    bs_vec x30 = x29 & a2;
+    bs_vec x31 = x27 ^ x30;
+    bs_vec x32 = x25 ^ x31;
+    bs_vec x33 = x32 & a1;
+    bs_vec x34 = x25 ^ x33;
+    bs_vec x35 = x21 ^ x34;
+    bs_vec x36 = x35 & a6;
+    bs_vec x37 = x21 ^ x36;
+    bs_vec x38 = ~x21;
+    bs_vec x39 = x34 ^ x38;
+    bs_vec x40 = x39 & a6;
+    bs_vec x41 = x34 ^ x40;
+    bs_vec x42 = x2 ^ x16;
+    bs_vec x43 = x42 & a5;
+    bs_vec x44 = x2 ^ x43;
+    bs_vec x45 = x11 & a2;
+    bs_vec x46 = x44 ^ x45;
+    bs_vec x47 = a3 & a5;
+    bs_vec x48 = x1 ^ x47;
+    bs_vec x49 = ~x27;
+    bs_vec x50 = x48 ^ x49;
+    bs_vec x51 = x50 & a2;
+    bs_vec x52 = x48 ^ x51;
+    bs_vec x53 = x46 ^ x52;
+    bs_vec x54 = x53 & a1;
+    bs_vec x55 = x46 ^ x54;
+    bs_vec x56 = x27 & a2;
+    bs_vec x57 = x7 ^ x56;
+    bs_vec x58 = x0 ^ x22;
+    bs_vec x59 = x42 & a2;
+    bs_vec x60 = x58 ^ x59;
+    bs_vec x61 = x57 ^ x60;
+    bs_vec x62 = x61 & a1;
+    bs_vec x63 = x57 ^ x62;
+    bs_vec x64 = x55 ^ x63;
+    bs_vec x65 = x64 & a6;
+    bs_vec x66 = x55 ^ x65;
+    bs_vec x67 = ~x63;
+    bs_vec x68 = x67 ^ x55;
+    bs_vec x69 = x68 & a6;
+    bs_vec x70 = x67 ^ x69;
+    l[25] ^= x37;
+    l[19] ^= x41;
+    l[9] ^= x66;
+    l[0] ^= x70;
+}
+
+// S5: 110 gates
+BS_FN void BS_NAME(s5)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = a5 ^ a2;
+    bs_vec x1 = a5 & a1;
+    bs_vec x2 = x0 ^ x1;
+    bs_vec x3 = ~a2;
+    bs_vec x4 = x0 ^ x3;
+    bs_vec x5 = x4 & a1;
+    bs_vec x6 = x0 ^ x5;
+    bs_vec x7 = a1 & a3;
+    bs_vec x8 = x2 ^ x7;
+    bs_vec x9 = ~(a2 & ~a5);
+    bs_vec x10 = x3 ^ x9;
+    bs_vec x11 = x10 & a1;
+    bs_vec x12 = x3 ^ x11;
+    bs_vec x13 = x10 ^ x0;
+    bs_vec x14 = x13 & a1;
+    bs_vec x15 = x10 ^ x14;
+    bs_vec x16 = x12 ^ x15;
+    bs_vec x17 = x16 & a3;
+    bs_vec x18 = x12 ^ x17;
+    bs_vec x19 = x8 ^ x18;
+    bs_vec x20 = x19 & a6;
+    bs_vec x21 = x8 ^ x20;
+    bs_vec x22 = x4 | a2;
+    bs_vec x23 = x22 ^ a5;
+    bs_vec x24 = x23 & a1;
+    bs_vec x25 = x22 ^ x24;
+    bs_vec x26 = x15 ^ x25;
+    bs_vec x27 = x26 & a3;
+    bs_vec x28 = x15 ^ x27;
+    bs_vec x29 = ~x0;
+    bs_vec x30 = x13 ^ x24;
+    bs_vec x31 = x9 & a3;
+    bs_vec x32 = x30 ^ x31;
+    bs_vec x33 = x28 ^ x32;
+    bs_vec x34 = x33 & a6;
+    bs_vec x35 = x28 ^ x34;
+    bs_vec x36 = x21 ^ x35;
+    bs_vec x37 = x36 & a4;
+    bs_vec x38 = x21 ^ x37;
+    bs_vec x39 = a5 ^ a1;
+    bs_vec x40 = x3 & a1;
+    bs_vec x41 = x4 ^ x40;
+    bs_vec x42 = x39 ^ x41;
+    bs_vec x43 = x42 & a3;
+    bs_vec x44 = x39 ^ x43;
+    bs_vec x45 = x0 & a3;
+    bs_vec x46 = x26 ^ x45;
+    bs_vec x47 = x44 ^ x46;
+    bs_vec x48 = x47 & a6;
+    bs_vec x49 = x44 ^ x48;
+    bs_vec x50 = ~x6;
+    bs_vec x51 = x0 ^ a1;
+    bs_vec x52 = x50 ^ x51;
+    bs_vec x53 = x52 & a3;
+    bs_vec x54 = x50 ^ x53;
+    bs_vec x55 = x54 ^ a6;
+    bs_vec x56 = x49 ^ x55;
+    bs_vec x57 = x56 & a4;
+    bs_vec x58 = x49 ^ x57;
+    bs_vec x59 = ~x30;
+    bs_vec x60 = x3 ^ x14;
+    bs_vec x61 = x59 ^ x60;
+    bs_vec x62 = x61 & a3;
+    bs_vec x63 = x59 ^ x62;
+    bs_vec x64 = x60 ^ x0;
+    bs_vec x65 = x64 & a3;
+    bs_vec x66 = x60 ^ x65;
+    bs_vec x67 = x63 ^ x66;
+    bs_vec x68 = x67 & a6;
+    bs_vec x69 = x63 ^ x68;
+    bs_vec x70 = ~x60;
+    bs_vec x71 = x70 ^ x31;
+    bs_vec x72 = x22 ^ a1;
+    bs_vec x73 = x72 ^ x65;
+    bs_vec x74 = x71 ^ x73;
+    bs_vec x75 = x74 & a6;
+    bs_vec x76 = x71 ^ x75;
+    bs_vec x77 = x69 ^ x76;
+    bs_vec x78 = x77 & a4;
+    bs_vec x79 = x69 ^ x78;
+    bs_vec x80 = x10 ^ a2;
+    bs_vec x81 = x80 & a1;
+    bs_vec x82 = x10 ^ x81;
+    bs_vec x83 = ~x39;
+    bs_vec x84 = x82 ^ x83;
+    bs_vec x85 = x84 & a3;
+    bs_vec x86 = x82 ^ x85;
+    bs_vec x87 = x10 & a3;
+    bs_vec x88 = x51 ^ x87;
+    bs_vec x89 = x86 ^ x88;
+    bs_vec x90 = x89 & a6;
+    bs_vec x91 = x86 ^ x90;
+    bs_vec x92 = x13 ^ x5;
+    bs_vec x93 = x29 ^ x11;
+    bs_vec x94 = x92 ^ x93;
+    bs_vec x95 = x94 & a3;
+    bs_vec x96 = x92 ^ x95;
+    bs_vec x97 = x80 ^ x14;
+    bs_vec x98 = x22 & a1;
+    bs_vec x99 = x3 ^ x98;
+    bs_vec x100 = x97 ^ x99;
+    bs_vec x101 = x100 & a3;
+    bs_vec x102 = x97 ^ x101;
+    bs_vec x103 = x96 ^ x102;
+    bs_vec x104 = x103 & a6;
+    bs_vec x105 = x96 ^ x104;
+    bs_vec x106 = x91 ^ x105;
+    bs_vec x107 = x106 & a4;
+    bs_vec x108 = x91 ^ x107;
+    l[7] ^= x38;
+    l[13] ^= x58;
+    l[24] ^= x79;
+    l[2] ^= x108;
+}
+
+// S6: 97 gates
+BS_FN void BS_NAME(s6)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = ~a5;
+    bs_vec x1 = x0 ^ a2;
+    bs_vec x2 = x1 ^ a6;
+    bs_vec x3 = x0 & a3;
+    bs_vec x4 = x2 ^ x3;
+    bs_vec x5 = x0 | a2;
+    bs_vec x6 = a5 ^ x5;
+    bs_vec x7 = x6 & a6;
+    bs_vec x8 = a5 ^ x7;
+    bs_vec x9 = x8 ^ a3;
+    bs_vec x10 = x4 ^ x9;
+    bs_vec x11 = x10 & a4;
+    bs_vec x12 = x4 ^ x11;
+    bs_vec x13 = ~x2;
+    bs_vec x14 = ~x6;
+    bs_vec x15 = ~x1;
+    bs_vec x16 = x14 ^ x15;
+    bs_vec x17 = x16 & a6;
+    bs_vec x18 = x14 ^ x17;
+    bs_vec x19 = x13 ^ x18;
+    bs_vec x20 = x19 & a3;
+    bs_vec x21 = x13 ^ x20;
+    bs_vec x22 = x5 & a6;
+    bs_vec x23 = x6 ^ x22;
+    bs_vec x24 = x23 ^ x1;
+    bs_vec x25 = x24 & a3;
+    bs_vec x26 = x23 ^ x25;
+    bs_vec x27 = x21 ^ x26;
+    bs_vec x28 = x27 & a4;
+    bs_vec x29 = x21 ^ x28;
+    bs_vec x30 = x12 ^ x29;
+    bs_vec x31 = x30 & a1;
+    bs_vec x32 = x12 ^ x31;
+    bs_vec x33 = a2 & a3;
+    bs_vec x34 = x1 ^ x33;
+    bs_vec x35 = ~a2;
+    bs_vec x36 = x1 & a3;
+    bs_vec x37 = x35 ^ x36;
+    bs_vec x38 = x34 ^ x37;
+    bs_vec x39 = x38 & a4;
+    bs_vec x40 = x34 ^ x39;
+    bs_vec x41 = x38 & a1;
+    bs_vec x42 = x40 ^ x41;
+    bs_vec x43 = a2 ^ x3;
+    bs_vec x44 = x37 ^ x43;
+    bs_vec x45 = x44 & a4;
+    bs_vec x46 = x37 ^ x45;
+    bs_vec x47 = x5 & a3;
+    bs_vec x48 = a2 ^ x47;
+    bs_vec x49 = x16 & a4;
+    bs_vec x50 = x48 ^ x49;
+    bs_vec x51 = x46 ^ x50;
+    bs_vec x52 = x51 & a1;
+    bs_vec x53 = x46 ^ x52;
+    bs_vec x54 = x42 ^ x53;
+    bs_vec x55 = x54 & a6;
+    bs_vec x56 = x42 ^ x55;
+    bs_vec x57 = x7 ^ x23;
+    bs_vec x58 = x57 & a4;
+    bs_vec x59 = x7 ^ x58;
+    bs_vec x60 = x0 & a2;
+    bs_vec x61 = x16 & a3;
+    bs_vec x62 = x59 ^ x61;
+    bs_vec x63 = x14 & a6;
+    bs_vec x64 = x15 ^ x63;
+    bs_vec x65 = x64 ^ x1;
+    bs_vec x66 = x65 & a4;
+    bs_vec x67 = x64 ^ x66;
+    bs_vec x68 = x23 & a3;
+    bs_vec x69 = x67 ^ x68;
+    bs_vec x70 = x62 ^ x69;
+    bs_vec x71 = x70 & a1;
+    bs_vec x72 = x62 ^ x71;
+    bs_vec x73 = x35 & a3;
+    bs_vec x74 = a5 ^ x73;
+    bs_vec x75 = a5 & a3;
+    bs_vec x76 = x15 ^ x75;
+    bs_vec x77 = x60 ^ x73;
+    bs_vec x78 = x76 ^ x77;
+    bs_vec x79 = x78 & a6;
+    bs_vec x80 = x76 ^ x79;
+    bs_vec x81 = x74 ^ x80;
+    bs_vec x82 = x81 & a4;
+    bs_vec x83 = x74 ^ x82;
+    bs_vec x84 = x0 ^ x36;
+    bs_vec x85 = x15 ^ x3;
+    bs_vec x86 = x84 ^ x85;
+    bs_vec x87 = x86 & a6;
+    bs_vec x88 = x84 ^ x87;
+    bs_vec x89 = ~x43;
+    bs_vec x90 = x89 ^ a6;
+    bs_vec x91 = x88 ^ x90;
+    bs_vec x92 = x91 & a4;
+    bs_vec x93 = x88 ^ x92;
+    bs_vec x94 = x83 ^ x93;
+    bs_vec x95 = x94 & a1;
+    bs_vec x96 = x83 ^ x95;
+    l[3] ^= x56;
+    l[28] ^= x32;
+    l[10] ^= x72;
+    l[18] ^= x96;
+}
+
+// S7: 99 gates
+BS_FN void BS_NAME(s7)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = a2 ^ a5;
+    bs_vec x1 = a2 & a4;
+    bs_vec x2 = a5 ^ x1;
+    bs_vec x3 = ~x0;
+    bs_vec x4 = ~a2;
+    bs_vec x5 = a5 & a4;
+    bs_vec x6 = x3 ^ x5;
+    bs_vec x7 = x2 ^ x6;
+    bs_vec x8 = x7 & a3;
+    bs_vec x9 = x2 ^ x8;
+    bs_vec x10 = x4 | a5;
+    bs_vec x11 = a2 ^ x10;
+    bs_vec x12 = x11 & a4;
+    bs_vec x13 = a2 ^ x12;
+    bs_vec x14 = x4 & ~a5;
+    bs_vec x15 = x14 ^ x12;
+    bs_vec x16 = x13 ^ x15;
+    bs_vec x17 = x16 & a3;
+    bs_vec x18 = x13 ^ x17;
+    bs_vec x19 = x9 ^ x18;
+    bs_vec x20 = x19 & a1;
+    bs_vec x21 = x9 ^ x20;
+    bs_vec x22 = ~x2;
+    bs_vec x23 = x22 ^ a3;
+    bs_vec x24 = x16 & a4;
+    bs_vec x25 = x0 ^ x24;
+    bs_vec x26 = ~x10;
+    bs_vec x27 = x26 ^ x24;
+    bs_vec x28 = x25 ^ x27;
+    bs_vec x29 = x28 & a3;
+    bs_vec x30 = x25 ^ x29;
+    bs_vec x31 = x23 ^ x30;
+    bs_vec x32 = x31 & a1;
+    bs_vec x33 = x23 ^ x32;
+    bs_vec x34 = x21 ^ x33;
+    bs_vec x35 = x34 & a6;
+    bs_vec x36 = x21 ^ x35;
+    bs_vec x37 = x4 & a4;
+    bs_vec x38 = x3 ^ x37;
+    bs_vec x39 = ~a5;
+    bs_vec x40 = a2 & a3;
+    bs_vec x41 = x38 ^ x40;
+    bs_vec x42 = x41 ^ x9;
+    bs_vec x43 = x42 & a1;
+    bs_vec x44 = x41 ^ x43;
+    bs_vec x45 = ~x14;
+    bs_vec x46 = x10 & a4;
+    bs_vec x47 = x39 ^ x46;
+    bs_vec x48 = x14 & a4;
+    bs_vec x49 = x3 ^ x48;
+    bs_vec x50 = x47 ^ x49;
+    bs_vec x51 = x50 & a3;
+    bs_vec x52 = x47 ^ x51;
+    bs_vec x53 = x0 ^ x1;
+    bs_vec x54 = x3 ^ x53;
+    bs_vec x55 = x54 & a3;
+    bs_vec x56 = x3 ^ x55;
+    bs_vec x57 = x52 ^ x56;
+    bs_vec x58 = x57 & a1;
+    bs_vec x59 = x52 ^ x58;
+    bs_vec x60 = x44 ^ x59;
+    bs_vec x61 = x60 & a6;
+    bs_vec x62 = x44 ^ x61;
+    bs_vec x63 = x25 ^ a3;
+    bs_vec x64 = x3 & a4;
+    bs_vec x65 = a2 ^ x64;
+    bs_vec x66 = x45 & a3;
+    bs_vec x67 = x65 ^ x66;
+    bs_vec x68 = x63 ^ x67;
+    bs_vec x69 = x68 & a1;
+    bs_vec x70 = x63 ^ x69;
+    bs_vec x71 = a2 ^ a4;
+    bs_vec x72 = x64 & a3;
+    bs_vec x73 = x71 ^ x72;
+    bs_vec x74 = x4 ^ x46;
+    bs_vec x75 = x74 ^ a3;
+    bs_vec x76 = x73 ^ x75;
+    bs_vec x77 = x76 & a1;
+    bs_vec x78 = x73 ^ x77;
+    bs_vec x79 = x70 ^ x78;
+    bs_vec x80 = x79 & a6;
+    bs_vec x81 = x70 ^ x80;
+    bs_vec x82 = ~x6;
+    bs_vec x83 = x39 ^ a4;
+    bs_vec x84 = x82 ^ x83;
+    bs_vec x85 = x84 & a3;
+    bs_vec x86 = x82 ^ x85;
+    bs_vec x87 = x86 ^ a1;
+    bs_vec x88 = x45 & a4;
+    bs_vec x89 = x3 ^ x88;
+    bs_vec x90 = x89 ^ x85;
+    bs_vec x91 = ~x15;
+    bs_vec x92 = x91 ^ a3;
+    bs_vec x93 = x90 ^ x92;
+    bs_vec x94 = x93 & a1;
+    bs_vec x95 = x90 ^ x94;
+    bs_vec x96 = x87 ^ x95;
+    bs_vec x97 = x96 & a6;
+    bs_vec x98 = x87 ^ x97;
+    l[31] ^= x36;
+    l[11] ^= x62;
+    l[21] ^= x81;
+    l[6] ^= x98;
+}
+
+// S8: 93 gates
+BS_FN void BS_NAME(s8)(bs_vec *l, bs_vec a1, bs_vec a2, bs_vec a3, bs_vec a4, bs_vec a5,
+                        bs_vec a6) {
+    bs_vec x0 = ~a5;
+    bs_vec x1 = x0 | a2;
+    bs_vec x2 = x0 ^ a2;
+    bs_vec x3 = x1 ^ x2;
+    bs_vec x4 = x3 & a4;
+    bs_vec x5 = x1 ^ x4;
+    bs_vec x6 = ~x1;
+    bs_vec x7 = x6 ^ x0;
+    bs_vec x8 = x7 & a4;
+    bs_vec x9 = x6 ^ x8;
+    bs_vec x10 = x5 ^ x9;
+    bs_vec x11 = x10 & a3;
+    bs_vec x12 = x5 ^ x11;
+    bs_vec x13 = x6 ^ a2;
+    bs_vec x14 = x13 & a4;
+    bs_vec x15 = x6 ^ x14;
+    bs_vec x16 = x0 & a3;
+    bs_vec x17 = x15 ^ x16;
+    bs_vec x18 = x12 ^ x17;
+    bs_vec x19 = x18 & a1;
+    bs_vec x20 = x12 ^ x19;
+    bs_vec x21 = ~x2;
+    bs_vec x22 = ~x3;
+    bs_vec x23 = x1 & a4;
+    bs_vec x24 = x21 ^ x23;
+    bs_vec x25 = x24 ^ a3;
+    bs_vec x26 = x2 & a4;
+    bs_vec x27 = a2 ^ x26;
+    bs_vec x28 = x13 & a3;
+    bs_vec x29 = x27 ^ x28;
+    bs_vec x30 = x25 ^ x29;
+    bs_vec x31 = x30 & a1;
+    bs_vec x32 = x25 ^ x31;
+    bs_vec x33 = x20 ^ x32;
+    bs_vec x34 = x33 & a6;
+    bs_vec x35 = x20 ^ x34;
+    bs_vec x36 = ~x13;
+    bs_vec x37 = x22 & a4;
+    bs_vec x38 = x36 ^ x37;
+    bs_vec x39 = x21 & a3;
+    bs_vec x40 = x38 ^ x39;
+    bs_vec x41 = x2 ^ x11;
+    bs_vec x42 = x40 ^ x41;
+    bs_vec x43 = x42 & a1;
+    bs_vec x44 = x40 ^ x43;
+    bs_vec x45 = ~x40;
+    bs_vec x46 = a2 ^ a4;
+    bs_vec x47 = x46 ^ x16;
+    bs_vec x48 = x45 ^ x47;
+    bs_vec x49 = x48 & a1;
+    bs_vec x50 = x45 ^ x49;
+    bs_vec x51 = x44 ^ x50;
+    bs_vec x52 = x51 & a6;
+    bs_vec x53 = x44 ^ x52;
+    bs_vec x54 = a5 & a4;
+    bs_vec x55 = x21 ^ x54;
+    bs_vec x56 = x55 ^ x16;
+    bs_vec x57 = x22 ^ a4;
+    bs_vec x58 = x7 & a3;
+    bs_vec x59 = x57 ^ x58;
+    bs_vec x60 = x56 ^ x59;
+    bs_vec x61 = x60 & a1;
+    bs_vec x62 = x56 ^ x61;
+    bs_vec x63 = x6 & a4;
+    bs_vec x64 = x22 ^ x63;
+    bs_vec x65 = x15 ^ x64;
+    bs_vec x66 = x65 & a3;
+    bs_vec x67 = x15 ^ x66;
+    bs_vec x68 = x21 & a4;
+    bs_vec x69 = x0 ^ x68;
+    bs_vec x70 = x69 ^ x55;
+    bs_vec x71 = x70 & a3;
+    bs_vec x72 = x69 ^ x71;
+    bs_vec x73 = x67 ^ x72;
+    bs_vec x74 = x73 & a1;
+    bs_vec x75 = x67 ^ x74;
+    bs_vec x76 = x62 ^ x75;
+    bs_vec x77 = x76 & a6;
+    bs_vec x78 = x62 ^ x77;
+    bs_vec x79 = ~x32;
+    bs_vec x80 = x64 ^ x9;
+    bs_vec x81 = x80 & a3;
+    bs_vec x82 = x64 ^ x81;
+    bs_vec x83 = a2 ^ x68;
+    bs_vec x84 = x21 ^ x83;
+    bs_vec x85 = x84 & a3;
+    bs_vec x86 = x21 ^ x85;
+    bs_vec x87 = x82 ^ x86;
+    bs_vec x88 = x87 & a1;
+    bs_vec x89 = x82 ^ x88;
+    bs_vec x90 = x79 ^ x89;
+    bs_vec x91 = x90 & a6;
+    bs_vec x92 = x79 ^ x91;
+    l[4] ^= x35;
+    l[26] ^= x53;
+    l[14] ^= x78;
+    l[20] ^= x92;
+}
+
+BS_FN void BS_NAME(round)(bs_vec *l, const bs_vec *r, const bs_vec *k, const uint8_t *ks) {
+    BS_NAME(s1)(l, r[31] ^ k[ks[0]], r[0] ^ k[ks[1]], r[1] ^ k[ks[2]],
+                 r[2] ^ k[ks[3]], r[3] ^ k[ks[4]], r[4] ^ k[ks[5]]);
+    BS_NAME(s2)(l, r[3] ^ k[ks[6]], r[4] ^ k[ks[7]], r[5] ^ k[ks[8]],
+                 r[6] ^ k[ks[9]], r[7] ^ k[ks[10]], r[8] ^ k[ks[11]]);
+    BS_NAME(s3)(l, r[7] ^ k[ks[12]], r[8] ^ k[ks[13]], r[9] ^ k[ks[14]],
+                 r[10] ^ k[ks[15]], r[11] ^ k[ks[16]], r[12] ^ k[ks[17]]);
+    BS_NAME(s4)(l, r[11] ^ k[ks[18]], r[12] ^ k[ks[19]], r[13] ^ k[ks[20]],
+                 r[14] ^ k[ks[21]], r[15] ^ k[ks[22]], r[16] ^ k[ks[23]]);
+    BS_NAME(s5)(l, r[15] ^ k[ks[24]], r[16] ^ k[ks[25]], r[17] ^ k[ks[26]],
+                 r[18] ^ k[ks[27]], r[19] ^ k[ks[28]], r[20] ^ k[ks[29]]);
+    BS_NAME(s6)(l, r[19] ^ k[ks[30]], r[20] ^ k[ks[31]], r[21] ^ k[ks[32]],
+                 r[22] ^ k[ks[33]], r[23] ^ k[ks[34]], r[24] ^ k[ks[35]]);
+    BS_NAME(s7)(l, r[23] ^ k[ks[36]], r[24] ^ k[ks[37]], r[25] ^ k[ks[38]],
+                 r[26] ^ k[ks[39]], r[27] ^ k[ks[40]], r[28] ^ k[ks[41]]);
+    BS_NAME(s8)(l, r[27] ^ k[ks[42]], r[28] ^ k[ks[43]], r[29] ^ k[ks[44]],
+                 r[30] ^ k[ks[45]], r[31] ^ k[ks[46]], r[0] ^ k[ks[47]]);
+}
+
+// Steps all lanes: DES of the index under the fixed challenge, then
+// index = LE56(hash) + counter and counter + 1. idx holds 56 slices,
+// cnt DES_BS_COUNTER_BITS.
+BS_FN void BS_NAME(run)(uint64_t *idx_words, uint64_t *cnt_words, uint32_t steps) {
+    bs_vec *idx = (bs_vec *)idx_words;
+    bs_vec *cnt = (bs_vec *)cnt_words;
+    bs_vec zero = {0};
+    bs_vec ones = ~zero;
+    bs_vec l[32], r[32];
+
+    for (uint32_t s = 0; s < steps; s++) {
+        for (int i = 0; i < 32; i++) {
+            l[i] = (DES_BS_L0 >> i) & 1 ? ones : zero;
+            r[i] = (DES_BS_R0 >> i) & 1 ? ones : zero;
+        }
+        // Rounds in pairs, so l and r end up holding L16 and R16
+        for (int i = 0; i < 16; i += 2) {
+            BS_NAME(round)(l, r, idx, des_bs_ks[i]);
+            BS_NAME(round)(r, l, idx, des_bs_ks[i + 1]);
+        }
+
+        // Ciphertext byte j bit b is FP(R16 L16) bit 8j + 7 - b; the
+        // top byte drops out of the mod 2^56
+        bs_vec carry = zero;
+        for (int i = 0; i < 56; i++) {
+            int slice = 31 - i / 8 - 8 * ((i % 8) >> 1);
+            bs_vec h = i & 1 ? l[slice] : r[slice];
+            if (i < DES_BS_COUNTER_BITS) {
+                bs_vec c = cnt[i], t = h ^ c;
+                idx[i] = t ^ carry;
+                carry = (h & c) | (t & carry);
+            } else {
+                idx[i] = h ^ carry;
+                carry &= h;
+            }
+        }
+
+        carry = ones;
+        for (int i = 0; i < DES_BS_COUNTER_BITS; i++) {
+            bs_vec c = cnt[i];
+            cnt[i] = c ^ carry;
+            carry &= c;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include <string.h>
+#include "ef.h"
+
+static uint32_t low_bits_for(uint64_t range, uint32_t n) {
+    uint32_t l = 0;
+    uint64_t avg = n ? range / n : 0;
+    while (l < 56 && (avg >> (l + 1)) != 0) l++;
+    return avg ? l : 0;
+}
+
+static uint64_t high_len_bits(uint64_t range, uint32_t n, uint32_t l) {
+    return (uint64_t)n + (range >> l) + 1;
+}
+
+size_t ef_block_max_bytes(uint32_t n) {
+    // range < 2^56, l chosen so that range >> l <= 2n
+    return ((uint64_t)n * 56 + 63) / 64 * 8 + ((uint64_t)3 * n + 1 + 63) / 64 * 8 + 8;
+}
+
+static inline uint64_t get_bits(const uint64_t *words, uint64_t bit, uint32_t len) {
+    if (len == 0) return 0;
+    uint64_t w = bit >> 6;
+    uint32_t shift = bit & 63;
+    uint64_t v = words[w] >> shift;
+    if (shift + len > 64) v |= words[w + 1] << (64 - shift);
+    return v & ((len == 64) ? ~0ULL : ((1ULL << len) - 1));
+}
+
+static inline void put_bits(uint64_t *words, uint64_t bit, uint32_t len, uint64_t v) {
+    if (len == 0) return;
+    uint64_t w = bit >> 6;
+    uint32_t shift = bit & 63;
+    v &= (len == 64) ? ~0ULL : ((1ULL << len) - 1);
+    words[w] |= v << shift;
+    if (shift + len > 64) words[w + 1] |= v >> (64 - shift);
+}
+
+size_t ef_encode_block(const uint64_t *values, uint32_t n, ef_block *blk, uint64_t *out) {
+    uint64_t first = n ? values[0] : 0;
+    uint64_t range = n ? values[n - 1] - first : 0;
+    uint32_t l = low_bits_for(range, n);
+
+    uint64_t low_words = ((uint64_t)n * l + 63) / 64;
+    uint64_t high_words = (high_len_bits(range, n, l) + 63) / 64;
+    memset(out, 0, (low_words + high_words) * 8);
+
+    uint64_t *low = out;
+    uint64_t *high = out + low_words;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t v = values[i] - first;
+        put_bits(low, (uint64_t)i * l, l, v);
+        uint64_t hpos = (v >> l) + i;
+        high[hpos >> 6] |= 1ULL << (hpos & 63);
+    }
+
+    blk->first_end = first;
+    blk->low_bits = l;
+    blk->count = n;
+    return (low_words + high_words) * 8;
+}
+
+void ef_decode_block(const ef_block *blk, const uint64_t *data, uint64_t *out) {
+    uint32_t l = blk->low_bits;
+    const uint64_t *low = data;
+    const uint64_t *high = data + ((uint64_t)blk->count * l + 63) / 64;
+
+    uint32_t i = 0;
+    for (uint64_t w = 0; i < blk->count; w++) {
+        uint64_t bits = high[w];
+        while (bits) {
+            uint64_t hpos = (w << 6) + __builtin_ctzll(bits);
+            uint64_t h = hpos - i;
+            out[i] = blk->first_end + ((h << l) | get_bits(low, (uint64_t)i * l, l));
+            i++;
+            bits &= bits - 1;
+        }
+    }
+}
+
+// Without -mpopcnt GCC calls a table-driven libgcc routine; the SWAR
+// count is a handful of ALU ops
+static inline uint32_t popcount64(uint64_t x) {
+#ifdef __POPCNT__
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (uint32_t)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Position of the k-th (from 0) set bit of x; x has more than k set bits
+static inline uint32_t select64(uint64_t x, uint32_t k) {
+    uint32_t pos = 0;
+    uint32_t c = popcount64(x & 0xffffffffULL);
+    if (k >= c) { k -= c; x >>= 32; pos += 32; }
+    c = popcount64(x & 0xffff);
+    if (k >= c) { k -= c; x >>= 16; pos += 16; }
+    c = popcount64(x & 0xff);
+    if (k >= c) { k -= c; x >>= 8; pos += 8; }
+    while (k--) x &= x - 1;
+    return pos + __builtin_ctzll(x);
+}
+
+uint32_t ef_block_rank(const ef_block *blk, const uint64_t *data, uint64_t value,
+                       int *equal) {
+    int eq = 0;
+    if (!equal) equal = &eq;
+    *equal = 0;
+    if (value < blk->first_end || blk->count == 0) return 0;
+
+    uint32_t l = blk->low_bits;
+    uint64_t v = value - blk->first_end;
+    uint64_t target_high = v >> l;
+    uint64_t target_low = v & ((1ULL << l) - 1);
+    const uint64_t *low = data;
+    const uint64_t *high = data + ((uint64_t)blk->count * l + 63) / 64;
+
+    // Elements with a smaller high part end at the target_high-th zero
+    // (select0); each one bit from there on is an element with this high
+    // part, ordered by its low bits
+    uint64_t pos = 0;
+    if (target_high > 0) {
+        uint64_t zeros_left = target_high - 1;
+        uint32_t seen = 0;
+        for (uint64_t w = 0;; w++) {
+            // No element lies past the last one bit
+            if (seen >= blk->count) return blk->count;
+            uint64_t zeros = ~high[w];
+            uint32_t z = popcount64(zeros);
+            if (zeros_left < z) {
+                pos = (w << 6) + select64(zeros, (uint32_t)zeros_left) + 1;
+                break;
+            }
+            zeros_left -= z;
+            seen += 64 - z;
+        }
+    }
+
+    uint64_t i = pos - target_high;
+    while (i < blk->count && ((high[pos >> 6] >> (pos & 63)) & 1)) {
+        uint64_t lo = get_bits(low, i * l, l);
+        if (lo >= target_low) {
+            *equal = lo == target_low;
+            break;
+        }
+        i++;
+        pos++;
+    }
+    return (uint32_t)i;
+}
+
+uint64_t ef_block_get(const ef_block *blk, const uint64_t *data, uint32_t index) {
+    uint32_t l = blk->low_bits;
+    const uint64_t *low = data;
+    const uint64_t *high = data + ((uint64_t)blk->count * l + 63) / 64;
+
+    // select1: the word holding the index-th one, then the bit within it
+    uint32_t k = index;
+    uint64_t w = 0;
+    for (;; w++) {
+        uint32_t c = popcount64(high[w]);
+        if (k < c) break;
+        k -= c;
+    }
+    uint64_t h = (w << 6) + select64(high[w], k) - index;
+    return blk->first_end + ((h << l) | get_bits(low, (uint64_t)index * l, l));
+}
+
+int ef_block_find(const ef_block *blk, const uint64_t *data, uint64_t value, uint32_t *index) {
+    int equal;
+    uint32_t i = ef_block_rank(blk, data, value, &equal);
+    if (!equal) return 0;
+    *index = i;
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include "ef_index.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define EF_INDEX_VERSION 1
+#define START_BATCH 256          // start indices read per round
+#define START_QUEUE_DEPTH 64
+#define DECODE_MIN_QUERIES 8     // queries in one block that pay for decoding it
+
+// ============ Build ============
+
+// Codes one table's ends block by block and appends directory and data
+// at *offset
+static int build_entry(FILE *out, const rt_table *table, const char *path, void *entry,
+                       uint64_t *offset, void *arg) {
+    (void)arg;
+    ef_index_entry *e = entry;
+    int ret = -1;
+    ef_block *blocks = NULL;
+    uint64_t *encoded = malloc(ef_block_max_bytes(EF_BLOCK_SIZE));
+    uint64_t values[EF_BLOCK_SIZE];
+    uint64_t n = table->num_chains;
+
+    e->num_blocks = (n + EF_BLOCK_SIZE - 1) / EF_BLOCK_SIZE;
+    e->block_offset = set_file_align(*offset);
+    e->data_offset = set_file_align(e->block_offset + e->num_blocks * sizeof(ef_block));
+
+    blocks = calloc(e->num_blocks, sizeof(ef_block));
+    if (!blocks || !encoded) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        goto done;
+    }
+    if (fseeko(out, e->data_offset, SEEK_SET) != 0) goto done;
+
+    for (uint64_t b = 0; b < e->num_blocks; b++) {
+        uint32_t count = n - b * EF_BLOCK_SIZE < EF_BLOCK_SIZE ?
+                         (uint32_t)(n - b * EF_BLOCK_SIZE) : EF_BLOCK_SIZE;
+        for (uint32_t i = 0; i < count; i++) {
+            values[i] = table->ends[(b * EF_BLOCK_SIZE + i) * table->stride];
+        }
+        size_t bytes = ef_encode_block(values, count, &blocks[b], encoded);
+        blocks[b].offset = e->data_bytes;
+        if (fwrite(encoded, 1, bytes, out) != bytes) {
+            fprintf(stderr, "Write failed\n");
+            goto done;
+        }
+        e->data_bytes += bytes;
+    }
+    if (set_file_write_at(out, e->block_offset, blocks, e->num_blocks * sizeof(ef_block)) != 0) {
+        fprintf(stderr, "Write failed\n");
+        goto done;
+    }
+    *offset = e->data_offset + e->data_bytes;
+    ret = 0;
+
+done:
+    free(blocks);
+    free(encoded);
+    return ret;
+}
+
+int ef_index_build(const char *out_path, char **table_paths, int num_tables) {
+    uint64_t total_chains;
+    int64_t size = set_file_build(out_path, EF_INDEX_MAGIC, EF_INDEX_VERSION, EF_BLOCK_SIZE,
+                                  table_paths, num_tables, sizeof(ef_index_entry), build_entry,
+                                  NULL, &total_chains);
+    if (size < 0) return -1;
+
+    printf("%s: %d tables, %llu chains, %.1f MB (%.2f bits/chain)\n", out_path, num_tables,
+           (unsigned long long)total_chains, size / (1024.0 * 1024.0),
+           total_chains ? size * 8.0 / total_chains : 0.0);
+    return 0;
+}
+
+// ============ Lookup ============
+
+int ef_index_open(ef_index *ix, const char *path) {
+    memset(ix, 0, sizeof(ef_index));
+    if (set_file_open(path, EF_INDEX_MAGIC, EF_INDEX_VERSION, EF_BLOCK_SIZE,
+                      sizeof(ef_index_entry), &ix->data, &ix->size) != 0) {
+        return -1;
+    }
+    ix->header = (const set_file_header *)ix->data;
+    ix->entries = (const ef_index_entry *)(ix->header + 1);
+
+    int ok = 1;
+    for (uint32_t i = 0; ok && i < ix->header->num_tables; i++) {
+        const ef_index_entry *e = &ix->entries[i];
+        ok = e->block_offset + e->num_blocks * sizeof(ef_block) <= ix->size &&
+             e->data_offset + e->data_bytes <= ix->size &&
+             e->num_blocks == (e->table.num_chains + EF_BLOCK_SIZE - 1) / EF_BLOCK_SIZE;
+    }
+    if (!ok) {
+        ef_index_close(ix);
+        return -1;
+    }
+    return 0;
+}
+
+void ef_index_close(ef_index *ix) {
+    set_file_close(ix->data, ix->size);
+    memset(ix, 0, sizeof(ef_index));
+}
+
+const ef_index_entry *ef_index_find(const ef_index *ix, const char *table_path) {
+    return set_file_find(ix->data, sizeof(ef_index_entry), table_path);
+}
+
+typedef struct {
+    int fd;                    // .rt table, or the .rts start column
+    uint32_t record;           // bytes per chain in fd
+    uring ring;
+    int use_ring;
+    set_file_read reads[START_BATCH];
+    uint32_t count;
+    uint32_t dropped;          // candidates whose start could not be read
+} start_reader;
+
+// Reads the queued start indices straight into their candidate slots
+// (START_QUEUE_DEPTH reads in flight through io_uring where available,
+// one pread at a time otherwise). The queued reads belong to the last
+// count candidates; if the batch fails they are read again one by one and
+// those whose start still cannot be read are dropped, as in join_emit.
+static void read_starts(start_reader *sr, uint64_t *start_indices, uint32_t *positions,
+                        uint32_t *num_candidates) {
+    uint32_t count = sr->count;
+    sr->count = 0;
+    if (set_file_read_batch(sr->use_ring ? &sr->ring : NULL, START_QUEUE_DEPTH, sr->fd,
+                            sr->reads, count) == 0) {
+        return;
+    }
+
+    uint32_t first = *num_candidates - count, kept = first;
+    for (uint32_t i = first; i < *num_candidates; i++) {
+        if (set_file_read_at(sr->fd, &start_indices[i], 8, sr->reads[i - first].offset) != 0) {
+            continue;
+        }
+        start_indices[kept] = start_indices[i];
+        positions[kept] = positions[i];
+        kept++;
+    }
+    sr->dropped += *num_candidates - kept;
+    *num_candidates = kept;
+}
+
+// First block at or after lo whose first end is >= key, by doubling steps
+// from lo and a binary search of the last one
+static uint64_t block_lower_bound(const ef_block *blocks, uint64_t lo, uint64_t n, uint64_t key) {
+    uint64_t step = 1, hi = lo;
+    while (hi < n && blocks[hi].first_end < key) {
+        lo = hi + 1;
+        hi = lo + step;
+        step *= 2;
+    }
+    if (hi > n) hi = n;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (blocks[mid].first_end < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Queues chain as a candidate for every query from q on with its end
+static int emit_chain(start_reader *sr, uint64_t chain, const rt_query *queries,
+                      uint32_t q, uint32_t q_end, uint64_t *start_indices, uint32_t *positions,
+                      uint32_t *num_candidates, uint32_t max_candidates) {
+    int found = 0;
+    for (uint32_t j = q; j < q_end && queries[j].end == queries[q].end; j++) {
+        if (*num_candidates >= max_candidates) break;
+        sr->reads[sr->count++] = (set_file_read){
+            .buf = &start_indices[*num_candidates], .len = 8, .offset = chain * sr->record,
+        };
+        positions[*num_candidates] = queries[j].pos;
+        (*num_candidates)++;
+        found++;
+        // Read before the buffer counts as full, so a full buffer never
+        // shrinks afterwards by dropping unreadable starts
+        if (sr->count == START_BATCH || *num_candidates == max_candidates) {
+            read_starts(sr, start_indices, positions, num_candidates);
+        }
+    }
+    return found;
+}
+
+int ef_index_search(const ef_index *ix, const ef_index_entry *e, const char *table_path,
+                    const rt_query *queries, uint32_t num_queries,
+                    uint64_t *start_indices, uint32_t *positions,
+                    uint32_t *num_candidates, uint32_t max_candidates,
+                    ef_index_stats *stats) {
+    const ef_block *blocks = (const ef_block *)(ix->data + e->block_offset);
+    const uint8_t *data = ix->data + e->data_offset;
+
+    start_reader *sr = calloc(1, sizeof(start_reader));
+    if (!sr) return -1;
+    if (table_format_of(table_path) == TABLE_FORMAT_SPLIT) {
+        char starts_path[1024];
+        table_starts_path(table_path, starts_path, sizeof(starts_path));
+        sr->fd = open(starts_path, O_RDONLY | O_BINARY);
+        sr->record = 8;
+    } else {
+        sr->fd = open(table_path, O_RDONLY | O_BINARY);
+        sr->record = 16;           // start is the first word of each pair
+    }
+    if (sr->fd < 0) {
+        free(sr);
+        return -1;
+    }
+    sr->use_ring = uring_init(&sr->ring, START_QUEUE_DEPTH) == 0;
+
+    uint32_t q, q_end;
+    set_file_query_range(&e->table, queries, num_queries, &q, &q_end);
+    stats->queries += q_end - q;
+
+    int found = 0;
+    uint64_t b = 0;
+    uint64_t decoded[EF_BLOCK_SIZE];
+    while (q < q_end && *num_candidates < max_candidates) {
+        uint64_t key = queries[q].end;
+
+        // The key's first copy is in the last block starting below it,
+        // or in a later one when duplicates start a block
+        uint64_t lo = block_lower_bound(blocks, b, e->num_blocks, key);
+        if (lo > b) b = lo - 1;
+
+        // Many queries inside one block (small tables, or many ciphertexts):
+        // decode it once and merge them against it
+        uint64_t bound = b + 1 < e->num_blocks ? blocks[b + 1].first_end : UINT64_MAX;
+        if (q + DECODE_MIN_QUERIES <= q_end && queries[q + DECODE_MIN_QUERIES - 1].end < bound &&
+            blocks[b].count <= EF_BLOCK_SIZE) {
+            ef_decode_block(&blocks[b], (const uint64_t *)(data + blocks[b].offset), decoded);
+            stats->blocks++;
+            uint32_t i = 0;
+            while (q < q_end && queries[q].end < bound && *num_candidates < max_candidates) {
+                key = queries[q].end;
+                while (i < blocks[b].count && decoded[i] < key) i++;
+                for (uint32_t k = i; k < blocks[b].count && decoded[k] == key; k++) {
+                    found += emit_chain(sr, b * EF_BLOCK_SIZE + k, queries, q, q_end,
+                                        start_indices, positions, num_candidates,
+                                        max_candidates);
+                }
+                while (q < q_end && queries[q].end == key) q++;
+            }
+            continue;
+        }
+
+        for (uint64_t blk = b; blk < e->num_blocks && blocks[blk].first_end <= key; blk++) {
+            const uint64_t *block_data = (const uint64_t *)(data + blocks[blk].offset);
+            uint32_t count = blocks[blk].count;
+            int equal;
+            uint32_t i = ef_block_rank(&blocks[blk], block_data, key, &equal);
+            stats->blocks++;
+            if (!equal) {
+                // The run of copies may still start in the next block
+                if (i < count) break;
+                continue;
+            }
+            for (; i < count && ef_block_get(&blocks[blk], block_data, i) == key; i++) {
+                found += emit_chain(sr, blk * EF_BLOCK_SIZE + i, queries, q, q_end,
+                                    start_indices, positions, num_candidates,
+                                    max_candidates);
+            }
+            if (i < count) break;
+        }
+        while (q < q_end && queries[q].end == key) q++;
+    }
+    if (sr->count > 0) read_starts(sr, start_indices, positions, num_candidates);
+    stats->reads += found;
+    found -= sr->dropped;
+
+    if (sr->use_ring) uring_exit(&sr->ring);
+    close(sr->fd);
+    free(sr);
+    return found;
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fuse.h"
+
+#define FUSE_ARITY 3
+#define FUSE_MAX_SEGMENT_LENGTH 262144
+#define FUSE_MAX_ATTEMPTS 100
+
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+int fuse_init(fuse_params *p, uint64_t n, uint32_t fp_bits) {
+    memset(p, 0, sizeof(fuse_params));
+    if ((fp_bits != 8 && fp_bits != 16) || n >= UINT32_MAX) return -1;
+    p->fp_bits = fp_bits;
+
+    // Segment length and array size as in the reference implementation:
+    // larger sets use longer segments and less slack
+    uint32_t segment_length = n == 0 ? 4 :
+        1U << (int)floor(log((double)n) / log(3.33) + 2.25);
+    if (segment_length > FUSE_MAX_SEGMENT_LENGTH) segment_length = FUSE_MAX_SEGMENT_LENGTH;
+    double size_factor = n <= 1 ? 0 : fmax(1.125, 0.875 + 0.25 * log(1000000.0) / log((double)n));
+    uint64_t capacity = n <= 1 ? 0 : (uint64_t)round((double)n * size_factor);
+
+    uint64_t init_segments = (capacity + segment_length - 1) / segment_length;
+    init_segments = init_segments > FUSE_ARITY - 1 ? init_segments - (FUSE_ARITY - 1) : 0;
+    uint64_t array_length = (init_segments + FUSE_ARITY - 1) * segment_length;
+    uint64_t segment_count = (array_length + segment_length - 1) / segment_length;
+    segment_count = segment_count <= FUSE_ARITY - 1 ? 1 : segment_count - (FUSE_ARITY - 1);
+    array_length = (segment_count + FUSE_ARITY - 1) * segment_length;
+    if (array_length > UINT32_MAX) return -1;
+
+    p->segment_length = segment_length;
+    p->segment_length_mask = segment_length - 1;
+    p->segment_count_length = (uint32_t)(segment_count * segment_length);
+    p->array_length = (uint32_t)array_length;
+    return 0;
+}
+
+uint64_t fuse_count_distinct(const uint64_t *keys, uint32_t stride, uint64_t n) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < n; i++) count += i == 0 || keys[i * stride] != keys[(i - 1) * stride];
+    return count;
+}
+
+static inline void set_fp(const fuse_params *p, void *F, uint32_t i, uint64_t v) {
+    if (p->fp_bits == 8) ((uint8_t *)F)[i] = (uint8_t)v;
+    else ((uint16_t *)F)[i] = (uint16_t)v;
+}
+
+static inline uint64_t get_fp(const fuse_params *p, const void *F, uint32_t i) {
+    return p->fp_bits == 8 ? ((const uint8_t *)F)[i] : ((const uint16_t *)F)[i];
+}
+
+// Hashes are bucketed by their top bits (so each segment's keys are
+// inserted together), then every slot counts its keys and xors their
+// hashes; slots holding exactly one key are peeled off repeatedly. If
+// every key peels, the fingerprints are assigned in reverse peel order.
+// A seed that leaves a cycle is replaced and the build retried.
+int fuse_build(fuse_params *p, const uint64_t *keys, uint32_t stride, uint64_t n,
+               void *fingerprints) {
+    uint32_t size = (uint32_t)fuse_count_distinct(keys, stride, n);
+    uint32_t capacity = p->array_length;
+    memset(fingerprints, 0, fuse_bytes(p));
+    if (size == 0) return 0;
+
+    uint64_t *reverse_order = calloc((size_t)size + 1, sizeof(uint64_t));
+    uint8_t *reverse_h = malloc(size);
+    uint32_t *alone = malloc((size_t)capacity * sizeof(uint32_t));
+    uint8_t *t2count = calloc(capacity, 1);
+    uint64_t *t2hash = calloc(capacity, sizeof(uint64_t));
+
+    uint32_t segment_count = p->segment_count_length / p->segment_length;
+    uint32_t block_bits = 1;
+    while ((1U << block_bits) < segment_count) block_bits++;
+    uint32_t block = 1U << block_bits;
+    uint32_t *start_pos = malloc((size_t)block * sizeof(uint32_t));
+
+    int ret = -1;
+    if (!reverse_order || !reverse_h || !alone || !t2count || !t2hash || !start_pos) goto done;
+
+    uint64_t rng = 0x726b2b9d438b9d4dULL;
+    p->seed = splitmix64(&rng);
+    reverse_order[size] = 1;    // sentinel for the bucket scan
+
+    for (int attempt = 0; attempt < FUSE_MAX_ATTEMPTS; attempt++) {
+        for (uint32_t i = 0; i < block; i++) {
+            start_pos[i] = (uint32_t)(((uint64_t)i * size) >> block_bits);
+        }
+        for (uint64_t i = 0; i < n; i++) {
+            if (i > 0 && keys[i * stride] == keys[(i - 1) * stride]) continue;
+            uint64_t hash = fuse_hash(p, keys[i * stride]);
+            uint32_t b = (uint32_t)(hash >> (64 - block_bits));
+            while (reverse_order[start_pos[b]] != 0) b = (b + 1) & (block - 1);
+            reverse_order[start_pos[b]] = hash;
+            start_pos[b]++;
+        }
+
+        int error = 0;
+        for (uint32_t i = 0; i < size; i++) {
+            uint64_t hash = reverse_order[i];
+            uint32_t h0, h1, h2;
+            fuse_slots(p, hash, &h0, &h1, &h2);
+            t2count[h0] += 4;
+            t2hash[h0] ^= hash;
+            t2count[h1] += 4;
+            t2count[h1] ^= 1;
+            t2hash[h1] ^= hash;
+            t2count[h2] += 4;
+            t2count[h2] ^= 2;
+            t2hash[h2] ^= hash;
+            // A slot count of 64 would wrap the 8-bit counter
+            error |= t2count[h0] < 4 || t2count[h1] < 4 || t2count[h2] < 4;
+        }
+
+        uint32_t queue = 0, stack = 0;
+        if (!error) {
+            for (uint32_t i = 0; i < capacity; i++) {
+                alone[queue] = i;
+                queue += (t2count[i] >> 2) == 1;
+            }
+            while (queue > 0) {
+                uint32_t index = alone[--queue];
+                if ((t2count[index] >> 2) != 1) continue;
+
+                uint64_t hash = t2hash[index];
+                uint32_t found = t2count[index] & 3;
+                reverse_h[stack] = (uint8_t)found;
+                reverse_order[stack] = hash;
+                stack++;
+
+                uint32_t h[5];
+                fuse_slots(p, hash, &h[0], &h[1], &h[2]);
+                h[3] = h[0];
+                h[4] = h[1];
+                for (uint32_t k = 1; k <= 2; k++) {
+                    uint32_t other = h[found + k];
+                    alone[queue] = other;
+                    queue += (t2count[other] >> 2) == 2;
+                    t2count[other] -= 4;
+                    t2count[other] ^= (found + k) % 3;
+                    t2hash[other] ^= hash;
+                }
+            }
+        }
+        if (!error && stack == size) {
+            ret = 0;
+            break;
+        }
+
+        memset(reverse_order, 0, (size_t)size * sizeof(uint64_t));
+        memset(t2count, 0, capacity);
+        memset(t2hash, 0, (size_t)capacity * sizeof(uint64_t));
+        p->seed = splitmix64(&rng);
+    }
+    if (ret != 0) goto done;
+
+    for (uint32_t i = size; i-- > 0;) {
+        uint64_t hash = reverse_order[i];
+        uint32_t h[5];
+        fuse_slots(p, hash, &h[0], &h[1], &h[2]);
+        h[3] = h[0];
+        h[4] = h[1];
+        uint32_t found = reverse_h[i];
+        set_fp(p, fingerprints, h[found], (hash ^ (hash >> 32)) ^
+               get_fp(p, fingerprints, h[found + 1]) ^ get_fp(p, fingerprints, h[found + 2]));
+    }
+
+done:
+    free(reverse_order);
+    free(reverse_h);
+    free(alone);
+    free(t2count);
+    free(t2hash);
+    free(start_pos);
+    return ret;
+}
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "lookup.h"
-#include "netntlmv1.h"
+#include "cpu_host.h"
 #include "utils.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 void lookup_init_params(lookup_params *params, uint32_t chain_len) {
@@ -19,87 +20,39 @@ void lookup_init_params(lookup_params *params, uint32_t chain_len) {
     );
 }
 
-// Walk chain from start_index, looking for target ciphertext
-// Returns 1 if found (and sets key_out), 0 if false alarm
-static int verify_chain(lookup_params *params, uint64_t start_index,
-                        uint32_t expected_pos, const uint8_t *target_ct,
-                        uint8_t *key_out) {
-    uint64_t index = start_index;
-    uint8_t key_56[7];
-    uint8_t key_64[8];
-    uint8_t hash[8];
-    uint32_t key_len;
-    
-    for (uint32_t pos = 0; pos <= expected_pos; pos++) {
-        index_to_plaintext(index, params->charset_len,
-                           params->plaintext_len_min, params->plaintext_len_max,
-                           params->plaintext_space_up_to_index,
-                           key_56, &key_len);
-        
-        netntlmv1_hash(key_64, hash);
-        
-        if (pos == expected_pos) {
-            // Check if this is our target
-            if (memcmp(hash, target_ct, 8) == 0) {
-                memcpy(key_out, key_56, 7);
-                return 1;
-            }
-            return 0;  // False alarm
-        }
-        
-        index = hash_to_index(hash, params->reduction_offset,
-                              params->plaintext_space_total, pos);
-    }
-    
-    return 0;
-}
-
+// End indices for every position come from the parallel CPU precompute
+// (one walk per position, O(n^2) steps in all, split across cores); the
+// table hits are then checked together, cheapest position first
 int lookup_crack(lookup_params *params, rt_table *table,
                  const uint8_t *ciphertext, uint8_t *key_out) {
-    uint8_t hash[8];
-    uint64_t index;
-    int found;
-    
-    memcpy(hash, ciphertext, 8);
-    
-    // Try each possible position (walk backwards from end of chain)
-    for (uint32_t pos = params->chain_len - 2; pos > 0; pos--) {
-        // Compute what end_index would be if ciphertext was at position pos
-        index = hash_to_index(hash, params->reduction_offset,
-                              params->plaintext_space_total, pos);
-        
-        // Walk to end of chain
-        for (uint32_t p = pos + 1; p < params->chain_len - 1; p++) {
-            uint8_t key_56[7], key_64[8], h[8];
-            uint32_t key_len;
-            
-            index_to_plaintext(index, params->charset_len,
-                               params->plaintext_len_min, params->plaintext_len_max,
-                               params->plaintext_space_up_to_index,
-                               key_56, &key_len);
-            
-            setup_des_key(key_56, key_64);
-            netntlmv1_hash(key_64, h);
-            index = hash_to_index(h, params->reduction_offset,
-                                  params->plaintext_space_total, p);
-        }
-        
-        // Search for this end index
-        uint64_t start_index = table_search(table, index, &found);
-        
-        if (found) {
-            printf("  Potential match at pos=%u, verifying...\n", pos);
-            if (verify_chain(params, start_index, pos, ciphertext, key_out)) {
-                return 0;  // Success!
-            }
-            printf("  False alarm.\n");
-        }
-        
-        // Progress indicator
-        if (pos % 10000 == 0) {
-            printf("  Checked position %u / %u\n", params->chain_len - pos, params->chain_len);
-        }
+    uint32_t num_indices = params->chain_len - 1;
+    uint64_t *end_indices = malloc(num_indices * sizeof(uint64_t));
+    uint64_t *start_indices = malloc(num_indices * sizeof(uint64_t));
+    uint32_t *positions = malloc(num_indices * sizeof(uint32_t));
+    int ret = -1;
+    if (!end_indices || !start_indices || !positions) goto done;
+
+    if (cpu_precompute(ciphertext, params->chain_len, params->reduction_offset,
+                       params->plaintext_space_total, end_indices, cpu_count()) < 0) {
+        goto done;
     }
-    
-    return -1;  // Not found
+
+    if (table_index_pays_off(table, num_indices)) table_build_index(table);
+
+    uint32_t num_candidates = 0;
+    table_search_batch(table, end_indices, num_indices, start_indices, positions,
+                       &num_candidates, num_indices);
+    printf("  %u potential matches, verifying...\n", num_candidates);
+
+    if (cpu_check_false_alarms(ciphertext, start_indices, positions, num_candidates,
+                               params->reduction_offset, params->plaintext_space_total,
+                               key_out) == 1) {
+        ret = 0;
+    }
+
+done:
+    free(end_indices);
+    free(start_indices);
+    free(positions);
+    return ret;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <time.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -18,6 +19,12 @@
 #include "rainbow.h"
 #include "netntlmv1.h"
 #include "opencl_host.h"
+#include "cpu_host.h"
+#include "des_bs.h"
+#include "prefetch.h"
+#include "table_filter.h"
+#include "ef_index.h"
+#include <pthread.h>
 
 #define CHARSET_LEN 256
 #define PLAINTEXT_LEN_MAX 7
@@ -26,22 +33,35 @@
 #define MAX_TABLES 4096
 #define CACHE_DIR "cache"
 #define MAX_CANDIDATES (4 * 1024 * 1024)
+#define DEFAULT_PREFETCH_MB 4096
+#define STREAM_CHUNK_SIZE (8 * 1024 * 1024)
+#define DEFAULT_IO_DEPTH 32
+#define DEFAULT_IO_BLOCK_KB 1024
+#define MAX_CIPHERTEXTS 4096   // positions of every ciphertext must fit in 32 bits
+#define MAX_SEARCH_THREADS 256
+#define MIN_SLICE_QUERIES 4096  // smaller slices cost more in thread start-up than they save
+#define LOCAL_HITS_INITIAL 65536  // hits a worker's buffer holds before it first grows
 
 void print_usage(const char *prog) {
-    printf("Usage: %s <table.rt | table_directory> <ciphertext_hex>\n", prog);
-}
-
-double get_time_sec(void) {
-#ifdef _WIN32
-    LARGE_INTEGER freq, count;
-    QueryPerformanceFrequency(&freq);
-    QueryPerformanceCounter(&count);
-    return (double)count.QuadPart / (double)freq.QuadPart;
-#else
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec + tv.tv_usec / 1000000.0;
-#endif
+    printf("Usage: %s [-m prefetch_mb] [-r streams] [-s] [-i backend] [-q depth] [-b block_kb]\n"
+           "       [-c cache_dir] [-f ct_file] [-t threads] [-F filter_set] [-X index]\n"
+           "       <table.rt | table_directory> [ciphertext_hex ...]\n", prog);
+    printf("  -m  RAM budget for tables held in memory at once (default %d MB)\n",
+           DEFAULT_PREFETCH_MB);
+    printf("  -r  Reader streams per storage device (default 1)\n");
+    printf("  -s  Stream tables in %d MB chunks instead of loading them whole\n",
+           STREAM_CHUNK_SIZE / (1024 * 1024));
+    printf("  -i  Table I/O: mmap, buffered or uring (O_DIRECT) (default mmap, buffered with -s)\n");
+    printf("  -q  io_uring queue depth (default %d)\n", DEFAULT_IO_DEPTH);
+    printf("  -b  io_uring block size in KB (default %d)\n", DEFAULT_IO_BLOCK_KB);
+    printf("  -c  Map tables held by the resident table cache in this directory\n");
+    printf("  -f  Read ciphertexts from a file (one per line, '-' for stdin)\n");
+    printf("  -t  Threads searching loaded tables (default: one per CPU core)\n");
+    printf("  -F  Filter set from rtfilter: tables it covers are probed in memory and\n"
+           "      only read where the filter hits\n");
+    printf("  -X  End index from rtindex: tables it covers are searched in memory and\n"
+           "      only read for the start index of each match\n");
+    printf("Several ciphertexts are looked up together with one pass over each table.\n");
 }
 
 void get_timestamp(char *buf, size_t size) {
@@ -86,7 +106,8 @@ int is_rainbow_table(const char *filename) {
     size_t len = strlen(filename);
     if (len < 3) return 0;
     return (strcmp(filename + len - 3, ".rt") == 0) ||
-           (len >= 4 && strcmp(filename + len - 4, ".rtc") == 0);
+           (len >= 4 && strcmp(filename + len - 4, ".rte") == 0) ||
+           (len >= 5 && strcmp(filename + len - 5, ".rtef") == 0);
 }
 
 int find_tables(const char *dir_path, char **table_paths, int max_tables, int *count) {
@@ -174,50 +195,805 @@ int save_cache(const char *ct_hex, uint64_t *end_indices, uint32_t num_indices)
     return 0;
 }
 
-int collect_candidates(const char *table_path, 
-                       uint64_t *end_indices, uint32_t num_indices,
+// One contiguous slice of the sorted queries, joined by one thread into
+// its own region of the candidate buffer
+typedef struct {
+    rt_table *table;
+    const rt_query *queries;
+    uint32_t num_queries;
+    uint64_t *start_indices;
+    uint32_t *positions;
+    uint32_t count;
+    uint32_t capacity;
+} join_slice;
+
+static void *join_slice_thread(void *arg) {
+    join_slice *js = arg;
+    table_join_search(js->table, js->queries, js->num_queries, js->start_indices,
+                      js->positions, &js->count, js->capacity);
+    return NULL;
+}
+
+// Joins the sorted queries against a loaded table on num_threads threads.
+// The queries are cut into contiguous slices (never inside a run of equal
+// ends) and each slice gets the matching share of the free candidate
+// space; the slices are then packed together in query order, so the
+// result does not depend on thread timing and is the same as a one-thread
+// join.
+int collect_candidates(rt_table *table,
+                       const rt_query *queries, uint32_t num_indices,
                        uint64_t *start_indices, uint32_t *positions,
                        uint32_t *num_candidates, uint32_t max_candidates,
-                       double *search_time) {
-    
-    rt_table table = {0};
-    if (table_load(&table, table_path) != 0) return -1;
-
+                       int num_threads, double *search_time) {
     double t0 = get_time_sec();
-    
-    uint32_t found = 0;
-    for (uint32_t pos = 0; pos < num_indices && *num_candidates < max_candidates; pos++) {
-        int search_found = 0;
-        uint64_t start_index = table_search(&table, end_indices[pos], &search_found);
-        if (search_found) {
-            start_indices[*num_candidates] = start_index;
-            positions[*num_candidates] = pos;
-            (*num_candidates)++;
-            found++;
+
+    uint32_t room = max_candidates - *num_candidates;
+    if (num_threads > MAX_SEARCH_THREADS) num_threads = MAX_SEARCH_THREADS;
+    if ((uint64_t)num_threads * MIN_SLICE_QUERIES > num_indices) {
+        num_threads = num_indices / MIN_SLICE_QUERIES;
+    }
+    if (num_threads <= 1 || room < (uint32_t)num_threads) {
+        int found = table_join_search(table, queries, num_indices, start_indices, positions,
+                                      num_candidates, max_candidates);
+        *search_time = get_time_sec() - t0;
+        return found;
+    }
+
+    join_slice slices[MAX_SEARCH_THREADS];
+    pthread_t threads[MAX_SEARCH_THREADS];
+    int started[MAX_SEARCH_THREADS] = {0};
+    uint32_t lo = 0;
+    for (int k = 0; k < num_threads; k++) {
+        uint32_t hi = (uint32_t)((uint64_t)num_indices * (k + 1) / num_threads);
+        while (hi > lo && hi < num_indices && queries[hi].end == queries[hi - 1].end) hi++;
+        if (hi < lo) hi = lo;
+
+        uint32_t region = *num_candidates + (uint32_t)((uint64_t)room * lo / num_indices);
+        uint32_t region_end = *num_candidates + (uint32_t)((uint64_t)room * hi / num_indices);
+        slices[k] = (join_slice){
+            .table = table, .queries = queries + lo, .num_queries = hi - lo,
+            .start_indices = start_indices + region, .positions = positions + region,
+            .count = 0, .capacity = region_end - region,
+        };
+        lo = hi;
+    }
+
+    // Slice 0 runs on this thread; a slice whose thread cannot start does too
+    for (int k = 1; k < num_threads; k++) {
+        started[k] = pthread_create(&threads[k], NULL, join_slice_thread, &slices[k]) == 0;
+    }
+    join_slice_thread(&slices[0]);
+    for (int k = 1; k < num_threads; k++) {
+        if (started[k]) pthread_join(threads[k], NULL);
+        else join_slice_thread(&slices[k]);
+    }
+
+    // Regions are in query order and no slice outgrows its own, so packing
+    // front to back never overwrites a slice that has not moved yet. A
+    // slice that filled its share (duplicate ends) may have been cut short;
+    // it and everything after it are joined again here into the space left.
+    int found = 0;
+    for (int k = 0; k < num_threads; k++) {
+        join_slice *js = &slices[k];
+        if (js->num_queries > 0 && js->count == js->capacity) {
+            found += table_join_search(table, js->queries,
+                                       num_indices - (uint32_t)(js->queries - queries),
+                                       start_indices, positions, num_candidates, max_candidates);
+            break;
         }
+        memmove(start_indices + *num_candidates, js->start_indices, js->count * sizeof(uint64_t));
+        memmove(positions + *num_candidates, js->positions, js->count * sizeof(uint32_t));
+        *num_candidates += js->count;
+        found += js->count;
     }
-    
     *search_time = get_time_sec() - t0;
-    printf("      [search: %.2fs]\n", *search_time);
-    
-    table_free(&table);
     return found;
 }
 
+void print_progress(int done, int num_tables, uint32_t total_candidates, double step_start) {
+    double elapsed = get_time_sec() - step_start;
+    double rate = done / elapsed;
+    double eta = (num_tables - done) / rate;
+    char eta_buf[32];
+    format_time(eta, eta_buf, sizeof(eta_buf));
+    printf("\r         [%d/%d] %u candidates | ETA: %s        ", 
+           done, num_tables, total_candidates, eta_buf);
+    fflush(stdout);
+}
+
+// Hits of one table, held until every table before it has been merged
+typedef struct {
+    uint64_t *start_indices;
+    uint32_t *positions;
+    uint32_t count;
+    int ready;
+} table_hits;
+
+// Appends the tables' hits to the candidate arrays in table order, however
+// the tables finish, so the candidate list (and which tables' hits survive
+// a full buffer) is the same on every run.
+typedef struct {
+    table_hits *tables;
+    int num_tables;
+    int next;                  // first table not merged yet
+    uint64_t *start_indices;
+    uint32_t *positions;
+    uint32_t *total_candidates;
+    uint32_t max_candidates;
+} table_merge;
+
+static int merge_init(table_merge *m, int num_tables, uint64_t *start_indices,
+                      uint32_t *positions, uint32_t *total_candidates,
+                      uint32_t max_candidates) {
+    *m = (table_merge){
+        .tables = calloc(num_tables > 0 ? num_tables : 1, sizeof(table_hits)),
+        .num_tables = num_tables,
+        .start_indices = start_indices, .positions = positions,
+        .total_candidates = total_candidates, .max_candidates = max_candidates,
+    };
+    return m->tables ? 0 : -1;
+}
+
+static void merge_append(table_merge *m, table_hits *h) {
+    uint32_t room = m->max_candidates - *m->total_candidates;
+    uint32_t count = h->count < room ? h->count : room;
+    if (count > 0) {
+        memcpy(m->start_indices + *m->total_candidates, h->start_indices, count * sizeof(uint64_t));
+        memcpy(m->positions + *m->total_candidates, h->positions, count * sizeof(uint32_t));
+        *m->total_candidates += count;
+    }
+    free(h->start_indices);
+    free(h->positions);
+    h->start_indices = NULL;
+    h->positions = NULL;
+}
+
+// Takes a copy of table t's hits (made outside the caller's lock) and
+// merges every table that is now next in line. Call with the lock held.
+static void merge_table(table_merge *m, int t, uint64_t *start_indices, uint32_t *positions,
+                        uint32_t count) {
+    table_hits *h = &m->tables[t];
+    h->start_indices = start_indices;
+    h->positions = positions;
+    h->count = count;
+    h->ready = 1;
+    while (m->next < m->num_tables && m->tables[m->next].ready) {
+        merge_append(m, &m->tables[m->next++]);
+    }
+}
+
+// Copies count hits for merge_table; on failure the table's hits are lost
+static int copy_hits(const uint64_t *start_indices, const uint32_t *positions, uint32_t count,
+                     uint64_t **starts_copy, uint32_t **positions_copy) {
+    *starts_copy = malloc((count ? count : 1) * sizeof(uint64_t));
+    *positions_copy = malloc((count ? count : 1) * sizeof(uint32_t));
+    if (!*starts_copy || !*positions_copy) {
+        free(*starts_copy);
+        free(*positions_copy);
+        *starts_copy = NULL;
+        *positions_copy = NULL;
+        return -1;
+    }
+    memcpy(*starts_copy, start_indices, count * sizeof(uint64_t));
+    memcpy(*positions_copy, positions, count * sizeof(uint32_t));
+    return 0;
+}
+
+// Merges what is left once the workers are done (tables after one a worker
+// never finished), still in table order, and frees the held hits.
+static void merge_finish(table_merge *m) {
+    for (; m->next < m->num_tables; m->next++) {
+        if (m->tables[m->next].ready) merge_append(m, &m->tables[m->next]);
+    }
+    free(m->tables);
+    m->tables = NULL;
+}
+
+// A worker's buffer for one table's hits. A table matches a small share
+// of the queries, so the buffer starts small and doubles, up to one hit
+// per query, whenever a table fills it; that table is searched again.
+typedef struct {
+    uint64_t *start_indices;
+    uint32_t *positions;
+    uint32_t capacity;
+    uint32_t limit;
+} hit_buffer;
+
+static int hit_buffer_init(hit_buffer *b, uint32_t limit) {
+    b->limit = limit > 0 ? limit : 1;
+    b->capacity = b->limit < LOCAL_HITS_INITIAL ? b->limit : LOCAL_HITS_INITIAL;
+    b->start_indices = malloc(b->capacity * sizeof(uint64_t));
+    b->positions = malloc(b->capacity * sizeof(uint32_t));
+    if (b->start_indices && b->positions) return 0;
+    free(b->start_indices);
+    free(b->positions);
+    return -1;
+}
+
+// Returns -1 if the buffer is already at its limit or cannot grow
+static int hit_buffer_grow(hit_buffer *b) {
+    if (b->capacity >= b->limit) return -1;
+    uint32_t capacity = b->capacity > b->limit / 2 ? b->limit : b->capacity * 2;
+    uint64_t *starts = realloc(b->start_indices, capacity * sizeof(uint64_t));
+    if (!starts) return -1;
+    b->start_indices = starts;
+    uint32_t *positions = realloc(b->positions, capacity * sizeof(uint32_t));
+    if (!positions) return -1;
+    b->positions = positions;
+    b->capacity = capacity;
+    return 0;
+}
+
+static void hit_buffer_free(hit_buffer *b) {
+    free(b->start_indices);
+    free(b->positions);
+}
+
+typedef struct {
+    table_prefetcher *pf;
+    char **table_paths;
+    int num_tables;
+    uint32_t num_indices;
+    const rt_query *queries;
+    uint32_t *total_candidates;
+    uint32_t max_candidates;
+    int join_threads;          // threads each worker splits one table's join across
+    double step_start;
+    pthread_mutex_t lock;      // guards everything below and the outputs
+    table_merge merge;
+    int done;
+    double search_time;
+} search_pool;
+
+// Search worker: takes whichever table is ready and searches it into a
+// local buffer; the hits are merged into the shared candidate arrays in
+// table order.
+static void *search_worker(void *arg) {
+    search_pool *sp = arg;
+    hit_buffer local;
+    if (hit_buffer_init(&local, sp->num_indices) != 0) {
+        fprintf(stderr, "\nError: Failed to allocate search buffers\n");
+        return NULL;
+    }
+
+    prefetch_slot *slot;
+    while ((slot = prefetch_next(sp->pf)) != NULL) {
+        uint32_t count = 0;
+        double search_time = 0;
+        int t = slot->index;
+        if (slot->status != 0) {
+            fprintf(stderr, "\nWarning: Failed to load %s\n", sp->table_paths[t]);
+        } else {
+            for (;;) {
+                double join_time;
+                count = 0;
+                collect_candidates(&slot->table, sp->queries, sp->num_indices,
+                                   local.start_indices, local.positions, &count,
+                                   local.capacity, sp->join_threads, &join_time);
+                search_time += join_time;
+                if (count < local.capacity || hit_buffer_grow(&local) != 0) break;
+            }
+        }
+        prefetch_release(sp->pf, slot);
+
+        uint64_t *starts;
+        uint32_t *positions;
+        if (copy_hits(local.start_indices, local.positions, count, &starts, &positions) != 0) {
+            fprintf(stderr, "\nWarning: Out of memory, dropped hits of %s\n", sp->table_paths[t]);
+            count = 0;
+        }
+
+        pthread_mutex_lock(&sp->lock);
+        merge_table(&sp->merge, t, starts, positions, count);
+        sp->search_time += search_time;
+        sp->done++;
+        print_progress(sp->done, sp->num_tables, *sp->total_candidates, sp->step_start);
+        int full = *sp->total_candidates >= sp->max_candidates;
+        pthread_mutex_unlock(&sp->lock);
+
+        if (full) break;
+    }
+
+    hit_buffer_free(&local);
+    return NULL;
+}
+
+// Tables are loaded whole by per-device background readers and searched
+// by a pool of workers, one per device. The search threads are shared out
+// between the workers, each splitting its table's join across its share.
+int collect_prefetched(char **table_paths, int num_tables,
+                       uint64_t *end_indices, uint32_t num_indices,
+                       uint64_t *start_indices, uint32_t *positions,
+                       uint32_t *total_candidates, uint32_t max_candidates,
+                       uint64_t ram_budget, int streams_per_device, int search_threads,
+                       double step_start) {
+    char time_buf[64], num_buf[64];
+
+    rt_query *queries = queries_build(end_indices, num_indices);
+    if (!queries) {
+        fprintf(stderr, "Error: Failed to allocate query buffer\n");
+        return -1;
+    }
+
+    table_prefetcher pf;
+    if (prefetch_start(&pf, table_paths, num_tables, ram_budget, streams_per_device, 0) != 0) {
+        fprintf(stderr, "Error: Failed to start table readers\n");
+        free(queries);
+        return -1;
+    }
+    int num_devices = pf.num_devices, num_readers = pf.num_readers, depth = pf.depth;
+
+    int num_workers = num_devices;
+    int join_threads = search_threads / num_workers;
+    if (join_threads < 1) join_threads = 1;
+
+    search_pool sp = {
+        .pf = &pf, .table_paths = table_paths, .num_tables = num_tables,
+        .num_indices = num_indices, .queries = queries,
+        .total_candidates = total_candidates, .max_candidates = max_candidates,
+        .join_threads = join_threads, .step_start = step_start,
+    };
+    if (merge_init(&sp.merge, num_tables, start_indices, positions, total_candidates,
+                   max_candidates) != 0) {
+        fprintf(stderr, "Error: Failed to allocate merge buffers\n");
+        prefetch_stop(&pf);
+        free(queries);
+        return -1;
+    }
+    pthread_mutex_init(&sp.lock, NULL);
+
+    pthread_t *workers = calloc(num_workers, sizeof(pthread_t));
+    int started = 0;
+    while (workers && started < num_workers &&
+           pthread_create(&workers[started], NULL, search_worker, &sp) == 0) {
+        started++;
+    }
+    if (started == 0) search_worker(&sp);
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+    free(workers);
+
+    merge_finish(&sp.merge);
+    prefetch_stop(&pf);
+    double io_time = pf.io_time, exposed_time = pf.exposed_time;
+    pthread_mutex_destroy(&sp.lock);
+    free(queries);
+
+    format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
+    format_number(*total_candidates, num_buf, sizeof(num_buf));
+    printf("\r         Collected %s candidates - %s                    \n", num_buf, time_buf);
+
+    // Wall-clock times: I/O that ran while a table was being searched is
+    // hidden; only the time tables were loading and nothing was searched
+    // is exposed. Search time is summed over the workers.
+    double overlapped = io_time - exposed_time;
+    if (overlapped < 0) overlapped = 0;
+    char load_buf[32], search_buf[32], wait_buf[32];
+    format_time(io_time, load_buf, sizeof(load_buf));
+    format_time(sp.search_time, search_buf, sizeof(search_buf));
+    format_time(exposed_time, wait_buf, sizeof(wait_buf));
+    printf("         Load: %s | Search: %s | Stalled: %s (%.0f%% of I/O overlapped)\n",
+           load_buf, search_buf, wait_buf,
+           io_time > 0 ? 100.0 * overlapped / io_time : 100.0);
+    printf("         %d device(s), %d reader stream(s), %d search worker(s) x %d thread(s), "
+           "%d table buffer(s)\n\n", num_devices, num_readers, num_workers, join_threads, depth);
+    return 0;
+}
+
+// Tables are scanned sequentially in fixed-size chunks and merge-joined
+// against the sorted end indices; only one chunk is resident at a time.
+int collect_streamed(char **table_paths, int num_tables,
+                     uint64_t *end_indices, uint32_t num_indices,
+                     uint64_t *start_indices, uint32_t *positions,
+                     uint32_t *total_candidates, uint32_t max_candidates,
+                     double step_start) {
+    char time_buf[64], num_buf[64];
+
+    rt_query *queries = queries_build(end_indices, num_indices);
+    if (!queries) {
+        fprintf(stderr, "Error: Failed to allocate query buffer\n");
+        return -1;
+    }
+
+    for (int t = 0; t < num_tables; t++) {
+        if (table_stream_search(table_paths[t], queries, num_indices, STREAM_CHUNK_SIZE,
+                                start_indices, positions, total_candidates,
+                                max_candidates) < 0) {
+            fprintf(stderr, "\nWarning: Failed to read %s\n", table_paths[t]);
+        }
+
+        print_progress(t + 1, num_tables, *total_candidates, step_start);
+        if (*total_candidates >= max_candidates) break;
+    }
+    free(queries);
+
+    format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
+    format_number(*total_candidates, num_buf, sizeof(num_buf));
+    printf("\r         Collected %s candidates - %s                    \n\n", num_buf, time_buf);
+    return 0;
+}
+
+typedef struct {
+    const ef_index *ix;
+    char **table_paths;
+    int num_tables;
+    const rt_query *queries;
+    uint32_t num_indices;
+    uint32_t *total_candidates;
+    uint32_t max_candidates;
+    double step_start;
+    pthread_mutex_t lock;      // guards everything below and the outputs
+    table_merge merge;
+    int next;
+    int done;
+    ef_index_stats stats;
+} index_pool;
+
+// Index worker: searches the next covered table into a local buffer; the
+// hits are merged into the shared candidate arrays in table order.
+static void *index_worker(void *arg) {
+    index_pool *ip = arg;
+    hit_buffer local;
+    if (hit_buffer_init(&local, ip->num_indices) != 0) {
+        fprintf(stderr, "\nError: Failed to allocate search buffers\n");
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&ip->lock);
+        int t = ip->next++;
+        int full = *ip->total_candidates >= ip->max_candidates;
+        pthread_mutex_unlock(&ip->lock);
+        if (t >= ip->num_tables || full) break;
+
+        uint32_t count;
+        ef_index_stats stats;
+        const ef_index_entry *e = ef_index_find(ip->ix, ip->table_paths[t]);
+        for (;;) {
+            count = 0;
+            memset(&stats, 0, sizeof(stats));
+            if (ef_index_search(ip->ix, e, ip->table_paths[t], ip->queries, ip->num_indices,
+                                local.start_indices, local.positions, &count, local.capacity,
+                                &stats) < 0) {
+                fprintf(stderr, "\nWarning: Failed to read %s\n", ip->table_paths[t]);
+                break;
+            }
+            if (count < local.capacity || hit_buffer_grow(&local) != 0) break;
+        }
+
+        uint64_t *starts;
+        uint32_t *positions;
+        if (copy_hits(local.start_indices, local.positions, count, &starts, &positions) != 0) {
+            fprintf(stderr, "\nWarning: Out of memory, dropped hits of %s\n", ip->table_paths[t]);
+            count = 0;
+        }
+
+        pthread_mutex_lock(&ip->lock);
+        merge_table(&ip->merge, t, starts, positions, count);
+        ip->stats.queries += stats.queries;
+        ip->stats.blocks += stats.blocks;
+        ip->stats.reads += stats.reads;
+        ip->done++;
+        print_progress(ip->done, ip->num_tables, *ip->total_candidates, ip->step_start);
+        pthread_mutex_unlock(&ip->lock);
+    }
+
+    hit_buffer_free(&local);
+    return NULL;
+}
+
+// Tables covered by the end index are searched in memory, one per thread,
+// and read only for the start index of each match; they are moved to the
+// front of table_paths. Returns how many were searched this way, or -1 on
+// error.
+int collect_indexed(const ef_index *ix, char **table_paths, int num_tables,
+                    uint64_t *end_indices, uint32_t num_indices,
+                    uint64_t *start_indices, uint32_t *positions,
+                    uint32_t *total_candidates, uint32_t max_candidates,
+                    int search_threads, double step_start) {
+    char time_buf[64], num_buf[64];
+
+    int covered = 0;
+    for (int t = 0; t < num_tables; t++) {
+        if (!ef_index_find(ix, table_paths[t])) continue;
+        char *path = table_paths[t];
+        table_paths[t] = table_paths[covered];
+        table_paths[covered++] = path;
+    }
+    if (covered == 0) {
+        printf("         No table is covered by the index\n\n");
+        return 0;
+    }
+
+    rt_query *queries = queries_build(end_indices, num_indices);
+    if (!queries) {
+        fprintf(stderr, "Error: Failed to allocate query buffer\n");
+        return -1;
+    }
+
+    index_pool ip = {
+        .ix = ix, .table_paths = table_paths, .num_tables = covered,
+        .queries = queries, .num_indices = num_indices,
+        .total_candidates = total_candidates, .max_candidates = max_candidates,
+        .step_start = step_start,
+    };
+    if (merge_init(&ip.merge, covered, start_indices, positions, total_candidates,
+                   max_candidates) != 0) {
+        fprintf(stderr, "Error: Failed to allocate merge buffers\n");
+        free(queries);
+        return -1;
+    }
+    pthread_mutex_init(&ip.lock, NULL);
+
+    int num_workers = search_threads < covered ? search_threads : covered;
+    pthread_t *workers = calloc(num_workers, sizeof(pthread_t));
+    int started = 0;
+    while (workers && started < num_workers &&
+           pthread_create(&workers[started], NULL, index_worker, &ip) == 0) {
+        started++;
+    }
+    if (started == 0) index_worker(&ip);
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+    free(workers);
+    merge_finish(&ip.merge);
+    pthread_mutex_destroy(&ip.lock);
+    free(queries);
+
+    format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
+    format_number(*total_candidates, num_buf, sizeof(num_buf));
+    printf("\r         Collected %s candidates from %d indexed table(s) - %s        \n",
+           num_buf, covered, time_buf);
+    printf("         %llu end indices in range, %llu blocks searched, %llu starts read, "
+           "%d thread(s)\n\n", (unsigned long long)ip.stats.queries,
+           (unsigned long long)ip.stats.blocks, (unsigned long long)ip.stats.reads,
+           started ? started : 1);
+    return covered;
+}
+
+// Tables covered by the filter set are probed in memory and read only
+// where their filter hits; they are moved to the front of table_paths.
+// Returns how many were searched this way, or -1 on error.
+int collect_filtered(const table_filter_set *fs, char **table_paths, int num_tables,
+                     uint64_t *end_indices, uint32_t num_indices,
+                     uint64_t *start_indices, uint32_t *positions,
+                     uint32_t *total_candidates, uint32_t max_candidates,
+                     double step_start) {
+    char time_buf[64], num_buf[64];
+
+    int covered = 0;
+    for (int t = 0; t < num_tables; t++) {
+        if (!table_filter_find(fs, table_paths[t])) continue;
+        char *path = table_paths[t];
+        table_paths[t] = table_paths[covered];
+        table_paths[covered++] = path;
+    }
+    if (covered == 0) {
+        printf("         No table is covered by the filter set\n\n");
+        return 0;
+    }
+
+    rt_query *queries = queries_build(end_indices, num_indices);
+    if (!queries) {
+        fprintf(stderr, "Error: Failed to allocate query buffer\n");
+        return -1;
+    }
+
+    table_filter_stats stats = {0};
+    for (int t = 0; t < covered; t++) {
+        const table_filter_entry *e = table_filter_find(fs, table_paths[t]);
+        if (table_filter_search(fs, e, table_paths[t], queries, num_indices, start_indices,
+                                positions, total_candidates, max_candidates, &stats) < 0) {
+            fprintf(stderr, "\nWarning: Failed to read %s\n", table_paths[t]);
+        }
+
+        print_progress(t + 1, covered, *total_candidates, step_start);
+        if (*total_candidates >= max_candidates) break;
+    }
+    free(queries);
+
+    format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
+    format_number(*total_candidates, num_buf, sizeof(num_buf));
+    printf("\r         Collected %s candidates from %d filtered table(s) - %s        \n",
+           num_buf, covered, time_buf);
+    printf("         %llu probes, %llu filter hits, %llu confirmed; read %llu regions (%.1f MB)\n\n",
+           (unsigned long long)stats.probes, (unsigned long long)stats.filter_hits,
+           (unsigned long long)stats.confirmed, (unsigned long long)stats.reads,
+           stats.read_bytes / (1024.0 * 1024.0));
+    return covered;
+}
+
+typedef struct {
+    char hex[17];
+    uint8_t bytes[8];
+    uint64_t *end_indices;     // this ciphertext's slice of the combined array
+    uint32_t num_candidates;
+    int found;
+    char key[15];
+} target;
+
+// Adds one ciphertext unless it is already in the batch
+static int add_target(target *targets, int *num_targets, const char *hex) {
+    uint8_t bytes[8];
+    if (strlen(hex) != 16 || hex_to_bytes(hex, bytes, 8) != 8) {
+        fprintf(stderr, "Error: Invalid ciphertext '%s' (need 16 hex chars)\n", hex);
+        return -1;
+    }
+    for (int i = 0; i < *num_targets; i++) {
+        if (memcmp(targets[i].bytes, bytes, 8) == 0) return 0;
+    }
+    if (*num_targets >= MAX_CIPHERTEXTS) {
+        fprintf(stderr, "Error: More than %d ciphertexts\n", MAX_CIPHERTEXTS);
+        return -1;
+    }
+    target *t = &targets[(*num_targets)++];
+    memset(t, 0, sizeof(target));
+    snprintf(t->hex, sizeof(t->hex), "%s", hex);
+    memcpy(t->bytes, bytes, 8);
+    return 0;
+}
+
+// One ciphertext per line; blank lines and # comments are skipped
+static int read_targets(const char *filename, target *targets, int *num_targets) {
+    FILE *f = strcmp(filename, "-") == 0 ? stdin : fopen(filename, "r");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot open %s\n", filename);
+        return -1;
+    }
+
+    char line[256];
+    int ret = 0;
+    while (ret == 0 && fgets(line, sizeof(line), f)) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        char *end = p + strcspn(p, " \t\r\n#");
+        if (end == p) continue;
+        *end = '\0';
+        ret = add_target(targets, num_targets, p);
+    }
+    if (f != stdin) fclose(f);
+    return ret;
+}
+
+// Groups the combined candidates by ciphertext (stable, so each group keeps
+// table order) and turns combined positions back into chain positions.
+// Returns per-ciphertext offsets into the reordered arrays.
+static uint32_t *group_candidates(target *targets, int num_targets, uint32_t num_indices,
+                                  uint64_t *start_indices, uint32_t *positions,
+                                  uint32_t total_candidates) {
+    uint32_t *offsets = calloc(num_targets + 1, sizeof(uint32_t));
+    uint64_t *starts = malloc((size_t)total_candidates * sizeof(uint64_t) + 1);
+    uint32_t *pos = malloc((size_t)total_candidates * sizeof(uint32_t) + 1);
+    if (!offsets || !starts || !pos) {
+        free(offsets);
+        free(starts);
+        free(pos);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < total_candidates; i++) offsets[positions[i] / num_indices + 1]++;
+    for (int t = 0; t < num_targets; t++) {
+        targets[t].num_candidates = offsets[t + 1];
+        offsets[t + 1] += offsets[t];
+    }
+
+    uint32_t *fill = malloc(num_targets * sizeof(uint32_t));
+    if (!fill) {
+        free(offsets);
+        free(starts);
+        free(pos);
+        return NULL;
+    }
+    memcpy(fill, offsets, num_targets * sizeof(uint32_t));
+    for (uint32_t i = 0; i < total_candidates; i++) {
+        uint32_t t = positions[i] / num_indices;
+        starts[fill[t]] = start_indices[i];
+        pos[fill[t]] = positions[i] % num_indices;
+        fill[t]++;
+    }
+
+    memcpy(start_indices, starts, (size_t)total_candidates * sizeof(uint64_t));
+    memcpy(positions, pos, (size_t)total_candidates * sizeof(uint32_t));
+    free(fill);
+    free(starts);
+    free(pos);
+    return offsets;
+}
+
 int main(int argc, char **argv) {
-    if (argc < 3) {
+    uint64_t prefetch_mb = DEFAULT_PREFETCH_MB;
+    int streams_per_device = 1;
+    int stream = 0;
+    int io_set = 0;
+    table_io_backend io_backend = TABLE_IO_MMAP;
+    unsigned io_depth = DEFAULT_IO_DEPTH;
+    size_t io_block_kb = DEFAULT_IO_BLOCK_KB;
+    const char *cache_dir = NULL;
+    const char *ct_file = NULL;
+    const char *filter_file = NULL;
+    const char *index_file = NULL;
+    int search_threads = cpu_count();
+    int opt;
+    while ((opt = getopt(argc, argv, "m:r:si:q:b:c:f:t:F:X:")) != -1) {
+        switch (opt) {
+        case 'm':
+            prefetch_mb = strtoull(optarg, NULL, 10);
+            break;
+        case 'r':
+            streams_per_device = atoi(optarg);
+            break;
+        case 's':
+            stream = 1;
+            break;
+        case 'i':
+            if (table_io_parse(optarg, &io_backend) != 0) {
+                fprintf(stderr, "Error: Unknown I/O backend '%s'\n", optarg);
+                return 1;
+            }
+            io_set = 1;
+            break;
+        case 'q':
+            io_depth = strtoul(optarg, NULL, 10);
+            break;
+        case 'b':
+            io_block_kb = strtoull(optarg, NULL, 10);
+            break;
+        case 'c':
+            cache_dir = optarg;
+            break;
+        case 'f':
+            ct_file = optarg;
+            break;
+        case 't':
+            search_threads = atoi(optarg);
+            if (search_threads < 1) search_threads = 1;
+            break;
+        case 'F':
+            filter_file = optarg;
+            break;
+        case 'X':
+            index_file = optarg;
+            break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (argc - optind < (ct_file ? 1 : 2)) {
         print_usage(argv[0]);
         return 1;
     }
 
-    const char *path = argv[1];
-    const char *ct_hex = argv[2];
+    // Streaming has always used plain sequential reads
+    if (stream && !io_set) io_backend = TABLE_IO_BUFFERED;
+    table_set_io(io_backend, io_depth, io_block_kb * 1024);
+    if (cache_dir && table_set_cache(cache_dir) != 0) {
+        fprintf(stderr, "Warning: No table cache in %s, reading tables from disk\n", cache_dir);
+        cache_dir = NULL;
+    }
+
+    const char *path = argv[optind];
     double total_start = get_time_sec();
     char time_buf[64], num_buf[64], ts[16];
 
-    uint8_t ciphertext[8];
-    if (hex_to_bytes(ct_hex, ciphertext, 8) != 8) {
-        fprintf(stderr, "Error: Invalid ciphertext (need 16 hex chars)\n");
+    target *targets = malloc(MAX_CIPHERTEXTS * sizeof(target));
+    int num_targets = 0;
+    if (!targets) {
+        fprintf(stderr, "Error: Failed to allocate memory\n");
+        return 1;
+    }
+    for (int i = optind + 1; i < argc; i++) {
+        if (add_target(targets, &num_targets, argv[i]) != 0) {
+            free(targets);
+            return 1;
+        }
+    }
+    if (ct_file && read_targets(ct_file, targets, &num_targets) != 0) {
+        free(targets);
+        return 1;
+    }
+    if (num_targets == 0) {
+        fprintf(stderr, "Error: No ciphertexts given\n");
+        free(targets);
         return 1;
     }
 
@@ -228,7 +1004,10 @@ int main(int argc, char **argv) {
     printf("+--------------------------------------------------------------+\n");
     printf("| Started: %-52s|\n", ts);
     printf("+--------------------------------------------------------------+\n\n");
-    printf("Target: %s\n\n", ct_hex);
+    if (num_targets == 1) printf("Target: %s\n", targets[0].hex);
+    else printf("Targets: %d ciphertexts, one pass over each table\n", num_targets);
+    printf("Table I/O: %s%s%s\n\n", table_io_name(io_backend),
+           cache_dir ? ", resident cache " : "", cache_dir ? cache_dir : "");
 
     char **table_paths = calloc(MAX_TABLES, sizeof(char *));
     int num_tables = 0;
@@ -239,6 +1018,7 @@ int main(int argc, char **argv) {
         if (find_tables(path, table_paths, MAX_TABLES, &num_tables) != 0 || num_tables == 0) {
             fprintf(stderr, "Error: No rainbow tables found\n");
             free(table_paths);
+            free(targets);
             return 1;
         }
         printf("         Found %d table(s)\n\n", num_tables);
@@ -248,75 +1028,92 @@ int main(int argc, char **argv) {
         num_tables = 1;
     }
 
+    uint64_t plaintext_space_total = 1;
+    for (int i = 0; i < PLAINTEXT_LEN_MAX; i++)
+        plaintext_space_total *= CHARSET_LEN;
+
     get_timestamp(ts, sizeof(ts));
     printf("[%s] Initializing GPU...\n", ts);
     double step_start = get_time_sec();
 
+    // Without a usable GPU both chain walking phases run on the CPU
     gpu_context gpu = {0};
-    if (gpu_init(&gpu) != 0) {
-        fprintf(stderr, "Error: Failed to initialize GPU\n");
-        for (int i = 0; i < num_tables; i++) free(table_paths[i]);
-        free(table_paths);
-        return 1;
-    }
+    int have_gpu = gpu_init(&gpu) == 0;
     format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
-    printf("         %s (%u CUs) - %s\n\n", gpu.device_name, gpu.compute_units, time_buf);
-
-    get_timestamp(ts, sizeof(ts));
-    printf("[%s] Loading kernels...\n", ts);
-    step_start = get_time_sec();
+    if (have_gpu) {
+        printf("         %s (%u CUs) - %s\n\n", gpu.device_name, gpu.compute_units, time_buf);
 
-    if (gpu_load_kernel(&gpu, "kernels/precompute.cl", "precompute") != 0 ||
-        gpu_load_false_alarm_kernel(&gpu, "kernels/false_alarm.cl") != 0) {
-        fprintf(stderr, "Error: Failed to load kernels\n");
+        get_timestamp(ts, sizeof(ts));
+        printf("[%s] Loading kernels...\n", ts);
+        step_start = get_time_sec();
+        gpu_set_table_params(&gpu, REDUCTION_OFFSET, plaintext_space_total);
+        if (gpu_load_kernel(&gpu, "kernels/precompute.cl", "precompute") != 0 ||
+            gpu_load_false_alarm_kernel(&gpu, "kernels/false_alarm.cl") != 0) {
+            fprintf(stderr, "Warning: Failed to load kernels\n");
+            have_gpu = 0;
+        }
+        format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
+        if (have_gpu) printf("         Done - %s\n\n", time_buf);
+    }
+    if (!have_gpu) {
         gpu_cleanup(&gpu);
-        for (int i = 0; i < num_tables; i++) free(table_paths[i]);
-        free(table_paths);
-        return 1;
+        printf("         No GPU, walking chains on the CPU (%d threads, %s) - %s\n\n",
+               search_threads, des_bs_engine(), time_buf);
     }
-    format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
-    printf("         Done - %s\n\n", time_buf);
-
-    uint64_t plaintext_space_total = 1;
-    for (int i = 0; i < PLAINTEXT_LEN_MAX; i++)
-        plaintext_space_total *= CHARSET_LEN;
 
+    // End indices of every ciphertext back to back; combined position
+    // t * num_indices + pos identifies the ciphertext and chain position
     uint32_t num_indices = CHAIN_LEN - 1;
-    uint64_t *end_indices = malloc(num_indices * sizeof(uint64_t));
+    uint32_t total_indices = num_indices * num_targets;
+    uint64_t *end_indices = malloc((size_t)total_indices * sizeof(uint64_t));
     if (!end_indices) {
         fprintf(stderr, "Error: Failed to allocate memory\n");
         gpu_cleanup(&gpu);
         for (int i = 0; i < num_tables; i++) free(table_paths[i]);
         free(table_paths);
+        free(targets);
         return 1;
     }
 
     get_timestamp(ts, sizeof(ts));
     printf("[%s] Precomputing end indices...\n", ts);
 
-    if (load_cache(ct_hex, end_indices, num_indices) == 0) {
-        printf("         Loaded from cache\n\n");
-    } else {
+    for (int t = 0; t < num_targets; t++) {
+        target *tg = &targets[t];
+        tg->end_indices = end_indices + (size_t)t * num_indices;
+        if (num_targets > 1) printf("         %s: ", tg->hex);
+        else printf("         ");
+
+        if (load_cache(tg->hex, tg->end_indices, num_indices) == 0) {
+            printf("Loaded from cache\n");
+            continue;
+        }
+
         step_start = get_time_sec();
-        int result = gpu_precompute(&gpu, ciphertext, CHAIN_LEN, REDUCTION_OFFSET,
-                                     plaintext_space_total, end_indices);
+        int result = have_gpu ?
+            gpu_precompute(&gpu, tg->bytes, CHAIN_LEN, REDUCTION_OFFSET,
+                           plaintext_space_total, tg->end_indices) :
+            cpu_precompute(tg->bytes, CHAIN_LEN, REDUCTION_OFFSET, plaintext_space_total,
+                           tg->end_indices, search_threads);
         if (result < 0) {
-            fprintf(stderr, "Error: GPU precomputation failed\n");
+            fprintf(stderr, "Error: Precomputation failed\n");
             free(end_indices);
             gpu_cleanup(&gpu);
             for (int i = 0; i < num_tables; i++) free(table_paths[i]);
             free(table_paths);
+            free(targets);
             return 1;
         }
         format_number(result, num_buf, sizeof(num_buf));
         format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
-        printf("         Computed %s indices - %s\n", num_buf, time_buf);
-        save_cache(ct_hex, end_indices, num_indices);
-        printf("\n");
+        printf("Computed %s indices - %s\n", num_buf, time_buf);
+        save_cache(tg->hex, tg->end_indices, num_indices);
     }
+    printf("\n");
 
-    uint64_t *start_indices = malloc(MAX_CANDIDATES * sizeof(uint64_t));
-    uint32_t *positions = malloc(MAX_CANDIDATES * sizeof(uint32_t));
+    uint32_t max_candidates = MAX_CANDIDATES * (uint32_t)(num_targets < 16 ? num_targets : 16);
+    uint64_t *start_indices = malloc((size_t)max_candidates * sizeof(uint64_t));
+    uint32_t *positions = malloc((size_t)max_candidates * sizeof(uint32_t));
     if (!start_indices || !positions) {
         fprintf(stderr, "Error: Failed to allocate candidate buffers\n");
         free(end_indices);
@@ -325,6 +1122,7 @@ int main(int argc, char **argv) {
         gpu_cleanup(&gpu);
         for (int i = 0; i < num_tables; i++) free(table_paths[i]);
         free(table_paths);
+        free(targets);
         return 1;
     }
 
@@ -333,47 +1131,97 @@ int main(int argc, char **argv) {
     step_start = get_time_sec();
 
     uint32_t total_candidates = 0;
-    for (int t = 0; t < num_tables; t++) {
-        double search_time;
-        collect_candidates(table_paths[t], end_indices, num_indices,
-                        start_indices, positions, &total_candidates, MAX_CANDIDATES,
-                        &search_time);
-        double elapsed = get_time_sec() - step_start;
-        double rate = (t + 1) / elapsed;
-        double eta = (num_tables - t - 1) / rate;
-        char eta_buf[32];
-        format_time(eta, eta_buf, sizeof(eta_buf));
-        printf("\r         [%d/%d] %u candidates | ETA: %s        ", 
-               t + 1, num_tables, total_candidates, eta_buf);
-        fflush(stdout);
-        
-        if (total_candidates >= MAX_CANDIDATES) break;
+    int collect_result = 0;
+    int indexed = 0, filtered = 0;
+    if (index_file) {
+        ef_index ix;
+        if (ef_index_open(&ix, index_file) != 0) {
+            fprintf(stderr, "Warning: Cannot open index %s, searching every table\n",
+                    index_file);
+        } else {
+            indexed = collect_indexed(&ix, table_paths, num_tables, end_indices,
+                                      total_indices, start_indices, positions,
+                                      &total_candidates, max_candidates, search_threads,
+                                      step_start);
+            ef_index_close(&ix);
+            if (indexed < 0) collect_result = -1;
+        }
+    }
+    if (filter_file && collect_result == 0) {
+        table_filter_set fs;
+        if (table_filter_open(&fs, filter_file) != 0) {
+            fprintf(stderr, "Warning: Cannot open filter set %s, searching every table\n",
+                    filter_file);
+        } else {
+            step_start = get_time_sec();
+            filtered = collect_filtered(&fs, table_paths + indexed, num_tables - indexed,
+                                        end_indices, total_indices, start_indices, positions,
+                                        &total_candidates, max_candidates, step_start);
+            table_filter_close(&fs);
+            if (filtered < 0) collect_result = -1;
+        }
+    }
+    filtered += indexed;
+    int unfiltered = collect_result < 0 ? 0 : num_tables - filtered;
+    if (collect_result == 0 && unfiltered > 0) {
+        step_start = get_time_sec();
+        if (stream) {
+            collect_result = collect_streamed(table_paths + filtered, unfiltered, end_indices,
+                                              total_indices, start_indices, positions,
+                                              &total_candidates, max_candidates, step_start);
+        } else {
+            collect_result = collect_prefetched(table_paths + filtered, unfiltered, end_indices,
+                                                total_indices, start_indices, positions,
+                                                &total_candidates, max_candidates,
+                                                prefetch_mb * 1024 * 1024, streams_per_device,
+                                                search_threads, step_start);
+        }
+    }
+    uint32_t *offsets = collect_result == 0 ?
+        group_candidates(targets, num_targets, num_indices, start_indices, positions,
+                         total_candidates) : NULL;
+    if (!offsets) {
+        if (collect_result == 0) fprintf(stderr, "Error: Failed to allocate candidate buffers\n");
+        free(end_indices);
+        free(start_indices);
+        free(positions);
+        gpu_cleanup(&gpu);
+        for (int i = 0; i < num_tables; i++) free(table_paths[i]);
+        free(table_paths);
+        free(targets);
+        return 1;
     }
 
-    format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
-    format_number(total_candidates, num_buf, sizeof(num_buf));
-    printf("\r         Collected %s candidates - %s                    \n\n", num_buf, time_buf);
-
-    int found = 0;
-    char found_key[15] = {0};
-
+    int num_found = 0;
     if (total_candidates > 0) {
         get_timestamp(ts, sizeof(ts));
-        printf("[%s] Checking candidates on GPU...\n", ts);
+        printf("[%s] Checking candidates on %s...\n", ts, have_gpu ? "GPU" : "CPU");
+    }
+
+    for (int t = 0; t < num_targets; t++) {
+        target *tg = &targets[t];
+        if (tg->num_candidates == 0) continue;
         step_start = get_time_sec();
 
         uint8_t key_bytes[7] = {0};
-        int result = gpu_check_false_alarms(&gpu, ciphertext, start_indices, positions,
-                                             total_candidates, REDUCTION_OFFSET,
-                                             plaintext_space_total, key_bytes);
+        int result = have_gpu ?
+            gpu_check_false_alarms(&gpu, tg->bytes, start_indices + offsets[t],
+                                   positions + offsets[t], tg->num_candidates,
+                                   REDUCTION_OFFSET, plaintext_space_total, key_bytes) :
+            cpu_check_false_alarms(tg->bytes, start_indices + offsets[t],
+                                   positions + offsets[t], tg->num_candidates,
+                                   REDUCTION_OFFSET, plaintext_space_total, key_bytes);
         format_time(get_time_sec() - step_start, time_buf, sizeof(time_buf));
+        if (num_targets > 1) printf("         %s: ", tg->hex);
+        else printf("         ");
 
         if (result == 1) {
-            found = 1;
-            bytes_to_hex(key_bytes, 7, found_key, 15);
-            printf("         KEY FOUND - %s\n", time_buf);
+            tg->found = 1;
+            num_found++;
+            bytes_to_hex(key_bytes, 7, tg->key, sizeof(tg->key));
+            printf("KEY FOUND - %s\n", time_buf);
         } else {
-            printf("         No match - %s\n", time_buf);
+            printf("No match - %s\n", time_buf);
         }
     }
 
@@ -383,26 +1231,42 @@ int main(int argc, char **argv) {
 
     printf("\n==============================================================\n\n");
     printf("+--------------------------------------------------------------+\n");
-    if (found) {
+    if (num_targets > 1) {
+        char summary[64];
+        snprintf(summary, sizeof(summary), "%d OF %d KEYS FOUND", num_found, num_targets);
+        printf("|  %-60s|\n", summary);
+        printf("+--------------------------------------------------------------+\n");
+        for (int t = 0; t < num_targets; t++) {
+            char line[64];
+            snprintf(line, sizeof(line), "%s  %-14s  %u candidates", targets[t].hex,
+                     targets[t].found ? targets[t].key : "-", targets[t].num_candidates);
+            printf("|  %-60s|\n", line);
+        }
+        printf("+--------------------------------------------------------------+\n");
+    } else if (num_found) {
         printf("|                      KEY FOUND!                              |\n");
+        printf("+--------------------------------------------------------------+\n");
+        printf("|  Ciphertext:   %-46s|\n", targets[0].hex);
+        printf("|  DES Key:      %-46s|\n", targets[0].key);
     } else {
         printf("|                    KEY NOT FOUND                             |\n");
+        printf("+--------------------------------------------------------------+\n");
+        printf("|  Ciphertext:   %-46s|\n", targets[0].hex);
     }
-    printf("+--------------------------------------------------------------+\n");
-    printf("|  Ciphertext:   %-46s|\n", ct_hex);
-    if (found) printf("|  DES Key:      %-46s|\n", found_key);
     printf("|  Candidates:   %-46u|\n", total_candidates);
     printf("|  Tables:       %-46d|\n", num_tables);
     printf("|  Total time:   %-46s|\n", time_buf);
     printf("|  Finished:     %-46s|\n", ts);
     printf("+--------------------------------------------------------------+\n");
 
+    free(offsets);
     free(end_indices);
     free(start_indices);
     free(positions);
     gpu_cleanup(&gpu);
     for (int i = 0; i < num_tables; i++) free(table_paths[i]);
     free(table_paths);
+    free(targets);
 
-    return found ? 0 : 1;
+    return num_found ? 0 : 1;
 }
\ No newline at end of file
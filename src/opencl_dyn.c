@@ -25,8 +25,10 @@ clGetDeviceInfo_fn p_clGetDeviceInfo;
 clCreateContext_fn p_clCreateContext;
 clCreateCommandQueue_fn p_clCreateCommandQueue;
 clCreateProgramWithSource_fn p_clCreateProgramWithSource;
+clCreateProgramWithBinary_fn p_clCreateProgramWithBinary;
 clBuildProgram_fn p_clBuildProgram;
 clGetProgramBuildInfo_fn p_clGetProgramBuildInfo;
+clGetProgramInfo_fn p_clGetProgramInfo;
 clCreateKernel_fn p_clCreateKernel;
 clCreateBuffer_fn p_clCreateBuffer;
 clSetKernelArg_fn p_clSetKernelArg;
@@ -63,8 +65,10 @@ int opencl_load(void) {
     p_clCreateContext = (clCreateContext_fn)GETFUNC(opencl_lib, "clCreateContext");
     p_clCreateCommandQueue = (clCreateCommandQueue_fn)GETFUNC(opencl_lib, "clCreateCommandQueue");
     p_clCreateProgramWithSource = (clCreateProgramWithSource_fn)GETFUNC(opencl_lib, "clCreateProgramWithSource");
+    p_clCreateProgramWithBinary = (clCreateProgramWithBinary_fn)GETFUNC(opencl_lib, "clCreateProgramWithBinary");
     p_clBuildProgram = (clBuildProgram_fn)GETFUNC(opencl_lib, "clBuildProgram");
     p_clGetProgramBuildInfo = (clGetProgramBuildInfo_fn)GETFUNC(opencl_lib, "clGetProgramBuildInfo");
+    p_clGetProgramInfo = (clGetProgramInfo_fn)GETFUNC(opencl_lib, "clGetProgramInfo");
     p_clCreateKernel = (clCreateKernel_fn)GETFUNC(opencl_lib, "clCreateKernel");
     p_clCreateBuffer = (clCreateBuffer_fn)GETFUNC(opencl_lib, "clCreateBuffer");
     p_clSetKernelArg = (clSetKernelArg_fn)GETFUNC(opencl_lib, "clSetKernelArg");
@@ -1,9 +1,86 @@
 #include "opencl_host.h"
 #include "opencl_dyn.h"
+#include "des.h"
+#include "netntlmv1.h"
+#include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#else
+#include <sys/stat.h>
+#endif
+
+#include "kernel_sources.h"
+
+// Bitsliced DES, built ahead of each kernel file (from the same directory)
+#define DES_BS_KERNEL_FILE "des_bs.cl"
+#define DES_BS_LANES 32
+
+// Compiled programs are cached in CACHE_DIR as <kernel>-<key>.clbin: the
+// device binary and the variant picked for it, behind a header
+#define PROGRAM_CACHE_MAGIC "DESCLBN1"
+
+typedef struct {
+    char magic[8];
+    uint64_t key;           // FNV-1a of device, driver, build options and sources
+    int32_t variant;        // GPU_DES_* picked when the binary was built
+    uint32_t reserved;
+    uint64_t size;          // binary bytes that follow
+} program_cache_header;
+
+// Where a program is cached and what it was built from; variant is the
+// one stored with a cached binary, or -1 if the program was compiled
+typedef struct {
+    char path[4096];
+    uint64_t key;
+    int variant;
+} program_cache;
+
+// Kernel files compiled into the executable (kernel_sources.h)
+static const struct {
+    const char *name;
+    const char *source;
+} embedded_kernels[] = {
+    {"des_bs.cl", kernel_des_bs},
+    {"precompute.cl", kernel_precompute},
+    {"false_alarm.cl", kernel_false_alarm},
+};
+
+// Sizes of the short runs that pick a kernel variant, per compute unit:
+// bitsliced work items of a short precompute (every variant walks the
+// same DES_BS_LANES chains per item, as in a full precompute, where the
+// scalar kernels get that many more work items), and false alarm
+// candidates walking a fixed number of steps. Each variant runs once
+// untimed (some drivers, pocl among them, compile on first enqueue) and
+// then keeps its best of VARIANT_CALIBRATION_RUNS runs.
+#define VARIANT_CALIBRATION_ITEMS_PER_CU 64
+#define VARIANT_CALIBRATION_CANDIDATES_PER_CU 8192
+#define VARIANT_CALIBRATION_STEPS 64
+#define VARIANT_CALIBRATION_RUNS 2
+
+// The false alarm kernels are persistent threads pulling candidates from
+// a counter: at most this many work items per compute unit are started,
+// and the host hands them batches of this many work units per work item
+// (a work unit is one candidate, or 32 for the bitsliced kernel)
+#define FA_PERSISTENT_ITEMS_PER_CU 1024
+#define FA_BATCH_UNITS_PER_ITEM 8
+
+// Name suffix and description of each GPU_DES_* variant
+static const char *variant_suffix[GPU_DES_VARIANTS] = {"", "_sk", "_bs"};
+static const char *variant_desc[GPU_DES_VARIANTS] = {"key schedule", "subkey tables", "bitsliced"};
+
+typedef double (*variant_timer)(gpu_context *ctx, cl_kernel kernel, int variant);
+static int pick_variant(gpu_context *ctx, cl_program program, const char *kernel_name,
+                        variant_timer timer, cl_kernel *kernel, int *variant);
+static double time_precompute(gpu_context *ctx, cl_kernel kernel, int variant);
+static int subkey_buffer(gpu_context *ctx);
+static double time_false_alarm(gpu_context *ctx, cl_kernel kernel, int variant);
 
 int gpu_init(gpu_context *ctx) {
     cl_int err;
@@ -22,9 +99,15 @@ int gpu_init(gpu_context *ctx) {
         return -1;
     }
     
+    // GPUs only, unless DESTROY_CL_DEVICE=cpu asks for an OpenCL CPU device
+    // (pocl and the like, for testing the kernels without a GPU)
+    const char *device_env = getenv("DESTROY_CL_DEVICE");
+    cl_device_type device_type = device_env && strcmp(device_env, "cpu") == 0 ?
+                                 CL_DEVICE_TYPE_CPU : CL_DEVICE_TYPE_GPU;
+    
     for (cl_uint i = 0; i < num_platforms; i++) {
         cl_uint num_devices;
-        err = p_clGetDeviceIDs(platforms[i], CL_DEVICE_TYPE_GPU, 1, &ctx->device, &num_devices);
+        err = p_clGetDeviceIDs(platforms[i], device_type, 1, &ctx->device, &num_devices);
         if (err == CL_SUCCESS && num_devices > 0) {
             ctx->platform = platforms[i];
             break;
@@ -32,11 +115,12 @@ int gpu_init(gpu_context *ctx) {
     }
     
     if (ctx->device == NULL) {
-        fprintf(stderr, "No GPU device found\n");
+        fprintf(stderr, "No %s device found\n", device_type == CL_DEVICE_TYPE_CPU ? "OpenCL CPU" : "GPU");
         return -1;
     }
     
     p_clGetDeviceInfo(ctx->device, CL_DEVICE_NAME, sizeof(ctx->device_name), ctx->device_name, NULL);
+    p_clGetDeviceInfo(ctx->device, CL_DRIVER_VERSION, sizeof(ctx->driver_version), ctx->driver_version, NULL);
     p_clGetDeviceInfo(ctx->device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(ctx->compute_units), &ctx->compute_units, NULL);
     p_clGetDeviceInfo(ctx->device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(ctx->max_work_group_size), &ctx->max_work_group_size, NULL);
     
@@ -59,81 +143,406 @@ int gpu_init(gpu_context *ctx) {
     return 0;
 }
 
-int gpu_load_kernel(gpu_context *ctx, const char *filename, const char *kernel_name) {
-    cl_int err;
-    FILE *f;
-    char *source;
-    size_t source_len;
-    
-    f = fopen(filename, "rb");
+static char *read_source(const char *filename, size_t *source_len) {
+    FILE *f = fopen(filename, "rb");
     if (!f) {
         fprintf(stderr, "Failed to open kernel file: %s\n", filename);
-        return -1;
+        return NULL;
     }
     
     fseek(f, 0, SEEK_END);
-    source_len = ftell(f);
+    *source_len = ftell(f);
     fseek(f, 0, SEEK_SET);
     
-    source = malloc(source_len + 1);
+    char *source = malloc(*source_len + 1);
     if (!source) {
         fclose(f);
-        return -1;
+        return NULL;
+    }
+    
+    if (fread(source, 1, *source_len, f) != *source_len) {
+        fprintf(stderr, "Failed to read kernel file: %s\n", filename);
+        free(source);
+        fclose(f);
+        return NULL;
+    }
+    source[*source_len] = '\0';
+    fclose(f);
+    return source;
+}
+
+// Kernel source by file name: the copy compiled into the executable when
+// there is one, so the tools run from any directory, otherwise the file
+static char *kernel_source(const char *filename, size_t *source_len) {
+    const char *slash = strrchr(filename, '/');
+    const char *name = slash ? slash + 1 : filename;
+    
+    for (size_t i = 0; i < sizeof(embedded_kernels) / sizeof(embedded_kernels[0]); i++) {
+        if (strcmp(name, embedded_kernels[i].name) == 0) {
+            *source_len = strlen(embedded_kernels[i].source);
+            char *source = malloc(*source_len + 1);
+            if (source) {
+                memcpy(source, embedded_kernels[i].source, *source_len + 1);
+            }
+            return source;
+        }
+    }
+    return read_source(filename, source_len);
+}
+
+void gpu_set_table_params(gpu_context *ctx, uint32_t reduction_offset,
+                          uint64_t plaintext_space_total) {
+    ctx->reduction_offset = reduction_offset;
+    ctx->plaintext_space_total = plaintext_space_total;
+}
+
+static uint32_t bit_reverse32(uint32_t x) {
+    uint32_t r = 0;
+    for (int i = 0; i < 32; i++) {
+        r |= ((x >> i) & 1) << (31 - i);
+    }
+    return r;
+}
+
+// -D options for the challenge and, once set, the table parameters. The
+// bitsliced kernels take the IP halves as slices (bit i = slice i), which
+// is the table-driven IP words unrotated and bit-reversed.
+static void build_options(gpu_context *ctx, char *options, size_t size) {
+    uint32_t x, y;
+    des_ip_words(NTLMV1_CHALLENGE, &x, &y);
+    int len = snprintf(options, size,
+                       "-DDES_IP_X=0x%08xU -DDES_IP_Y=0x%08xU -DDES_BS_L0=0x%08xU -DDES_BS_R0=0x%08xU",
+                       x, y, bit_reverse32((x >> 1) | (x << 31)),
+                       bit_reverse32((y >> 1) | (y << 31)));
+    if (ctx->plaintext_space_total && len > 0 && (size_t)len < size) {
+        snprintf(options + len, size - len,
+                 " -DDES_REDUCTION_OFFSET=%uU -DDES_PLAINTEXT_SPACE=%lluUL",
+                 ctx->reduction_offset, (unsigned long long)ctx->plaintext_space_total);
+    }
+}
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Cache entry of a kernel file built from these sources and options on
+// this device and driver
+static void program_cache_init(gpu_context *ctx, const char *filename, const char *options,
+                               char **sources, size_t *source_lens, int num_sources,
+                               program_cache *cache) {
+    uint64_t key = 0xcbf29ce484222325ULL;
+    key = fnv1a(key, ctx->device_name, strlen(ctx->device_name) + 1);
+    key = fnv1a(key, ctx->driver_version, strlen(ctx->driver_version) + 1);
+    key = fnv1a(key, options, strlen(options) + 1);
+    for (int i = 0; i < num_sources; i++) {
+        key = fnv1a(key, sources[i], source_lens[i]);
     }
     
-    fread(source, 1, source_len, f);
-    source[source_len] = '\0';
+    const char *slash = strrchr(filename, '/');
+    const char *name = slash ? slash + 1 : filename;
+    const char *ext = strrchr(name, '.');
+    int name_len = ext ? (int)(ext - name) : (int)strlen(name);
+    snprintf(cache->path, sizeof(cache->path), "%s/%.*s-%016llx.clbin",
+             CACHE_DIR, name_len, name, (unsigned long long)key);
+    cache->key = key;
+    cache->variant = -1;
+}
+
+// The cached binary, built for the device, or NULL if there is none (or
+// the driver rejects it)
+static cl_program load_cached_program(gpu_context *ctx, const char *options, program_cache *cache) {
+    FILE *f = fopen(cache->path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    
+    program_cache_header header;
+    unsigned char *binary = NULL;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        memcmp(header.magic, PROGRAM_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.key != cache->key || header.variant < 0 || header.variant >= GPU_DES_VARIANTS ||
+        header.size == 0 || header.size > (1ULL << 30) ||
+        !(binary = malloc(header.size)) ||
+        fread(binary, 1, header.size, f) != header.size) {
+        free(binary);
+        fclose(f);
+        return NULL;
+    }
     fclose(f);
     
-    ctx->program = p_clCreateProgramWithSource(ctx->context, 1, (const char **)&source, &source_len, &err);
-    free(source);
+    cl_int err, status;
+    size_t size = header.size;
+    const unsigned char *binaries[1] = {binary};
+    cl_program program = p_clCreateProgramWithBinary(ctx->context, 1, &ctx->device, &size,
+                                                     binaries, &status, &err);
+    free(binary);
+    if (err != CL_SUCCESS || status != CL_SUCCESS) {
+        if (err == CL_SUCCESS) p_clReleaseProgram(program);
+        return NULL;
+    }
+    
+    if (p_clBuildProgram(program, 1, &ctx->device, options, NULL, NULL) != CL_SUCCESS) {
+        p_clReleaseProgram(program);
+        return NULL;
+    }
+    
+    cache->variant = header.variant;
+    return program;
+}
+
+// Writes the program's device binary and picked variant to the cache. A
+// temporary file is renamed into place, so processes building the same
+// kernels at once never read a partial entry. Failures only cost the
+// next process a compile.
+static void save_cached_program(cl_program program, const program_cache *cache, int variant) {
+    size_t size = 0;
+    if (!p_clGetProgramInfo ||
+        p_clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, NULL) != CL_SUCCESS ||
+        size == 0) {
+        return;
+    }
+    
+    unsigned char *binary = malloc(size);
+    unsigned char *binaries[1] = {binary};
+    if (!binary ||
+        p_clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries), binaries, NULL) != CL_SUCCESS) {
+        free(binary);
+        return;
+    }
+    
+    program_cache_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PROGRAM_CACHE_MAGIC, sizeof(header.magic));
+    header.key = cache->key;
+    header.variant = variant;
+    header.size = size;
+    
+    char tmp_path[sizeof(cache->path) + 32];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", cache->path, (int)getpid());
+    mkdir(CACHE_DIR, 0755);
+    FILE *f = fopen(tmp_path, "wb");
+    if (f) {
+        int ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+                 fwrite(binary, 1, size, f) == size;
+        ok = fclose(f) == 0 && ok;
+        if (ok && rename(tmp_path, cache->path) != 0) {
+            // Windows does not rename over an existing file
+            remove(cache->path);
+            ok = rename(tmp_path, cache->path) == 0;
+        }
+        if (!ok) {
+            remove(tmp_path);
+        }
+    }
+    free(binary);
+}
+
+// Builds the kernel file with des_bs.cl ahead of it: from the cached
+// binary when this device has built the same sources and options before,
+// otherwise from source
+static cl_program build_program(gpu_context *ctx, const char *filename, const char *what,
+                                program_cache *cache) {
+    cl_int err;
+    char bs_filename[4096];
+    const char *slash = strrchr(filename, '/');
+    int dir_len = slash ? (int)(slash - filename + 1) : 0;
+    snprintf(bs_filename, sizeof(bs_filename), "%.*s%s", dir_len, filename, DES_BS_KERNEL_FILE);
+    
+    // The sources are joined as they are, so a newline goes between them
+    char *sources[3];
+    size_t source_lens[3];
+    sources[0] = kernel_source(bs_filename, &source_lens[0]);
+    sources[1] = "\n";
+    source_lens[1] = 1;
+    sources[2] = sources[0] ? kernel_source(filename, &source_lens[2]) : NULL;
+    if (!sources[2]) {
+        free(sources[0]);
+        return NULL;
+    }
+    
+    char options[256];
+    build_options(ctx, options, sizeof(options));
+    program_cache_init(ctx, filename, options, sources, source_lens, 3, cache);
+    
+    cl_program program = load_cached_program(ctx, options, cache);
+    if (program) {
+        free(sources[0]);
+        free(sources[2]);
+        return program;
+    }
+    
+    program = p_clCreateProgramWithSource(ctx->context, 3, (const char **)sources,
+                                          source_lens, &err);
+    free(sources[0]);
+    free(sources[2]);
     
     if (err != CL_SUCCESS) {
-        fprintf(stderr, "Failed to create program: %d\n", err);
-        return -1;
+        fprintf(stderr, "Failed to create %s program: %d\n", what, err);
+        return NULL;
     }
     
-    err = p_clBuildProgram(ctx->program, 1, &ctx->device, NULL, NULL, NULL);
+    err = p_clBuildProgram(program, 1, &ctx->device, options, NULL, NULL);
     if (err != CL_SUCCESS) {
         size_t log_size;
-        p_clGetProgramBuildInfo(ctx->program, ctx->device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+        p_clGetProgramBuildInfo(program, ctx->device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
         char *log = malloc(log_size);
-        p_clGetProgramBuildInfo(ctx->program, ctx->device, CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
-        fprintf(stderr, "Build error:\n%s\n", log);
+        p_clGetProgramBuildInfo(program, ctx->device, CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
+        fprintf(stderr, "Build error in %s kernel:\n%s\n", what, log);
         free(log);
-        return -1;
+        p_clReleaseProgram(program);
+        return NULL;
     }
     
-    ctx->kernel = p_clCreateKernel(ctx->program, kernel_name, &err);
-    if (err != CL_SUCCESS) {
-        fprintf(stderr, "Failed to create kernel '%s': %d\n", kernel_name, err);
+    return program;
+}
+
+// Builds a kernel file and creates its kernel: the variant stored with a
+// cached binary, otherwise the fastest one on a timed run, which is then
+// cached with the binary
+static int load_program(gpu_context *ctx, const char *filename, const char *what,
+                        const char *kernel_name, variant_timer timer,
+                        cl_program *program, cl_kernel *kernel, int *variant) {
+    program_cache cache;
+    *program = build_program(ctx, filename, what, &cache);
+    if (!*program) {
         return -1;
     }
     
+    if (cache.variant >= 0) {
+        char name[128];
+        cl_int err;
+        snprintf(name, sizeof(name), "%s%s", kernel_name, variant_suffix[cache.variant]);
+        *kernel = p_clCreateKernel(*program, name, &err);
+        if (err == CL_SUCCESS && (cache.variant != GPU_DES_SUBKEYS || subkey_buffer(ctx) == 0)) {
+            *variant = cache.variant;
+            printf("      Kernel %s (cached)\n", name);
+            return 0;
+        }
+        if (err == CL_SUCCESS) p_clReleaseKernel(*kernel);
+        *kernel = NULL;
+    }
+    
+    if (pick_variant(ctx, *program, kernel_name, timer, kernel, variant) != 0) {
+        return -1;
+    }
+    save_cached_program(*program, &cache, *variant);
     return 0;
 }
 
+int gpu_load_kernel(gpu_context *ctx, const char *filename, const char *kernel_name) {
+    return load_program(ctx, filename, "precompute", kernel_name, time_precompute,
+                        &ctx->program, &ctx->kernel, &ctx->kernel_variant);
+}
+
 void gpu_cleanup(gpu_context *ctx) {
     if (ctx->kernel) p_clReleaseKernel(ctx->kernel);
     if (ctx->program) p_clReleaseProgram(ctx->program);
     if (ctx->fa_kernel) p_clReleaseKernel(ctx->fa_kernel);
     if (ctx->fa_program) p_clReleaseProgram(ctx->fa_program);
+    if (ctx->subkeys) p_clReleaseMemObject(ctx->subkeys);
     if (ctx->queue) p_clReleaseCommandQueue(ctx->queue);
     if (ctx->context) p_clReleaseContext(ctx->context);
     memset(ctx, 0, sizeof(gpu_context));
     opencl_unload();
 }
 
-int gpu_precompute(gpu_context *ctx, const uint8_t *hash,
-                   uint32_t chain_len, uint32_t reduction_offset,
-                   uint64_t plaintext_space_total,
-                   uint64_t *output) {
+// The subkey contribution table, uploaded on first use
+static int subkey_buffer(gpu_context *ctx) {
+    if (ctx->subkeys) {
+        return 0;
+    }
+    
+    static uint32_t table[DES_SUBKEY_NIBBLES][16][32];
+    des_subkey_nibble_table(table);
+    
+    cl_int err;
+    ctx->subkeys = p_clCreateBuffer(ctx->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                    sizeof(table), table, &err);
+    if (err != CL_SUCCESS) {
+        ctx->subkeys = NULL;
+        fprintf(stderr, "Failed to create subkey table buffer: %d\n", err);
+        return -1;
+    }
+    return 0;
+}
+
+// Creates kernel_name and whichever of its variants the program has (see
+// GPU_DES_*), times each on a short run and keeps the fastest
+static int pick_variant(gpu_context *ctx, cl_program program, const char *kernel_name,
+                        variant_timer timer, cl_kernel *kernel, int *variant) {
+    cl_int err;
+    char name[128];
+    double times[GPU_DES_VARIANTS];
+    int tried = 0;
+    
+    *kernel = NULL;
+    *variant = GPU_DES_SCHEDULE;
+    for (int v = 0; v < GPU_DES_VARIANTS; v++) {
+        times[v] = -1;
+        snprintf(name, sizeof(name), "%s%s", kernel_name, variant_suffix[v]);
+        cl_kernel candidate = p_clCreateKernel(program, name, &err);
+        if (err != CL_SUCCESS) {
+            if (v == GPU_DES_SCHEDULE) {
+                fprintf(stderr, "Failed to create kernel '%s': %d\n", name, err);
+                return -1;
+            }
+            continue;
+        }
+        if (v == GPU_DES_SUBKEYS && subkey_buffer(ctx) != 0) {
+            p_clReleaseKernel(candidate);
+            continue;
+        }
+        
+        tried++;
+        times[v] = timer(ctx, candidate, v);
+        if (times[v] >= 0 && (!*kernel || times[*variant] < 0 || times[v] < times[*variant])) {
+            if (*kernel) p_clReleaseKernel(*kernel);
+            *kernel = candidate;
+            *variant = v;
+        } else if (*kernel) {
+            p_clReleaseKernel(candidate);
+        } else {
+            // The original stays as the fallback even if its run failed
+            *kernel = candidate;
+        }
+    }
+    
+    if (tried > 1 && times[GPU_DES_SCHEDULE] > 0) {
+        char rates[256];
+        int len = 0;
+        for (int v = 0; v < GPU_DES_VARIANTS; v++) {
+            if (times[v] > 0) {
+                len += snprintf(rates + len, sizeof(rates) - len, "%s%s %.2fx",
+                                len ? ", " : "", variant_desc[v], times[GPU_DES_SCHEDULE] / times[v]);
+            }
+        }
+        printf("      Kernel %s%s (%s)\n", kernel_name, variant_suffix[*variant], rates);
+    }
+    return 0;
+}
+
+// Precompute of the first num_indices chain positions (chain_len - 1 for
+// all of them)
+static int precompute_run(gpu_context *ctx, cl_kernel kernel, int variant,
+                          const uint8_t *hash, uint32_t chain_len, uint32_t num_indices,
+                          uint32_t reduction_offset, uint64_t plaintext_space_total,
+                          uint64_t *output) {
     cl_int err;
     cl_mem hash_buf, output_buf;
     size_t global_work_size;
     
-    uint32_t num_indices = chain_len - 1;
     global_work_size = num_indices;
+    if (variant == GPU_DES_BITSLICED) {
+        if (plaintext_space_total != 1ULL << 56) {
+            fprintf(stderr, "The bitsliced kernel only handles the 2^56 keyspace\n");
+            return -1;
+        }
+        global_work_size = (num_indices + DES_BS_LANES - 1) / DES_BS_LANES;
+    }
     
     hash_buf = p_clCreateBuffer(ctx->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
                                 8, (void *)hash, &err);
@@ -150,18 +559,16 @@ int gpu_precompute(gpu_context *ctx, const uint8_t *hash,
         return -1;
     }
     
-    p_clSetKernelArg(ctx->kernel, 0, sizeof(cl_mem), &hash_buf);
-    p_clSetKernelArg(ctx->kernel, 1, sizeof(cl_uint), &chain_len);
-    p_clSetKernelArg(ctx->kernel, 2, sizeof(cl_uint), &reduction_offset);
-    p_clSetKernelArg(ctx->kernel, 3, sizeof(cl_ulong), &plaintext_space_total);
-    p_clSetKernelArg(ctx->kernel, 4, sizeof(cl_mem), &output_buf);
-    
-    printf("      Running on GPU (please wait, ~1-2 minutes)...\n");
-    fflush(stdout);
-    
-    double start = (double)clock() / CLOCKS_PER_SEC;
+    p_clSetKernelArg(kernel, 0, sizeof(cl_mem), &hash_buf);
+    p_clSetKernelArg(kernel, 1, sizeof(cl_uint), &chain_len);
+    p_clSetKernelArg(kernel, 2, sizeof(cl_uint), &reduction_offset);
+    p_clSetKernelArg(kernel, 3, sizeof(cl_ulong), &plaintext_space_total);
+    p_clSetKernelArg(kernel, 4, sizeof(cl_mem), &output_buf);
+    if (variant == GPU_DES_SUBKEYS) {
+        p_clSetKernelArg(kernel, 5, sizeof(cl_mem), &ctx->subkeys);
+    }
     
-    err = p_clEnqueueNDRangeKernel(ctx->queue, ctx->kernel, 1, NULL,
+    err = p_clEnqueueNDRangeKernel(ctx->queue, kernel, 1, NULL,
                                     &global_work_size, NULL, 0, NULL, NULL);
     if (err != CL_SUCCESS) {
         fprintf(stderr, "Failed to enqueue kernel: %d\n", err);
@@ -172,9 +579,6 @@ int gpu_precompute(gpu_context *ctx, const uint8_t *hash,
     
     p_clFinish(ctx->queue);
     
-    double elapsed = (double)clock() / CLOCKS_PER_SEC - start;
-    printf("      GPU computation finished in %.1f seconds\n", elapsed);
-    
     err = p_clEnqueueReadBuffer(ctx->queue, output_buf, CL_TRUE, 0,
                                  num_indices * sizeof(cl_ulong), output, 0, NULL, NULL);
     if (err != CL_SUCCESS) {
@@ -190,61 +594,75 @@ int gpu_precompute(gpu_context *ctx, const uint8_t *hash,
     return num_indices;
 }
 
-int gpu_load_false_alarm_kernel(gpu_context *ctx, const char *filename) {
-    cl_int err;
-    FILE *f;
-    char *source;
-    size_t source_len;
-    
-    f = fopen(filename, "rb");
-    if (!f) {
-        fprintf(stderr, "Failed to open kernel file: %s\n", filename);
+// Table parameters to time the variants with: the ones built for, if any
+static void calibration_table(gpu_context *ctx, uint32_t *reduction_offset,
+                              uint64_t *plaintext_space_total) {
+    *reduction_offset = ctx->plaintext_space_total ? ctx->reduction_offset : 0;
+    *plaintext_space_total = ctx->plaintext_space_total ? ctx->plaintext_space_total : 1ULL << 56;
+}
+
+// A full precompute of a short chain; best seconds, or -1 if the kernel
+// fails. Its walks are as uneven as the real ones, so it is kept small.
+static double time_precompute(gpu_context *ctx, cl_kernel kernel, int variant) {
+    static const uint8_t hash[8] = {0};
+    uint32_t chains = (ctx->compute_units ? ctx->compute_units : 1) *
+                      VARIANT_CALIBRATION_ITEMS_PER_CU * DES_BS_LANES;
+    uint64_t *output = malloc(chains * sizeof(uint64_t));
+    if (!output) {
         return -1;
     }
     
-    fseek(f, 0, SEEK_END);
-    source_len = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    
-    source = malloc(source_len + 1);
-    if (!source) {
-        fclose(f);
-        return -1;
+    uint32_t reduction_offset;
+    uint64_t plaintext_space_total;
+    calibration_table(ctx, &reduction_offset, &plaintext_space_total);
+    
+    // Warm-up: one work item's worth of chains
+    double best = -1;
+    if (precompute_run(ctx, kernel, variant, hash, DES_BS_LANES + 1, DES_BS_LANES,
+                       reduction_offset, plaintext_space_total, output) >= 0) {
+        for (int run = 0; run < VARIANT_CALIBRATION_RUNS; run++) {
+            double start = get_time_sec();
+            if (precompute_run(ctx, kernel, variant, hash, chains + 1, chains,
+                               reduction_offset, plaintext_space_total, output) < 0) {
+                best = -1;
+                break;
+            }
+            double elapsed = get_time_sec() - start;
+            if (best < 0 || elapsed < best) best = elapsed;
+        }
     }
+    free(output);
+    return best;
+}
+
+int gpu_precompute(gpu_context *ctx, const uint8_t *hash,
+                   uint32_t chain_len, uint32_t reduction_offset,
+                   uint64_t plaintext_space_total,
+                   uint64_t *output) {
+    printf("      Running on GPU (please wait, ~1-2 minutes)...\n");
+    fflush(stdout);
     
-    fread(source, 1, source_len, f);
-    source[source_len] = '\0';
-    fclose(f);
-    
-    ctx->fa_program = p_clCreateProgramWithSource(ctx->context, 1, (const char **)&source, &source_len, &err);
-    free(source);
-    
-    if (err != CL_SUCCESS) {
-        fprintf(stderr, "Failed to create false alarm program: %d\n", err);
-        return -1;
-    }
+    double start = (double)clock() / CLOCKS_PER_SEC;
     
-    err = p_clBuildProgram(ctx->fa_program, 1, &ctx->device, NULL, NULL, NULL);
-    if (err != CL_SUCCESS) {
-        size_t log_size;
-        p_clGetProgramBuildInfo(ctx->fa_program, ctx->device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
-        char *log = malloc(log_size);
-        p_clGetProgramBuildInfo(ctx->fa_program, ctx->device, CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
-        fprintf(stderr, "False alarm kernel build error:\n%s\n", log);
-        free(log);
+    int num_indices = precompute_run(ctx, ctx->kernel, ctx->kernel_variant, hash, chain_len,
+                                     chain_len - 1, reduction_offset, plaintext_space_total,
+                                     output);
+    if (num_indices < 0) {
         return -1;
     }
     
-    ctx->fa_kernel = p_clCreateKernel(ctx->fa_program, "check_false_alarms", &err);
-    if (err != CL_SUCCESS) {
-        fprintf(stderr, "Failed to create false alarm kernel: %d\n", err);
-        return -1;
-    }
+    double elapsed = (double)clock() / CLOCKS_PER_SEC - start;
+    printf("      GPU computation finished in %.1f seconds\n", elapsed);
     
-    return 0;
+    return num_indices;
 }
 
-int gpu_check_false_alarms(gpu_context *ctx,
+int gpu_load_false_alarm_kernel(gpu_context *ctx, const char *filename) {
+    return load_program(ctx, filename, "false alarm", "check_false_alarms", time_false_alarm,
+                        &ctx->fa_program, &ctx->fa_kernel, &ctx->fa_variant);
+}
+
+static int false_alarm_run(gpu_context *ctx, cl_kernel kernel, int variant,
                            const uint8_t *target_hash,
                            uint64_t *start_indices,
                            uint32_t *positions,
@@ -258,6 +676,19 @@ int gpu_check_false_alarms(gpu_context *ctx,
         return 0;
     }
     
+    size_t global_work_size = num_candidates;
+    if (variant == GPU_DES_BITSLICED) {
+        if (plaintext_space_total != 1ULL << 56) {
+            fprintf(stderr, "The bitsliced kernel only handles the 2^56 keyspace\n");
+            return -1;
+        }
+        global_work_size = (num_candidates + DES_BS_LANES - 1) / DES_BS_LANES;
+    }
+    size_t max_items = (size_t)(ctx->compute_units ? ctx->compute_units : 1) * FA_PERSISTENT_ITEMS_PER_CU;
+    if (global_work_size > max_items) {
+        global_work_size = max_items;
+    }
+    
     // Create buffers
     cl_mem hash_buf = p_clCreateBuffer(ctx->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
                                         8, (void *)target_hash, &err);
@@ -290,19 +721,34 @@ int gpu_check_false_alarms(gpu_context *ctx,
         return -1; 
     }
     
+    uint32_t next_init = 0;
+    cl_mem next_buf = p_clCreateBuffer(ctx->context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                                       sizeof(uint32_t), &next_init, &err);
+    if (err != CL_SUCCESS) {
+        p_clReleaseMemObject(hash_buf);
+        p_clReleaseMemObject(start_buf);
+        p_clReleaseMemObject(pos_buf);
+        p_clReleaseMemObject(found_idx_buf);
+        p_clReleaseMemObject(found_key_buf);
+        return -1;
+    }
+    
     // Set kernel arguments
-    p_clSetKernelArg(ctx->fa_kernel, 0, sizeof(cl_mem), &hash_buf);
-    p_clSetKernelArg(ctx->fa_kernel, 1, sizeof(cl_mem), &start_buf);
-    p_clSetKernelArg(ctx->fa_kernel, 2, sizeof(cl_mem), &pos_buf);
-    p_clSetKernelArg(ctx->fa_kernel, 3, sizeof(cl_uint), &num_candidates);
-    p_clSetKernelArg(ctx->fa_kernel, 4, sizeof(cl_uint), &reduction_offset);
-    p_clSetKernelArg(ctx->fa_kernel, 5, sizeof(cl_ulong), &plaintext_space_total);
-    p_clSetKernelArg(ctx->fa_kernel, 6, sizeof(cl_mem), &found_idx_buf);
-    p_clSetKernelArg(ctx->fa_kernel, 7, sizeof(cl_mem), &found_key_buf);
+    p_clSetKernelArg(kernel, 0, sizeof(cl_mem), &hash_buf);
+    p_clSetKernelArg(kernel, 1, sizeof(cl_mem), &start_buf);
+    p_clSetKernelArg(kernel, 2, sizeof(cl_mem), &pos_buf);
+    p_clSetKernelArg(kernel, 3, sizeof(cl_uint), &num_candidates);
+    p_clSetKernelArg(kernel, 4, sizeof(cl_uint), &reduction_offset);
+    p_clSetKernelArg(kernel, 5, sizeof(cl_ulong), &plaintext_space_total);
+    p_clSetKernelArg(kernel, 6, sizeof(cl_mem), &found_idx_buf);
+    p_clSetKernelArg(kernel, 7, sizeof(cl_mem), &found_key_buf);
+    p_clSetKernelArg(kernel, 8, sizeof(cl_mem), &next_buf);
+    if (variant == GPU_DES_SUBKEYS) {
+        p_clSetKernelArg(kernel, 9, sizeof(cl_mem), &ctx->subkeys);
+    }
     
     // Execute
-    size_t global_work_size = num_candidates;
-    err = p_clEnqueueNDRangeKernel(ctx->queue, ctx->fa_kernel, 1, NULL,
+    err = p_clEnqueueNDRangeKernel(ctx->queue, kernel, 1, NULL,
                                     &global_work_size, NULL, 0, NULL, NULL);
     if (err != CL_SUCCESS) {
         fprintf(stderr, "Failed to enqueue false alarm kernel: %d\n", err);
@@ -311,6 +757,7 @@ int gpu_check_false_alarms(gpu_context *ctx,
         p_clReleaseMemObject(pos_buf);
         p_clReleaseMemObject(found_idx_buf);
         p_clReleaseMemObject(found_key_buf);
+        p_clReleaseMemObject(next_buf);
         return -1;
     }
     
@@ -331,6 +778,109 @@ int gpu_check_false_alarms(gpu_context *ctx,
     p_clReleaseMemObject(pos_buf);
     p_clReleaseMemObject(found_idx_buf);
     p_clReleaseMemObject(found_key_buf);
+    p_clReleaseMemObject(next_buf);
     
     return result;
 }
+
+// Candidates walking VARIANT_CALIBRATION_STEPS steps to a target that
+// never matches; enough of them to fill the device in every variant
+static double time_false_alarm(gpu_context *ctx, cl_kernel kernel, int variant) {
+    static const uint8_t target_hash[8] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    uint32_t count = (ctx->compute_units ? ctx->compute_units : 1) *
+                     VARIANT_CALIBRATION_CANDIDATES_PER_CU;
+    uint64_t *start_indices = malloc(count * sizeof(uint64_t));
+    uint32_t *positions = malloc(count * sizeof(uint32_t));
+    uint8_t found_key[7];
+    if (!start_indices || !positions) {
+        free(start_indices);
+        free(positions);
+        return -1;
+    }
+    uint32_t reduction_offset;
+    uint64_t plaintext_space_total;
+    calibration_table(ctx, &reduction_offset, &plaintext_space_total);
+    for (uint32_t i = 0; i < count; i++) {
+        start_indices[i] = i % plaintext_space_total;
+        positions[i] = VARIANT_CALIBRATION_STEPS;
+    }
+    
+    // Warm-up: one bitsliced work item's worth of candidates
+    double best = -1;
+    if (false_alarm_run(ctx, kernel, variant, target_hash, start_indices, positions,
+                        DES_BS_LANES, reduction_offset, plaintext_space_total, found_key) >= 0) {
+        for (int run = 0; run < VARIANT_CALIBRATION_RUNS; run++) {
+            double start = get_time_sec();
+            if (false_alarm_run(ctx, kernel, variant, target_hash, start_indices, positions,
+                                count, reduction_offset, plaintext_space_total, found_key) < 0) {
+                best = -1;
+                break;
+            }
+            double elapsed = get_time_sec() - start;
+            if (best < 0 || elapsed < best) best = elapsed;
+        }
+    }
+    free(start_indices);
+    free(positions);
+    return best;
+}
+
+typedef struct {
+    uint64_t start;
+    uint32_t pos;
+} candidate;
+
+static int candidate_cmp(const void *a, const void *b) {
+    uint32_t pa = ((const candidate *)a)->pos, pb = ((const candidate *)b)->pos;
+    return (pa > pb) - (pa < pb);
+}
+
+int gpu_check_false_alarms(gpu_context *ctx,
+                           const uint8_t *target_hash,
+                           uint64_t *start_indices,
+                           uint32_t *positions,
+                           uint32_t num_candidates,
+                           uint32_t reduction_offset,
+                           uint64_t plaintext_space_total,
+                           uint8_t *found_key) {
+    if (num_candidates == 0) {
+        return 0;
+    }
+    
+    // Cheapest walks first (and the bitsliced kernel needs each group's 32
+    // walks about as long as each other), in batches that fill the device
+    // a few times over, so the check stops soon after the batch that holds
+    // the key instead of after the longest false alarm
+    candidate *sorted = malloc((size_t)num_candidates * sizeof(candidate));
+    uint64_t *sorted_starts = malloc((size_t)num_candidates * sizeof(uint64_t));
+    uint32_t *sorted_positions = malloc((size_t)num_candidates * sizeof(uint32_t));
+    int result = -1;
+    if (sorted && sorted_starts && sorted_positions) {
+        for (uint32_t i = 0; i < num_candidates; i++) {
+            sorted[i].start = start_indices[i];
+            sorted[i].pos = positions[i];
+        }
+        qsort(sorted, num_candidates, sizeof(candidate), candidate_cmp);
+        for (uint32_t i = 0; i < num_candidates; i++) {
+            sorted_starts[i] = sorted[i].start;
+            sorted_positions[i] = sorted[i].pos;
+        }
+        
+        uint32_t batch = (ctx->compute_units ? ctx->compute_units : 1) * FA_PERSISTENT_ITEMS_PER_CU *
+                         FA_BATCH_UNITS_PER_ITEM;
+        if (ctx->fa_variant == GPU_DES_BITSLICED) {
+            batch *= DES_BS_LANES;
+        }
+        result = 0;
+        for (uint32_t first = 0; first < num_candidates && result == 0; first += batch) {
+            uint32_t count = num_candidates - first < batch ? num_candidates - first : batch;
+            result = false_alarm_run(ctx, ctx->fa_kernel, ctx->fa_variant, target_hash,
+                                     sorted_starts + first, sorted_positions + first, count,
+                                     reduction_offset, plaintext_space_total, found_key);
+        }
+    }
+    free(sorted);
+    free(sorted_starts);
+    free(sorted_positions);
+    return result;
+}
\ No newline at end of file
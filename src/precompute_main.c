@@ -3,6 +3,7 @@
 #include <string.h>
 #include "utils.h"
 #include "opencl_host.h"
+#include "cpu_host.h"
 
 int main(int argc, char **argv) {
     if (argc < 2) {
@@ -19,29 +20,30 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    gpu_context gpu = {0};
-    if (gpu_init(&gpu) != 0) {
-        fprintf(stderr, "GPU init failed\n");
-        return 1;
-    }
-
-    if (gpu_load_kernel(&gpu, "kernels/precompute.cl", "precompute") != 0) {
-        fprintf(stderr, "Kernel load failed\n");
-        gpu_cleanup(&gpu);
-        return 1;
-    }
-
     uint32_t num_indices = CHAIN_LEN - 1;
     uint64_t *end_indices = malloc(num_indices * sizeof(uint64_t));
     if (!end_indices) {
         fprintf(stderr, "malloc failed\n");
-        gpu_cleanup(&gpu);
         return 1;
     }
 
     uint64_t plaintext_space = get_plaintext_space();
-    int result = gpu_precompute(&gpu, ciphertext, CHAIN_LEN, REDUCTION_OFFSET,
-                                 plaintext_space, end_indices);
+
+    // Without a usable GPU the chains are walked on the CPU
+    gpu_context gpu = {0};
+    int have_gpu = gpu_init(&gpu) == 0;
+    if (have_gpu) gpu_set_table_params(&gpu, REDUCTION_OFFSET, plaintext_space);
+    if (have_gpu && gpu_load_kernel(&gpu, "kernels/precompute.cl", "precompute") != 0) {
+        fprintf(stderr, "Kernel load failed\n");
+        have_gpu = 0;
+    }
+    if (!have_gpu) gpu_cleanup(&gpu);
+
+    int result = have_gpu ?
+        gpu_precompute(&gpu, ciphertext, CHAIN_LEN, REDUCTION_OFFSET, plaintext_space,
+                       end_indices) :
+        cpu_precompute(ciphertext, CHAIN_LEN, REDUCTION_OFFSET, plaintext_space, end_indices,
+                       cpu_count());
 
     if (result < 0) {
         fprintf(stderr, "Precompute failed\n");
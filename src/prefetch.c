@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "prefetch.h"
+#include "utils.h"
+
+// Charges the time since the last slot state change to the stage timings;
+// call with the lock held before changing a slot's state
+static void account(table_prefetcher *pf) {
+    double now = get_time_sec();
+    double elapsed = now - pf->last_change;
+    if (pf->loading > 0) {
+        pf->io_time += elapsed;
+        if (pf->in_use == 0) pf->exposed_time += elapsed;
+    }
+    pf->last_change = now;
+}
+
+static prefetch_slot *find_slot(table_prefetcher *pf, prefetch_slot_state state) {
+    for (int i = 0; i < pf->depth; i++) {
+        if (pf->slots[i].state == state) return &pf->slots[i];
+    }
+    return NULL;
+}
+
+static void *reader_thread(void *arg) {
+    prefetch_reader *reader = arg;
+    table_prefetcher *pf = reader->pf;
+    prefetch_device *dev = reader->device;
+
+    pthread_mutex_lock(&pf->lock);
+    for (;;) {
+        prefetch_slot *slot = NULL;
+        while (!pf->stop && dev->next < dev->num_tables &&
+               (slot = find_slot(pf, SLOT_FREE)) == NULL) {
+            pthread_cond_wait(&pf->cond, &pf->lock);
+        }
+        if (pf->stop || dev->next >= dev->num_tables) break;
+
+        account(pf);
+        slot->state = SLOT_LOADING;
+        pf->loading++;
+        slot->index = dev->tables[dev->next++];
+        pthread_mutex_unlock(&pf->lock);
+
+        memset(&slot->table, 0, sizeof(rt_table));
+        slot->status = table_load(&slot->table, pf->paths[slot->index]);
+        if (slot->status == 0) table_populate(&slot->table);
+
+        pthread_mutex_lock(&pf->lock);
+        account(pf);
+        slot->state = SLOT_READY;
+        pf->loading--;
+        pthread_cond_broadcast(&pf->cond);
+    }
+    pthread_mutex_unlock(&pf->lock);
+    return NULL;
+}
+
+// Groups tables by backing device, keeping their relative order
+static int group_by_device(table_prefetcher *pf, uint64_t *max_size) {
+    pf->devices = calloc(pf->num_paths > 0 ? pf->num_paths : 1, sizeof(prefetch_device));
+    if (!pf->devices) return -1;
+
+    *max_size = 0;
+    for (int i = 0; i < pf->num_paths; i++) {
+        struct stat st;
+        uint64_t id = 0;
+        if (stat(pf->paths[i], &st) == 0) {
+            id = st.st_dev;
+            if ((uint64_t)st.st_size > *max_size) *max_size = st.st_size;
+        }
+
+        prefetch_device *dev = NULL;
+        for (int d = 0; d < pf->num_devices; d++) {
+            if (pf->devices[d].id == id) dev = &pf->devices[d];
+        }
+        if (!dev) {
+            dev = &pf->devices[pf->num_devices++];
+            dev->id = id;
+            dev->tables = malloc(pf->num_paths * sizeof(int));
+            if (!dev->tables) return -1;
+        }
+        dev->tables[dev->num_tables++] = i;
+    }
+    return 0;
+}
+
+static void free_devices(table_prefetcher *pf) {
+    for (int d = 0; d < pf->num_devices; d++) free(pf->devices[d].tables);
+    free(pf->devices);
+    pf->devices = NULL;
+}
+
+int prefetch_start(table_prefetcher *pf, char **paths, int num_paths, uint64_t ram_budget,
+                   int streams_per_device, int consumers) {
+    memset(pf, 0, sizeof(table_prefetcher));
+    pf->paths = paths;
+    pf->num_paths = num_paths;
+    if (streams_per_device < 1) streams_per_device = 1;
+
+    uint64_t table_size;
+    if (group_by_device(pf, &table_size) != 0) {
+        free_devices(pf);
+        return -1;
+    }
+    if (consumers < 1) consumers = pf->num_devices;
+
+    pf->num_readers = pf->num_devices * streams_per_device;
+    pf->depth = table_size ? (int)(ram_budget / table_size) : 0;
+    if (pf->depth < pf->num_readers + consumers) pf->depth = pf->num_readers + consumers;
+    if (pf->depth > num_paths) pf->depth = num_paths > 0 ? num_paths : 1;
+
+    pf->slots = calloc(pf->depth, sizeof(prefetch_slot));
+    pf->readers = calloc(pf->num_readers > 0 ? pf->num_readers : 1, sizeof(prefetch_reader));
+    if (!pf->slots || !pf->readers) {
+        free(pf->slots);
+        free(pf->readers);
+        free_devices(pf);
+        return -1;
+    }
+
+    pthread_mutex_init(&pf->lock, NULL);
+    pthread_cond_init(&pf->cond, NULL);
+    pf->last_change = get_time_sec();
+
+    int started = 0;
+    for (int d = 0; d < pf->num_devices; d++) {
+        for (int s = 0; s < streams_per_device; s++, started++) {
+            prefetch_reader *reader = &pf->readers[started];
+            reader->pf = pf;
+            reader->device = &pf->devices[d];
+            if (pthread_create(&reader->thread, NULL, reader_thread, reader) != 0) {
+                pf->num_readers = started;
+                prefetch_stop(pf);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+prefetch_slot *prefetch_next(table_prefetcher *pf) {
+    prefetch_slot *slot;
+
+    pthread_mutex_lock(&pf->lock);
+    while ((slot = find_slot(pf, SLOT_READY)) == NULL && pf->delivered < pf->num_paths)
+        pthread_cond_wait(&pf->cond, &pf->lock);
+    if (slot) {
+        account(pf);
+        slot->state = SLOT_IN_USE;
+        pf->in_use++;
+        pf->delivered++;
+    }
+    pthread_mutex_unlock(&pf->lock);
+
+    return slot;
+}
+
+void prefetch_release(table_prefetcher *pf, prefetch_slot *slot) {
+    table_free(&slot->table);
+
+    pthread_mutex_lock(&pf->lock);
+    account(pf);
+    slot->state = SLOT_FREE;
+    pf->in_use--;
+    pthread_cond_broadcast(&pf->cond);
+    pthread_mutex_unlock(&pf->lock);
+}
+
+void prefetch_stop(table_prefetcher *pf) {
+    if (!pf->slots) return;
+
+    pthread_mutex_lock(&pf->lock);
+    pf->stop = 1;
+    pthread_cond_broadcast(&pf->cond);
+    pthread_mutex_unlock(&pf->lock);
+    for (int i = 0; i < pf->num_readers; i++) pthread_join(pf->readers[i].thread, NULL);
+    account(pf);
+
+    // Free anything loaded but never consumed
+    for (int i = 0; i < pf->depth; i++) {
+        if (pf->slots[i].state != SLOT_FREE) table_free(&pf->slots[i].table);
+    }
+
+    pthread_mutex_destroy(&pf->lock);
+    pthread_cond_destroy(&pf->cond);
+    free(pf->slots);
+    free(pf->readers);
+    free_devices(pf);
+    pf->slots = NULL;
+    pf->readers = NULL;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include <string.h>
+#include "rtc.h"
+
+static inline uint64_t load_record(const rtc_view *v, uint64_t i) {
+    uint64_t r = 0;
+    memcpy(&r, v->records + i * v->record_bytes, v->record_bytes);
+    return r;
+}
+
+int rtc_open(rtc_view *v, const void *data, size_t size) {
+    memset(v, 0, sizeof(rtc_view));
+    if (size < sizeof(rtc_header)) return -1;
+
+    const rtc_header *h = data;
+    if (h->version != RTC_VERSION) return -1;
+    uint32_t bits = h->start_point_bits + h->end_point_bits;
+    if (h->start_point_bits == 0 || h->start_point_bits > 63 ||
+        h->end_point_bits > 63 || bits > 64 || h->index_bits > 32 ||
+        h->end_point_bits + h->index_bits > 64) {
+        return -1;
+    }
+
+    v->header = h;
+    v->record_bytes = (bits + 7) / 8;
+    v->num_prefixes = 1ULL << h->index_bits;
+
+    uint64_t index_bytes = (v->num_prefixes + 1) * sizeof(uint32_t);
+    uint64_t expected = sizeof(rtc_header) + index_bytes + h->chain_count * v->record_bytes;
+    if (expected != size) return -1;
+
+    v->index = (const uint32_t *)(h + 1);
+    v->records = (const uint8_t *)v->index + index_bytes;
+    v->start_mask = (h->start_point_bits == 64) ? ~0ULL : ((1ULL << h->start_point_bits) - 1);
+    v->low_mask = (h->end_point_bits == 64) ? ~0ULL : ((1ULL << h->end_point_bits) - 1);
+    if (v->index[v->num_prefixes] != h->chain_count) return -1;
+    for (uint64_t p = 0; p < v->num_prefixes; p++) {
+        if (v->index[p] > v->index[p + 1]) return -1;
+    }
+    return 0;
+}
+
+void rtc_chain(const rtc_view *v, uint64_t i, uint64_t prefix, uint64_t *start, uint64_t *end) {
+    uint64_t r = load_record(v, i);
+    *start = v->header->start_point_min + (r & v->start_mask);
+    *end = (prefix << v->header->end_point_bits) |
+           ((r >> v->header->start_point_bits) & v->low_mask);
+}
+
+uint64_t rtc_start(const rtc_view *v, uint64_t i) {
+    return v->header->start_point_min + (load_record(v, i) & v->start_mask);
+}
+
+int rtc_find(const rtc_view *v, uint64_t end, uint64_t *chain) {
+    // Ends above the indexed prefixes (any end past the stored low bits
+    // when there are no index bits) are not in the table
+    uint64_t prefix = end >> v->header->end_point_bits;
+    if (prefix >= v->num_prefixes) return 0;
+    uint64_t low = end & v->low_mask;
+
+    // Binary search the run of chains sharing this prefix
+    uint64_t lo = v->index[prefix], hi = v->index[prefix + 1];
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        uint64_t mid_low = (load_record(v, mid) >> v->header->start_point_bits) & v->low_mask;
+        if (mid_low < low) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (lo < v->index[prefix + 1] &&
+        ((load_record(v, lo) >> v->header->start_point_bits) & v->low_mask) == low) {
+        *chain = lo;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
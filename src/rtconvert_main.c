@@ -0,0 +1,313 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+#include "table.h"
+#include "ef.h"
+
+#define CONVERT_CHUNK_CHAINS (1024 * 1024)
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <format> <table.rt> [output_dir]\n", prog);
+    fprintf(stderr, "Formats:\n");
+    fprintf(stderr, "  split   End column (.rte) + start column (.rts)\n");
+    fprintf(stderr, "  ef      Elias-Fano coded end column (.rtef) + start column (.rts)\n");
+    fprintf(stderr, "  stree   Search tree sidecar (.rtst) for an .rt or .rte table, kept next to it\n");
+    fprintf(stderr, "  meta    Metadata sidecar (.rtm): end range, checksum and page fences for\n"
+                    "          paged lookups in an .rt or .rte table, kept next to it\n");
+}
+
+// Output path: <output_dir or input dir>/<table id><ext>
+static void output_path(const char *table_path, const char *out_dir, const char *ext,
+                        char *path, size_t size) {
+    char table_id[256];
+    get_table_id(table_path, table_id, sizeof(table_id));
+
+    if (out_dir) {
+        snprintf(path, size, "%s/%s%s", out_dir, table_id, ext);
+        return;
+    }
+
+    const char *slash = strrchr(table_path, '/');
+    if (!slash) slash = strrchr(table_path, '\\');
+    if (slash) {
+        snprintf(path, size, "%.*s%s%s", (int)(slash - table_path + 1), table_path, table_id, ext);
+    } else {
+        snprintf(path, size, "%s%s", table_id, ext);
+    }
+}
+
+static int convert_split(const char *table_path, const char *out_dir) {
+    char ends_path[1024], starts_path[1024];
+    output_path(table_path, out_dir, ".rte", ends_path, sizeof(ends_path));
+    table_starts_path(ends_path, starts_path, sizeof(starts_path));
+
+    FILE *in = fopen(table_path, "rb");
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", table_path);
+        return -1;
+    }
+    FILE *ends_f = fopen(ends_path, "wb");
+    FILE *starts_f = fopen(starts_path, "wb");
+    uint64_t *pairs = malloc(CONVERT_CHUNK_CHAINS * 16);
+    uint64_t *ends = malloc(CONVERT_CHUNK_CHAINS * 8);
+    uint64_t *starts = malloc(CONVERT_CHUNK_CHAINS * 8);
+    int ret = 0;
+
+    if (!ends_f || !starts_f || !pairs || !ends || !starts) {
+        fprintf(stderr, "Cannot create %s / %s\n", ends_path, starts_path);
+        ret = -1;
+        goto done;
+    }
+
+    uint64_t total = 0, prev_end = 0;
+    size_t n;
+    while ((n = fread(pairs, 16, CONVERT_CHUNK_CHAINS, in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            starts[i] = pairs[i * 2];
+            ends[i] = pairs[i * 2 + 1];
+            if ((total || i) && ends[i] < prev_end) {
+                fprintf(stderr, "%s is not sorted by end index (chain %llu)\n",
+                        table_path, (unsigned long long)(total + i));
+                ret = -1;
+                goto done;
+            }
+            prev_end = ends[i];
+        }
+        if (fwrite(ends, 8, n, ends_f) != n || fwrite(starts, 8, n, starts_f) != n) {
+            fprintf(stderr, "Write failed\n");
+            ret = -1;
+            goto done;
+        }
+        total += n;
+    }
+
+    printf("%s -> %s + %s (%llu chains)\n", table_path, ends_path, starts_path,
+           (unsigned long long)total);
+
+done:
+    free(pairs);
+    free(ends);
+    free(starts);
+    fclose(in);
+    if (ends_f && fclose(ends_f) != 0) ret = -1;
+    if (starts_f && fclose(starts_f) != 0) ret = -1;
+    if (ret != 0) {
+        remove(ends_path);
+        remove(starts_path);
+    }
+    return ret;
+}
+
+static int convert_ef(const char *table_path, const char *out_dir) {
+    char ef_path[1024], starts_path[1024];
+    output_path(table_path, out_dir, ".rtef", ef_path, sizeof(ef_path));
+    table_starts_path(ef_path, starts_path, sizeof(starts_path));
+
+    FILE *in = fopen(table_path, "rb");
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", table_path);
+        return -1;
+    }
+    fseeko(in, 0, SEEK_END);
+    uint64_t num_chains = ftello(in) / 16;
+    fseeko(in, 0, SEEK_SET);
+
+    ef_header header;
+    memcpy(header.magic, EF_MAGIC, 4);
+    header.block_size = EF_BLOCK_SIZE;
+    header.num_chains = num_chains;
+    header.num_blocks = (num_chains + EF_BLOCK_SIZE - 1) / EF_BLOCK_SIZE;
+    header.data_offset = sizeof(ef_header) + header.num_blocks * sizeof(ef_block);
+
+    FILE *ef_f = fopen(ef_path, "wb");
+    FILE *starts_f = fopen(starts_path, "wb");
+    ef_block *blocks = calloc(header.num_blocks ? header.num_blocks : 1, sizeof(ef_block));
+    uint64_t *pairs = malloc(CONVERT_CHUNK_CHAINS * 16);
+    uint64_t *ends = malloc(CONVERT_CHUNK_CHAINS * 8);
+    uint64_t *starts = malloc(CONVERT_CHUNK_CHAINS * 8);
+    uint64_t *encoded = malloc(ef_block_max_bytes(EF_BLOCK_SIZE));
+    int ret = 0;
+
+    if (!ef_f || !starts_f || !blocks || !pairs || !ends || !starts || !encoded) {
+        fprintf(stderr, "Cannot create %s / %s\n", ef_path, starts_path);
+        ret = -1;
+        goto done;
+    }
+
+    // Block data follows the directory, which is written last
+    fseeko(ef_f, header.data_offset, SEEK_SET);
+
+    uint64_t total = 0, data_bytes = 0, prev_end = 0, b = 0;
+    size_t n;
+    while ((n = fread(pairs, 16, CONVERT_CHUNK_CHAINS, in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            starts[i] = pairs[i * 2];
+            ends[i] = pairs[i * 2 + 1];
+            if ((total || i) && ends[i] < prev_end) {
+                fprintf(stderr, "%s is not sorted by end index (chain %llu)\n",
+                        table_path, (unsigned long long)(total + i));
+                ret = -1;
+                goto done;
+            }
+            prev_end = ends[i];
+        }
+
+        for (size_t i = 0; i < n; i += EF_BLOCK_SIZE, b++) {
+            uint32_t count = (n - i) < EF_BLOCK_SIZE ? (uint32_t)(n - i) : EF_BLOCK_SIZE;
+            size_t bytes = ef_encode_block(ends + i, count, &blocks[b], encoded);
+            blocks[b].offset = data_bytes;
+            if (fwrite(encoded, 1, bytes, ef_f) != bytes) {
+                fprintf(stderr, "Write failed\n");
+                ret = -1;
+                goto done;
+            }
+            data_bytes += bytes;
+        }
+
+        if (fwrite(starts, 8, n, starts_f) != n) {
+            fprintf(stderr, "Write failed\n");
+            ret = -1;
+            goto done;
+        }
+        total += n;
+    }
+
+    fseeko(ef_f, 0, SEEK_SET);
+    if (fwrite(&header, sizeof(header), 1, ef_f) != 1 ||
+        fwrite(blocks, sizeof(ef_block), header.num_blocks, ef_f) != header.num_blocks) {
+        fprintf(stderr, "Write failed\n");
+        ret = -1;
+        goto done;
+    }
+
+    printf("%s -> %s + %s (%llu chains, %.1f bits/chain for ends)\n", table_path, ef_path,
+           starts_path, (unsigned long long)total,
+           total ? (header.data_offset + data_bytes) * 8.0 / total : 0.0);
+
+done:
+    free(blocks);
+    free(pairs);
+    free(ends);
+    free(starts);
+    free(encoded);
+    fclose(in);
+    if (ef_f && fclose(ef_f) != 0) ret = -1;
+    if (starts_f && fclose(starts_f) != 0) ret = -1;
+    if (ret != 0) {
+        remove(ef_path);
+        remove(starts_path);
+    }
+    return ret;
+}
+
+static int convert_stree(const char *table_path, const char *out_dir) {
+    char stree_path[1024];
+    output_path(table_path, out_dir, ".rtst", stree_path, sizeof(stree_path));
+
+    rt_table table = {0};
+    if (table_load(&table, table_path) != 0) {
+        fprintf(stderr, "Cannot load %s\n", table_path);
+        return -1;
+    }
+    if (table.num_chains <= STREE_FANOUT) {
+        fprintf(stderr, "%s is too small to need a search tree\n", table_path);
+        table_free(&table);
+        return -1;
+    }
+    for (uint64_t i = 1; i < table.num_chains; i++) {
+        if (table.ends[i * table.stride] < table.ends[(i - 1) * table.stride]) {
+            fprintf(stderr, "%s is not sorted by end index (chain %llu)\n",
+                    table_path, (unsigned long long)i);
+            table_free(&table);
+            return -1;
+        }
+    }
+
+    FILE *out = fopen(stree_path, "wb");
+    if (!out) {
+        fprintf(stderr, "Cannot create %s\n", stree_path);
+        table_free(&table);
+        return -1;
+    }
+    int64_t size = stree_write(out, table.ends, table.stride, table.num_chains);
+    int ret = size < 0 ? -1 : 0;
+    if (fclose(out) != 0) ret = -1;
+    if (ret != 0) {
+        fprintf(stderr, "Write failed\n");
+        remove(stree_path);
+    } else {
+        printf("%s -> %s (%llu chains, %.1f MB)\n", table_path, stree_path,
+               (unsigned long long)table.num_chains, size / (1024.0 * 1024.0));
+    }
+    table_free(&table);
+    return ret;
+}
+
+static int convert_meta(const char *table_path, const char *out_dir) {
+    char meta_path[1024];
+    output_path(table_path, out_dir, ".rtm", meta_path, sizeof(meta_path));
+
+    rt_table table = {0};
+    if (table_load(&table, table_path) != 0) {
+        fprintf(stderr, "Cannot load %s\n", table_path);
+        return -1;
+    }
+
+    FILE *out = fopen(meta_path, "wb");
+    if (!out) {
+        fprintf(stderr, "Cannot create %s\n", meta_path);
+        table_free(&table);
+        return -1;
+    }
+    uint32_t flags;
+    int64_t size = table_meta_write(out, table.size, table.ends, table.stride, table.num_chains,
+                                    &flags);
+    int ret = size < 0 ? -1 : 0;
+    if (fclose(out) != 0) ret = -1;
+    if (ret != 0) {
+        fprintf(stderr, "Write failed\n");
+        remove(meta_path);
+    } else {
+        uint64_t pages = ((uint64_t)table.size + TABLE_META_PAGE - 1) / TABLE_META_PAGE;
+        printf("%s -> %s (%llu chains, %llu pages%s)\n", table_path, meta_path,
+               (unsigned long long)table.num_chains, (unsigned long long)pages,
+               (flags & TABLE_META_SORTED) ? "" : ", not sorted: paged lookups disabled");
+    }
+    table_free(&table);
+    return ret;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const char *format = argv[1];
+    const char *table_path = argv[2];
+    const char *out_dir = argc > 3 ? argv[3] : NULL;
+
+    table_format input = table_format_of(table_path);
+    int sidecar = strcmp(format, "stree") == 0 || strcmp(format, "meta") == 0;
+    if (input != TABLE_FORMAT_RT && !(sidecar && input == TABLE_FORMAT_SPLIT)) {
+        fprintf(stderr, "Input must be a .rt table%s\n", sidecar ? " or .rte end column" : "");
+        return 1;
+    }
+
+    int ret;
+    if (strcmp(format, "stree") == 0) {
+        ret = convert_stree(table_path, out_dir);
+    } else if (strcmp(format, "meta") == 0) {
+        ret = convert_meta(table_path, out_dir);
+    } else if (strcmp(format, "split") == 0) {
+        ret = convert_split(table_path, out_dir);
+    } else if (strcmp(format, "ef") == 0) {
+        ret = convert_ef(table_path, out_dir);
+    } else {
+        usage(argv[0]);
+        return 1;
+    }
+
+    return ret == 0 ? 0 : 1;
+}
\ No newline at end of file
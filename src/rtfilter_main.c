@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "table_filter.h"
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-b 8|16] <out.rtfs> <table.rt|table.rte ...>\n", prog);
+    fprintf(stderr, "Builds one filter set over the tables for gpu_lookup -F.\n");
+    fprintf(stderr, "  -b  Fingerprint bits: 8 (~9 bits/chain, 1/256 false positives,\n");
+    fprintf(stderr, "      default) or 16 (~18 bits/chain, 1/65536)\n");
+}
+
+int main(int argc, char **argv) {
+    uint32_t fp_bits = 8;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:")) != -1) {
+        if (opt != 'b') {
+            usage(argv[0]);
+            return 1;
+        }
+        fp_bits = atoi(optarg);
+    }
+    if (argc - optind < 2 || (fp_bits != 8 && fp_bits != 16)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    clock_t start = clock();
+    if (table_filter_build(argv[optind], &argv[optind + 1], argc - optind - 1, fp_bits) != 0) {
+        return 1;
+    }
+    printf("Built in %.1f s\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+    return 0;
+}
\ No newline at end of file
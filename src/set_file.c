@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "set_file.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+static const char *base_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    const char *bslash = strrchr(path, '\\');
+    if (bslash && (!slash || bslash > slash)) slash = bslash;
+    return slash ? slash + 1 : path;
+}
+
+static int64_t file_size_of(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (int64_t)st.st_size : -1;
+}
+
+int set_file_read_at(int fd, void *buf, size_t len, uint64_t offset) {
+#ifdef _WIN32
+    if (_lseeki64(fd, offset, SEEK_SET) < 0) return -1;
+    return _read(fd, buf, (unsigned)len) == (int)len ? 0 : -1;
+#else
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pread(fd, (uint8_t *)buf + done, len - done, offset + done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+#endif
+}
+
+int set_file_write_at(FILE *f, uint64_t offset, const void *data, size_t len) {
+    if (fseeko(f, offset, SEEK_SET) != 0) return -1;
+    return len == 0 || fwrite(data, 1, len, f) == len ? 0 : -1;
+}
+
+// ============ Build ============
+
+// Loads one table, checks it and fills the entry's table part before the
+// set's own build_entry runs
+static int build_table(FILE *out, const char *path, void *entry, size_t entry_size,
+                       uint64_t *offset, set_file_build_fn build_entry, void *arg) {
+    rt_table table = {0};
+    if (table_load(&table, path) != 0) {
+        fprintf(stderr, "Cannot load %s\n", path);
+        return -1;
+    }
+    int ret = -1;
+    const uint64_t *ends = table.ends;
+    uint64_t n = table.num_chains;
+
+    if (table.format != TABLE_FORMAT_RT && table.format != TABLE_FORMAT_SPLIT) {
+        fprintf(stderr, "%s: only .rt and .rte tables can be added\n", path);
+        goto done;
+    }
+    if (n == 0 || strlen(base_name(path)) >= SET_FILE_NAME_LEN) {
+        fprintf(stderr, "%s: empty table or name too long\n", path);
+        goto done;
+    }
+    for (uint64_t i = 1; i < n; i++) {
+        if (ends[i * table.stride] < ends[(i - 1) * table.stride]) {
+            fprintf(stderr, "%s is not sorted by end index (chain %llu)\n", path,
+                    (unsigned long long)i);
+            goto done;
+        }
+    }
+
+    memset(entry, 0, entry_size);
+    set_file_table *t = entry;
+    snprintf(t->name, sizeof(t->name), "%s", base_name(path));
+    t->file_size = file_size_of(path);
+    t->num_chains = n;
+    t->first_end = ends[0];
+    t->last_end = ends[(n - 1) * table.stride];
+    ret = build_entry(out, &table, path, entry, offset, arg);
+
+done:
+    table_free(&table);
+    return ret;
+}
+
+int64_t set_file_build(const char *out_path, const char *magic, uint32_t version,
+                       uint32_t block_size, char **table_paths, int num_tables,
+                       size_t entry_size, set_file_build_fn build_entry, void *arg,
+                       uint64_t *total_chains) {
+    for (int i = 0; i < num_tables; i++) {
+        for (int j = 0; j < i; j++) {
+            if (strcmp(base_name(table_paths[i]), base_name(table_paths[j])) == 0) {
+                fprintf(stderr, "%s and %s have the same file name\n", table_paths[j],
+                        table_paths[i]);
+                return -1;
+            }
+        }
+    }
+
+    uint8_t *entries = calloc(num_tables ? num_tables : 1, entry_size);
+    FILE *out = fopen(out_path, "wb");
+    if (!entries || !out) {
+        fprintf(stderr, "Cannot create %s\n", out_path);
+        free(entries);
+        if (out) fclose(out);
+        return -1;
+    }
+
+    set_file_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, magic, 4);
+    h.version = version;
+    h.num_tables = num_tables;
+    h.block_size = block_size;
+
+    // Table data follows the directory, which is written last
+    uint64_t offset = sizeof(h) + (uint64_t)num_tables * entry_size;
+    *total_chains = 0;
+    int ret = 0;
+    for (int i = 0; i < num_tables && ret == 0; i++) {
+        void *entry = entries + (size_t)i * entry_size;
+        ret = build_table(out, table_paths[i], entry, entry_size, &offset, build_entry, arg);
+        if (ret == 0) {
+            const set_file_table *t = entry;
+            *total_chains += t->num_chains;
+            printf("[%d/%d] %s (%llu chains)\n", i + 1, num_tables, table_paths[i],
+                   (unsigned long long)t->num_chains);
+        }
+    }
+
+    h.file_size = offset;
+    if (ret == 0 && (set_file_write_at(out, 0, &h, sizeof(h)) != 0 ||
+                     set_file_write_at(out, sizeof(h), entries,
+                                       (size_t)num_tables * entry_size) != 0)) {
+        fprintf(stderr, "Write failed\n");
+        ret = -1;
+    }
+    if (fclose(out) != 0) ret = -1;
+    free(entries);
+    if (ret != 0) {
+        remove(out_path);
+        return -1;
+    }
+    return (int64_t)offset;
+}
+
+// ============ Lookup ============
+
+int set_file_open(const char *path, const char *magic, uint32_t version, uint32_t block_size,
+                  size_t entry_size, const uint8_t **data, size_t *size) {
+    *data = NULL;
+    *size = 0;
+    int64_t file_size = file_size_of(path);
+    if (file_size < (int64_t)sizeof(set_file_header)) return -1;
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    void *p = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+    // Lookups land anywhere in the data; fault everything in up front
+#ifdef MADV_POPULATE_READ
+    if (madvise(p, file_size, MADV_POPULATE_READ) != 0)
+#endif
+        madvise(p, file_size, MADV_WILLNEED);
+#else
+    FILE *f = fopen(path, "rb");
+    void *p = f ? malloc(file_size) : NULL;
+    if (!p || fread(p, 1, file_size, f) != (size_t)file_size) {
+        free(p);
+        if (f) fclose(f);
+        return -1;
+    }
+    fclose(f);
+#endif
+
+    const set_file_header *h = p;
+    if (memcmp(h->magic, magic, 4) != 0 || h->version != version ||
+        h->block_size != block_size || h->file_size != (uint64_t)file_size ||
+        sizeof(set_file_header) + (uint64_t)h->num_tables * entry_size > (uint64_t)file_size) {
+        set_file_close(p, file_size);
+        return -1;
+    }
+    *data = p;
+    *size = file_size;
+    return 0;
+}
+
+void set_file_close(const uint8_t *data, size_t size) {
+    if (!data) return;
+#ifndef _WIN32
+    munmap((void *)data, size);
+#else
+    (void)size;
+    free((void *)data);
+#endif
+}
+
+const void *set_file_find(const uint8_t *data, size_t entry_size, const char *table_path) {
+    const set_file_header *h = (const set_file_header *)data;
+    const uint8_t *entries = data + sizeof(set_file_header);
+    const char *name = base_name(table_path);
+    for (uint32_t i = 0; i < h->num_tables; i++) {
+        const set_file_table *t = (const set_file_table *)(entries + (size_t)i * entry_size);
+        if (strcmp(t->name, name) != 0) continue;
+        return file_size_of(table_path) == (int64_t)t->file_size ? t : NULL;
+    }
+    return NULL;
+}
+
+void set_file_query_range(const set_file_table *t, const rt_query *queries,
+                          uint32_t num_queries, uint32_t *q, uint32_t *q_end) {
+    *q = 0;
+    *q_end = num_queries;
+    while (*q < *q_end && queries[*q].end < t->first_end) (*q)++;
+    while (*q_end > *q && queries[*q_end - 1].end > t->last_end) (*q_end)--;
+}
+
+int set_file_read_batch(uring *ring, unsigned queue_depth, int fd, const set_file_read *reads,
+                        uint32_t count) {
+    if (!ring) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (set_file_read_at(fd, reads[i].buf, reads[i].len, reads[i].offset) != 0) return -1;
+        }
+        return 0;
+    }
+
+    uint32_t submitted = 0, completed = 0;
+    int err = 0;
+    while (completed < count && !err) {
+        while (submitted < count && submitted - completed < queue_depth) {
+            const set_file_read *r = &reads[submitted];
+            if (uring_prep_read(ring, fd, r->buf, r->len, r->offset, -1, submitted) != 0) break;
+            submitted++;
+        }
+        if (uring_submit(ring, 1) != 0) {
+            err = 1;
+            break;
+        }
+        uint64_t i;
+        int res;
+        while (uring_reap(ring, &i, &res)) {
+            if (res < 0 || (uint32_t)res != reads[i].len) err = 1;
+            completed++;
+        }
+    }
+    // Drain reads still in flight before the buffers are reused
+    while (completed < submitted && uring_submit(ring, 1) == 0) {
+        uint64_t i;
+        int res;
+        while (uring_reap(ring, &i, &res)) completed++;
+    }
+    return err || completed < count ? -1 : 0;
+}
\ No newline at end of file
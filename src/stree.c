@@ -0,0 +1,224 @@
+#include <string.h>
+#include "stree.h"
+
+// Without -mavx2 the AVX2 node compare is still built on x86-64 and
+// picked at run time when the CPU has it
+#if defined(__x86_64__) && !defined(__AVX2__)
+#define STREE_AVX2_DISPATCH
+#endif
+#if defined(__AVX2__) || defined(STREE_AVX2_DISPATCH)
+#include <immintrin.h>
+#endif
+
+#define WRITE_CHUNK_KEYS 4096
+
+#ifdef STREE_AVX2_DISPATCH
+static int have_avx2 = -1;
+#endif
+
+// Level offsets (root first) and total key count for n chains; returns
+// the number of levels, 0 if the table is too small for a tree
+static uint32_t stree_layout(uint64_t n, uint64_t *level_offset, uint64_t *total_keys) {
+    uint64_t keys[STREE_MAX_LEVELS + 1];
+    uint32_t levels = 0;
+    keys[0] = n;
+    while (keys[levels] > STREE_FANOUT && levels < STREE_MAX_LEVELS) {
+        keys[levels + 1] = (keys[levels] + STREE_FANOUT - 1) / STREE_FANOUT;
+        levels++;
+    }
+    if (keys[levels] > STREE_FANOUT) return 0;
+
+    uint64_t offset = 0;
+    for (uint32_t l = 0; l < levels; l++) {
+        uint64_t nodes = (keys[levels - l] + STREE_FANOUT - 1) / STREE_FANOUT;
+        level_offset[l] = offset;
+        offset += nodes * STREE_FANOUT;
+    }
+    *total_keys = offset;
+    return levels;
+}
+
+int stree_open(stree_view *v, const void *data, size_t size) {
+    memset(v, 0, sizeof(stree_view));
+    if (size < sizeof(stree_header)) return -1;
+
+    const stree_header *h = data;
+    uint64_t offsets[STREE_MAX_LEVELS], total;
+    if (memcmp(h->magic, STREE_MAGIC, 4) != 0 || h->fanout != STREE_FANOUT ||
+        h->num_levels == 0 || h->num_levels > STREE_MAX_LEVELS ||
+        stree_layout(h->num_chains, offsets, &total) != h->num_levels ||
+        sizeof(stree_header) + total * sizeof(uint64_t) != size) {
+        return -1;
+    }
+    for (uint32_t l = 0; l < h->num_levels; l++) {
+        if (h->level_offset[l] != offsets[l]) return -1;
+    }
+
+    v->header = h;
+    v->keys = (const uint64_t *)(h + 1);
+#ifdef STREE_AVX2_DISPATCH
+    if (have_avx2 < 0) have_avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    return 0;
+}
+
+#if defined(__AVX2__) || defined(STREE_AVX2_DISPATCH)
+// Both halves of the node in two compares; ends and STREE_PAD fit in 63
+// bits, so signed compares are exact
+__attribute__((target("avx2")))
+static inline uint32_t rank_avx2(const uint64_t *node, uint64_t key) {
+    __m256i k = _mm256_set1_epi64x((long long)key);
+    __m256i lo = _mm256_cmpgt_epi64(k, _mm256_loadu_si256((const __m256i *)node));
+    __m256i hi = _mm256_cmpgt_epi64(k, _mm256_loadu_si256((const __m256i *)(node + 4)));
+    uint32_t mask = (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(lo)) |
+                    (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(hi)) << 4;
+    return (uint32_t)__builtin_popcount(mask);
+}
+#else
+static inline uint32_t rank_avx2(const uint64_t *node, uint64_t key) {
+    (void)node; (void)key;
+    return 0;
+}
+#endif
+
+// Branchless count of the keys below key
+static inline uint32_t rank_scalar(const uint64_t *node, uint64_t key) {
+    uint32_t rank = 0;
+    for (uint32_t i = 0; i < STREE_FANOUT; i++) rank += node[i] < key;
+    return rank;
+}
+
+static inline const uint64_t *node_at(const stree_view *v, uint32_t level, uint64_t idx) {
+    return v->keys + v->header->level_offset[level] + idx * STREE_FANOUT;
+}
+
+// Lower bound within the leaf block of 8 chains
+static inline uint64_t leaf_rank(const uint64_t *ends, uint32_t stride, uint64_t n,
+                                 uint64_t block, uint64_t key) {
+    uint64_t base = block * STREE_FANOUT;
+    uint64_t count = n - base < STREE_FANOUT ? n - base : STREE_FANOUT;
+    uint64_t rank = 0;
+    for (uint64_t i = 0; i < count; i++) rank += ends[(base + i) * stride] < key;
+    return base + rank;
+}
+
+// The searches are written once and instantiated with and without AVX2,
+// so the node compare inlines into each
+static inline __attribute__((always_inline))
+uint64_t lower_bound_impl(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                          uint64_t key, int avx2) {
+    const stree_header *h = v->header;
+    // The root may have fewer than 8 real keys; anything past the last end
+    // would otherwise descend into a child that does not exist
+    if (key > h->last_end) return h->num_chains;
+
+    uint64_t idx = 0;
+    for (uint32_t l = 0; l < h->num_levels; l++) {
+        const uint64_t *node = node_at(v, l, idx);
+        idx = idx * STREE_FANOUT + (avx2 ? rank_avx2(node, key) : rank_scalar(node, key));
+    }
+    return leaf_rank(ends, stride, h->num_chains, idx, key);
+}
+
+static inline __attribute__((always_inline))
+void lower_bound_batch_impl(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                            const uint64_t *keys, uint32_t count, uint64_t *chains, int avx2) {
+    const stree_header *h = v->header;
+    for (uint32_t j = 0; j < count; j++) chains[j] = 0;
+
+    for (uint32_t l = 0; l < h->num_levels; l++) {
+        for (uint32_t j = 0; j < count; j++) {
+            if (keys[j] > h->last_end) continue;
+            const uint64_t *node = node_at(v, l, chains[j]);
+            chains[j] = chains[j] * STREE_FANOUT +
+                        (avx2 ? rank_avx2(node, keys[j]) : rank_scalar(node, keys[j]));
+            if (l + 1 < h->num_levels) {
+                __builtin_prefetch(node_at(v, l + 1, chains[j]));
+            } else {
+                const uint64_t *leaf = &ends[chains[j] * STREE_FANOUT * stride];
+                __builtin_prefetch(leaf);
+                __builtin_prefetch(leaf + (STREE_FANOUT - 1) * stride);
+            }
+        }
+    }
+
+    for (uint32_t j = 0; j < count; j++) {
+        chains[j] = keys[j] > h->last_end ? h->num_chains :
+                    leaf_rank(ends, stride, h->num_chains, chains[j], keys[j]);
+    }
+}
+
+#ifdef STREE_AVX2_DISPATCH
+__attribute__((target("avx2")))
+static uint64_t lower_bound_avx2(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                                 uint64_t key) {
+    return lower_bound_impl(v, ends, stride, key, 1);
+}
+
+__attribute__((target("avx2")))
+static void lower_bound_batch_avx2(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                                   const uint64_t *keys, uint32_t count, uint64_t *chains) {
+    lower_bound_batch_impl(v, ends, stride, keys, count, chains, 1);
+}
+#endif
+
+uint64_t stree_lower_bound(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                           uint64_t key) {
+#if defined(__AVX2__)
+    return lower_bound_impl(v, ends, stride, key, 1);
+#else
+#ifdef STREE_AVX2_DISPATCH
+    if (have_avx2) return lower_bound_avx2(v, ends, stride, key);
+#endif
+    return lower_bound_impl(v, ends, stride, key, 0);
+#endif
+}
+
+void stree_lower_bound_batch(const stree_view *v, const uint64_t *ends, uint32_t stride,
+                             const uint64_t *keys, uint32_t count, uint64_t *chains) {
+#if defined(__AVX2__)
+    lower_bound_batch_impl(v, ends, stride, keys, count, chains, 1);
+#else
+#ifdef STREE_AVX2_DISPATCH
+    if (have_avx2) {
+        lower_bound_batch_avx2(v, ends, stride, keys, count, chains);
+        return;
+    }
+#endif
+    lower_bound_batch_impl(v, ends, stride, keys, count, chains, 0);
+#endif
+}
+
+int64_t stree_write(FILE *out, const uint64_t *ends, uint32_t stride, uint64_t n) {
+    stree_header h;
+    uint64_t total;
+    memset(&h, 0, sizeof(h));
+    h.num_levels = stree_layout(n, h.level_offset, &total);
+    if (h.num_levels == 0 || n <= STREE_FANOUT) return -1;
+    memcpy(h.magic, STREE_MAGIC, 4);
+    h.fanout = STREE_FANOUT;
+    h.num_chains = n;
+    h.first_end = ends[0];
+    h.last_end = ends[(n - 1) * stride];
+    if (fwrite(&h, sizeof(h), 1, out) != 1) return -1;
+
+    uint64_t buf[WRITE_CHUNK_KEYS];
+    for (uint32_t l = 0; l < h.num_levels; l++) {
+        // Chains under one key at this level
+        uint64_t span = 1;
+        for (uint32_t d = l; d < h.num_levels; d++) span *= STREE_FANOUT;
+        uint64_t level_end = l + 1 < h.num_levels ? h.level_offset[l + 1] : total;
+        uint64_t keys = level_end - h.level_offset[l];
+
+        for (uint64_t j = 0; j < keys; j += WRITE_CHUNK_KEYS) {
+            uint64_t count = keys - j < WRITE_CHUNK_KEYS ? keys - j : WRITE_CHUNK_KEYS;
+            for (uint64_t k = 0; k < count; k++) {
+                uint64_t first = (j + k) * span;
+                uint64_t last = first + span < n ? first + span : n;
+                buf[k] = first < n ? ends[(last - 1) * stride] : STREE_PAD;
+            }
+            if (fwrite(buf, sizeof(uint64_t), count, out) != count) return -1;
+        }
+    }
+    return (int64_t)(sizeof(stree_header) + total * sizeof(uint64_t));
+}
\ No newline at end of file
@@ -1,17 +1,192 @@
+#ifdef __linux__
+#define _GNU_SOURCE        // O_DIRECT
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
 #include "table.h"
+#include "uring.h"
+#include "table_cache.h"
 
-int table_load(rt_table *table, const char *filename) {
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define IO_ALIGN 4096
+#define DEFAULT_QUEUE_DEPTH 32
+#define DEFAULT_BLOCK_SIZE (1024 * 1024)
+
+static table_io_backend io_backend = TABLE_IO_MMAP;
+static unsigned io_queue_depth = DEFAULT_QUEUE_DEPTH;
+static size_t io_block_size = DEFAULT_BLOCK_SIZE;
+static table_cache cache;
+static int cache_open = 0;
+
+// ============ I/O Backend ============
+
+void table_set_io(table_io_backend backend, unsigned queue_depth, size_t block_size) {
+    io_backend = backend;
+    io_queue_depth = queue_depth ? queue_depth : DEFAULT_QUEUE_DEPTH;
+    if (block_size == 0) block_size = DEFAULT_BLOCK_SIZE;
+    io_block_size = (block_size + IO_ALIGN - 1) / IO_ALIGN * IO_ALIGN;
+}
+
+int table_io_parse(const char *name, table_io_backend *backend) {
+    if (strcmp(name, "mmap") == 0) *backend = TABLE_IO_MMAP;
+    else if (strcmp(name, "buffered") == 0) *backend = TABLE_IO_BUFFERED;
+    else if (strcmp(name, "uring") == 0) *backend = TABLE_IO_URING;
+    else return -1;
+    return 0;
+}
+
+int table_set_cache(const char *dir) {
+    if (cache_open) table_cache_close(&cache);
+    cache_open = table_cache_open(&cache, dir, 0) == 0;
+    return cache_open ? 0 : -1;
+}
+
+const char *table_io_name(table_io_backend backend) {
+    switch (backend) {
+    case TABLE_IO_BUFFERED: return "buffered";
+    case TABLE_IO_URING: return "io_uring";
+    default: return "mmap";
+    }
+}
+
+// ============ Formats ============
+
+static int has_suffix(const char *s, const char *suffix) {
+    size_t len = strlen(s), slen = strlen(suffix);
+    return len >= slen && strcmp(s + len - slen, suffix) == 0;
+}
+
+table_format table_format_of(const char *filename) {
+    if (has_suffix(filename, ".rte")) return TABLE_FORMAT_SPLIT;
+    if (has_suffix(filename, ".rtef")) return TABLE_FORMAT_EF;
+    if (has_suffix(filename, ".rtc")) return TABLE_FORMAT_RTC;
+    return TABLE_FORMAT_RT;
+}
+
+void table_starts_path(const char *ends_path, char *starts_path, size_t size) {
+    snprintf(starts_path, size, "%s", ends_path);
+    char *dot = strrchr(starts_path, '.');
+    if (dot && (size_t)(dot - starts_path) + 5 <= size) strcpy(dot, ".rts");
+}
+
+void table_stree_path(const char *table_path, char *stree_path, size_t size) {
+    snprintf(stree_path, size, "%s", table_path);
+    char *dot = strrchr(stree_path, '.');
+    if (dot && (size_t)(dot - stree_path) + 6 <= size) strcpy(dot, ".rtst");
+}
+
+void table_meta_path(const char *table_path, char *meta_path, size_t size) {
+    snprintf(meta_path, size, "%s", table_path);
+    char *dot = strrchr(meta_path, '.');
+    if (dot && (size_t)(dot - meta_path) + 5 <= size) strcpy(dot, ".rtm");
+}
+
+static int open_starts(const char *ends_path) {
+    char starts_path[1024];
+    table_starts_path(ends_path, starts_path, sizeof(starts_path));
+    if (cache_open) {
+        uint64_t size;
+        size_t map_size;
+        int fd = table_cache_file(&cache, starts_path, &size, &map_size);
+        if (fd >= 0) return fd;
+    }
+    return open(starts_path, O_RDONLY | O_BINARY);
+}
+
+static int read_u64_at(int fd, uint64_t offset, uint64_t *value) {
+#ifdef _WIN32
+    if (_lseeki64(fd, offset, SEEK_SET) < 0) return -1;
+    return _read(fd, value, 8) == 8 ? 0 : -1;
+#else
+    return pread(fd, value, 8, offset) == 8 ? 0 : -1;
+#endif
+}
+
+// ============ Loading ============
+
+#ifndef _WIN32
+// Smallest file that holds one chain: an .rt record, or an end of the
+// other formats (whose headers are checked once loaded)
+static int64_t min_table_size(table_format format) {
+    return format == TABLE_FORMAT_RT ? 16 : 8;
+}
+
+static int table_map(rt_table *table, const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < min_table_size(table->format)) {
+        close(fd);
+        return -1;
+    }
+
+    void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+
+    // Kick off readahead for the whole file; binary search touches every
+    // region of the table, so there is no point faulting it in page by page.
+    madvise(p, st.st_size, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+    madvise(p, st.st_size, MADV_HUGEPAGE);
+#endif
+
+    table->data = p;
+    table->size = st.st_size;
+    table->map_size = st.st_size;
+    table->mapped = 1;
+    return 0;
+}
+
+// Shared-memory copy from the resident cache; already in RAM, so only the
+// page tables need filling.
+static int table_map_cached(rt_table *table, const char *filename) {
+    uint64_t size;
+    size_t map_size;
+    int fd = table_cache_file(&cache, filename, &size, &map_size);
+    if (fd < 0) return -1;
+
+    void *p = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED || size < (uint64_t)min_table_size(table->format)) {
+        if (p != MAP_FAILED) munmap(p, map_size);
+        return -1;
+    }
+
+    table->data = p;
+    table->size = size;
+    table->map_size = map_size;
+    table->mapped = 1;
+    return 0;
+}
+#endif
+
+static int table_read(rt_table *table, const char *filename) {
     FILE *f = fopen(filename, "rb");
     if (!f) return -1;
 
     fseek(f, 0, SEEK_END);
-    long file_size = ftell(f);
+    long long file_size = ftello(f);
     fseek(f, 0, SEEK_SET);
+    if (file_size < min_table_size(table->format)) {
+        fclose(f);
+        return -1;
+    }
 
-    table->num_chains = file_size / 16;
     table->data = malloc(file_size);
     
     if (!table->data) {
@@ -21,40 +196,587 @@ int table_load(rt_table *table, const char *filename) {
     
     if (fread(table->data, 1, file_size, f) != (size_t)file_size) {
         free(table->data);
+        table->data = NULL;
         fclose(f);
         return -1;
     }
     
     fclose(f);
+    table->size = file_size;
+    table->mapped = 0;
+    return 0;
+}
+
+#ifdef __linux__
+// O_DIRECT where the filesystem supports it, plain reads otherwise
+static int open_direct(const char *filename) {
+    int fd = open(filename, O_RDONLY | O_DIRECT);
+    if (fd < 0) fd = open(filename, O_RDONLY);
+    return fd;
+}
+
+// Reads the whole file into an aligned buffer with queue_depth block
+// reads in flight, bypassing the page cache.
+static int table_read_direct(rt_table *table, const char *filename) {
+    int fd = open_direct(filename);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < min_table_size(table->format)) {
+        close(fd);
+        return -1;
+    }
+
+    uring ring;
+    if (uring_init(&ring, io_queue_depth) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = st.st_size;
+    size_t block = io_block_size;
+    uint64_t num_blocks = (size + block - 1) / block;
+    void *buf = NULL;
+    if (posix_memalign(&buf, IO_ALIGN, num_blocks * block) != 0) {
+        uring_exit(&ring);
+        close(fd);
+        return -1;
+    }
+
+    uint64_t submitted = 0, completed = 0;
+    int err = 0;
+    while (completed < num_blocks && !err) {
+        while (submitted < num_blocks && submitted - completed < io_queue_depth &&
+               uring_prep_read(&ring, fd, (uint8_t *)buf + submitted * block, block,
+                               submitted * block, -1, submitted) == 0) {
+            submitted++;
+        }
+        if (uring_submit(&ring, 1) != 0) {
+            err = 1;
+            break;
+        }
+
+        uint64_t b;
+        int res;
+        while (uring_reap(&ring, &b, &res)) {
+            size_t expect = b + 1 < num_blocks ? block : size - b * block;
+            if (res < 0 || (size_t)res != expect) err = 1;
+            completed++;
+        }
+    }
+
+    // Drain reads still in flight before the buffer goes away
+    while (completed < submitted && uring_submit(&ring, 1) == 0) {
+        uint64_t b;
+        int res;
+        while (uring_reap(&ring, &b, &res)) completed++;
+    }
+    uring_exit(&ring);
+    close(fd);
+
+    if (err || completed < submitted) {
+        free(buf);
+        return -1;
+    }
+    table->data = buf;
+    table->size = size;
+    table->mapped = 0;
+    return 0;
+}
+#endif
+
+// Maps a sidecar file read-only (and has it read in: every lookup goes
+// through it), or reads it into memory where mmap is unavailable
+static void *map_sidecar(const char *path, size_t *size) {
+    void *data = NULL;
+    *size = 0;
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        *size = st.st_size;
+        data = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+        else madvise(data, *size, MADV_WILLNEED);
+    }
+    close(fd);
+#else
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseeko(f, 0, SEEK_END);
+    *size = ftello(f);
+    fseeko(f, 0, SEEK_SET);
+    data = *size ? malloc(*size) : NULL;
+    if (data && fread(data, 1, *size, f) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+#endif
+    return data;
+}
+
+static void unmap_sidecar(void *data, size_t size) {
+#ifndef _WIN32
+    munmap(data, size);
+#else
+    (void)size;
+    free(data);
+#endif
+}
+
+// Maps the .rtst sidecar if there is one for this table. A tree built for
+// a different version of the table is ignored.
+static void table_open_stree(rt_table *table, const char *filename) {
+    char path[1024];
+    table_stree_path(filename, path, sizeof(path));
+    size_t size;
+    void *data = map_sidecar(path, &size);
+    if (!data) return;
+
+    stree_view v;
+    uint64_t n = table->num_chains;
+    if (stree_open(&v, data, size) == 0 && v.header->num_chains == n &&
+        v.header->first_end == table->ends[0] &&
+        v.header->last_end == table->ends[(n - 1) * table->stride]) {
+        table->stree = v;
+        table->stree_data = data;
+        table->stree_size = size;
+        return;
+    }
+    fprintf(stderr, "%s: search tree does not match the table, ignored\n", path);
+    unmap_sidecar(data, size);
+}
+
+int table_load(rt_table *table, const char *filename) {
+    table->format = table_format_of(filename);
+    table->starts_fd = -1;
+    table->radix = NULL;
+    memset(&table->stree, 0, sizeof(stree_view));
+    table->stree_data = NULL;
+    table->paged = 0;
+    table->fd = -1;
+    table->meta_data = NULL;
+    table->page = NULL;
+
+    int ret = -1;
+#ifndef _WIN32
+    if (cache_open) ret = table_map_cached(table, filename);
+#endif
+#ifdef __linux__
+    if (ret != 0 && io_backend == TABLE_IO_URING) ret = table_read_direct(table, filename);
+#endif
+#ifndef _WIN32
+    if (ret != 0 && io_backend == TABLE_IO_MMAP) ret = table_map(table, filename);
+#endif
+    if (ret != 0) ret = table_read(table, filename);
+    if (ret != 0) return -1;
+
+    if (table->format == TABLE_FORMAT_SPLIT || table->format == TABLE_FORMAT_EF) {
+        table->starts_fd = open_starts(filename);
+        if (table->starts_fd < 0) {
+            table_free(table);
+            return -1;
+        }
+    }
+
+    if (table->format == TABLE_FORMAT_EF) {
+        const ef_header *h = (const ef_header *)table->data;
+        if (table->size < sizeof(ef_header) || memcmp(h->magic, EF_MAGIC, 4) != 0 ||
+            h->data_offset > table->size ||
+            h->num_blocks * sizeof(ef_block) > h->data_offset) {
+            fprintf(stderr, "%s: not an EF table\n", filename);
+            table_free(table);
+            return -1;
+        }
+        table->ef = h;
+        table->ef_blocks = (const ef_block *)(h + 1);
+        table->ef_data = (const uint8_t *)table->data + h->data_offset;
+        table->num_chains = h->num_chains;
+        table->ends = NULL;
+        table->stride = 0;
+    } else if (table->format == TABLE_FORMAT_RTC) {
+#ifndef TABLE_RTC_EXPERIMENTAL
+        fprintf(stderr, "%s: .rtc tables are not supported; convert them to .rt with rtc2rt\n",
+                filename);
+        table_free(table);
+        return -1;
+#endif
+        if (rtc_open(&table->rtc, table->data, table->size) != 0) {
+            fprintf(stderr, "%s: unsupported .rtc version or layout\n", filename);
+            table_free(table);
+            return -1;
+        }
+        table->num_chains = table->rtc.header->chain_count;
+        table->ends = NULL;
+        table->stride = 0;
+    } else if (table->format == TABLE_FORMAT_SPLIT) {
+        table->num_chains = table->size / 8;
+        table->ends = table->data;
+        table->stride = 1;
+    } else {
+        table->num_chains = table->size / 16;
+        table->ends = table->data + 1;
+        table->stride = 2;
+    }
+    if (table->ends && table->num_chains > 0) table_open_stree(table, filename);
+    return 0;
+}
+
+int table_open_paged(rt_table *table, const char *filename) {
+    memset(table, 0, sizeof(rt_table));
+    table->format = table_format_of(filename);
+    table->starts_fd = -1;
+    table->fd = -1;
+    if (table->format != TABLE_FORMAT_RT && table->format != TABLE_FORMAT_SPLIT) return -1;
+    // A table in the resident cache is already in memory; table_load maps it
+    if (cache_open && table_cache_has(&cache, filename)) return -1;
+
+    char path[1024];
+    table_meta_path(filename, path, sizeof(path));
+    table->meta_data = map_sidecar(path, &table->meta_size);
+    if (!table->meta_data) return -1;
+
+    // A sidecar built from the other layout, or an older version of the
+    // file, does not describe this one
+    struct stat st;
+    uint32_t record = table->format == TABLE_FORMAT_SPLIT ? 8 : 16;
+    if (table_meta_open(table->meta_data, table->meta_size, &table->meta, &table->fences) != 0 ||
+        table->meta->record_size != record || !(table->meta->flags & TABLE_META_SORTED) ||
+        stat(filename, &st) != 0 || (uint64_t)st.st_size != table->meta->file_size) {
+        table_free(table);
+        return -1;
+    }
+
+    table->paged = 1;
+    table->fd = open(filename, O_RDONLY | O_BINARY);
+    if (table->format == TABLE_FORMAT_SPLIT) table->starts_fd = open_starts(filename);
+    table->page = malloc(TABLE_META_PAGE);
+    if (table->fd < 0 || (table->format == TABLE_FORMAT_SPLIT && table->starts_fd < 0) ||
+        !table->page) {
+        table_free(table);
+        return -1;
+    }
+    table->page_index = UINT64_MAX;
+    table->num_chains = table->meta->num_chains;
+    table->stride = record / 8;
+    return 0;
+}
+
+int table_populate(rt_table *table) {
+#ifndef _WIN32
+    if (!table->mapped) return 0;
+#ifdef MADV_POPULATE_READ
+    if (madvise(table->data, table->size, MADV_POPULATE_READ) == 0) return 0;
+#endif
+    // Older kernels: touch one word per page
+    volatile const uint8_t *p = (const uint8_t *)table->data;
+    uint8_t sum = 0;
+    for (size_t off = 0; off < table->size; off += 4096) sum += p[off];
+    (void)sum;
+#else
+    (void)table;
+#endif
     return 0;
 }
 
 void table_free(rt_table *table) {
     if (table->data) {
+#ifndef _WIN32
+        if (table->mapped) munmap(table->data, table->map_size);
+        else
+#endif
         free(table->data);
         table->data = NULL;
     }
+    if ((table->format == TABLE_FORMAT_SPLIT || table->format == TABLE_FORMAT_EF) &&
+        table->starts_fd >= 0) {
+        close(table->starts_fd);
+    }
+    table->starts_fd = -1;
+    table->ends = NULL;
+    table->ef = NULL;
+    table->ef_blocks = NULL;
+    table->ef_data = NULL;
+    memset(&table->rtc, 0, sizeof(rtc_view));
+    free(table->radix);
+    table->radix = NULL;
+    if (table->stree_data) unmap_sidecar(table->stree_data, table->stree_size);
+    memset(&table->stree, 0, sizeof(stree_view));
+    table->stree_data = NULL;
+    table->stree_size = 0;
+    if (table->meta_data) unmap_sidecar(table->meta_data, table->meta_size);
+    if (table->paged && table->fd >= 0) close(table->fd);
+    free(table->page);
+    table->meta_data = NULL;
+    table->meta = NULL;
+    table->fences = NULL;
+    table->page = NULL;
+    table->paged = 0;
+    table->fd = -1;
     table->num_chains = 0;
+    table->size = 0;
+    table->map_size = 0;
+    table->mapped = 0;
 }
 
-// data layout: [start0][end0][start1][end1][start2][end2]...
+// ============ Search ============
+
+// .rt layout: [start0][end0][start1][end1][start2][end2]...
 // data[i*2] = start, data[i*2+1] = end
+// .rte layout: [end0][end1][end2]... with starts at the same index in .rts
+
+int table_start(rt_table *table, uint64_t chain, uint64_t *start) {
+    if (table->paged && table->format == TABLE_FORMAT_RT) {
+        // Usually on the page the search just read
+        uint32_t per_page = table->meta->chains_per_page;
+        if (chain / per_page == table->page_index) {
+            *start = table->page[chain % per_page * 2];
+            return 0;
+        }
+        return read_u64_at(table->fd, chain * 16, start);
+    }
+    if (table->format == TABLE_FORMAT_RT) {
+        *start = table->data[chain * 2];
+        return 0;
+    }
+    if (table->format == TABLE_FORMAT_RTC) {
+        *start = rtc_start(&table->rtc, chain);
+        return 0;
+    }
+    return read_u64_at(table->starts_fd, chain * 8, start);
+}
+
+// Start of a matching chain; a start that cannot be read drops the match
+static uint64_t match_start(rt_table *table, uint64_t chain, int *found) {
+    uint64_t start;
+    if (table_start(table, chain, &start) != 0) return 0;
+    *found = 1;
+    return start;
+}
+
+// ============ Paged Search ============
+
+// Reads page p of a paged table unless it is the one already held
+static const uint64_t *paged_read(rt_table *table, uint64_t p) {
+    if (p == table->page_index) return table->page;
+    uint64_t offset = p * TABLE_META_PAGE;
+    size_t len = table->meta->file_size - offset < TABLE_META_PAGE ?
+                 (size_t)(table->meta->file_size - offset) : TABLE_META_PAGE;
+    size_t done = 0;
+#ifdef _WIN32
+    if (_lseeki64(table->fd, offset, SEEK_SET) < 0) return NULL;
+    done = _read(table->fd, table->page, (unsigned)len) == (int)len ? len : 0;
+#else
+    while (done < len) {
+        ssize_t n = pread(table->fd, (uint8_t *)table->page + done, len - done, offset + done);
+        if (n <= 0) break;
+        done += n;
+    }
+#endif
+    // A page that does not start at its fence belongs to a different table
+    // of the same size than the one the sidecar was built from
+    if (done < len || table->page[table->stride - 1] != table->fences[p]) {
+        table->page_index = UINT64_MAX;
+        return NULL;
+    }
+    table->page_index = p;
+    return table->page;
+}
+
+// End of a chain of a paged table; reads its page if needed
+static int paged_end(rt_table *table, uint64_t chain, uint64_t *end) {
+    uint32_t per_page = table->meta->chains_per_page;
+    const uint64_t *page = paged_read(table, chain / per_page);
+    if (!page) return -1;
+    *end = page[chain % per_page * table->stride + table->stride - 1];
+    return 0;
+}
+
+// First chain with end >= key: the fences give the last page starting
+// below key, where it is unless every end on that page is smaller, in
+// which case it is the first chain of the next page. One page read.
+static int paged_lower_bound(rt_table *table, uint64_t key, uint64_t *chain) {
+    const uint64_t *fences = table->fences;
+    uint64_t lo = 0, hi = table->meta->num_fences;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (fences[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) {
+        *chain = 0;
+        return 0;
+    }
+
+    uint64_t p = lo - 1;
+    uint32_t per_page = table->meta->chains_per_page;
+    uint64_t first = p * per_page;
+    uint64_t count = table->num_chains - first < per_page ? table->num_chains - first : per_page;
+    const uint64_t *page = paged_read(table, p);
+    if (!page) return -1;
+    uint32_t stride = table->stride, e = stride - 1;
+    uint64_t a = 0, b = count;
+    while (a < b) {
+        uint64_t mid = a + (b - a) / 2;
+        if (page[mid * stride + e] < key) a = mid + 1;
+        else b = mid;
+    }
+    *chain = first + a;
+    return 0;
+}
+
+static uint64_t paged_search(rt_table *table, uint64_t end_index, int *found) {
+    uint64_t chain, end;
+    if (end_index < table->meta->first_end || end_index > table->meta->last_end) return 0;
+    if (paged_lower_bound(table, end_index, &chain) != 0 || chain >= table->num_chains ||
+        paged_end(table, chain, &end) != 0 || end != end_index) {
+        return 0;
+    }
+    return match_start(table, chain, found);
+}
+
+// Last block whose first end is <= end_index, then a search inside it
+static uint64_t ef_search(rt_table *table, uint64_t end_index, int *found) {
+    const ef_block *blocks = table->ef_blocks;
+    uint64_t lo = 0, hi = table->ef->num_blocks;
+    while (hi - lo > 1) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (blocks[mid].first_end <= end_index) lo = mid;
+        else hi = mid;
+    }
+
+    // Duplicate ends may straddle a block boundary; the first copy wins
+    while (lo > 0 && blocks[lo].first_end == end_index) lo--;
+
+    for (; lo < table->ef->num_blocks && blocks[lo].first_end <= end_index; lo++) {
+        uint32_t idx;
+        const uint64_t *data = (const uint64_t *)(table->ef_data + blocks[lo].offset);
+        if (ef_block_find(&blocks[lo], data, end_index, &idx)) {
+            return match_start(table, lo * table->ef->block_size + idx, found);
+        }
+    }
+    return 0;
+}
+
+#define RADIX_CHAINS_PER_BUCKET_LOG2 5
+#define RADIX_MAX_BITS 24
+#define RADIX_SCAN 8
+
+int table_build_index(rt_table *table) {
+    if (!table->ends || table->radix || table->num_chains == 0 ||
+        table->num_chains >= UINT32_MAX) {
+        return 0;
+    }
+
+    const uint64_t *ends = table->ends;
+    uint32_t stride = table->stride;
+    uint64_t n = table->num_chains;
+
+    uint32_t bits = 0;
+    while (bits < RADIX_MAX_BITS && (n >> (bits + RADIX_CHAINS_PER_BUCKET_LOG2 + 1)) > 0) bits++;
+
+    // Spread the buckets over [0, largest end] rather than the full keyspace
+    uint64_t max_end = ends[(n - 1) * stride];
+    uint32_t key_bits = 64 - (max_end ? __builtin_clzll(max_end) : 63);
+    uint32_t shift = key_bits > bits ? key_bits - bits : 0;
+    uint64_t num_buckets = (max_end >> shift) + 1;
+
+    uint32_t *radix = malloc((num_buckets + 1) * sizeof(uint32_t));
+    if (!radix) return -1;
+
+    uint64_t b = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t bucket = ends[i * stride] >> shift;
+        while (b <= bucket) radix[b++] = i;
+    }
+    while (b <= num_buckets) radix[b++] = n;
+
+    table->radix = radix;
+    table->radix_shift = shift;
+    table->radix_max = max_end;
+    return 0;
+}
+
+// Interpolated slot of end_index within its non-empty bucket [lo, hi)
+static inline uint64_t radix_guess(const rt_table *table, uint64_t end_index,
+                                   uint64_t lo, uint64_t hi) {
+    uint32_t shift = table->radix_shift;
+    uint64_t offset = end_index - ((end_index >> shift) << shift);
+    uint64_t i = lo + (uint64_t)((double)offset * (double)(hi - lo) / (double)(1ULL << shift));
+    return i < hi ? i : hi - 1;
+}
+
+// Directory bucket, then one interpolation probe using the bucket's key
+// range (ends are close to uniform, so the probe lands within a few slots
+// of the match) and a short scan from there
+static uint64_t radix_search(rt_table *table, uint64_t end_index, int *found) {
+    if (end_index > table->radix_max) return 0;
+
+    const uint64_t *ends = table->ends;
+    uint32_t stride = table->stride;
+    uint64_t bucket = end_index >> table->radix_shift;
+    uint64_t lo = table->radix[bucket];
+    uint64_t hi = table->radix[bucket + 1];
+    if (lo == hi) return 0;
+
+    uint64_t i = radix_guess(table, end_index, lo, hi);
+
+    // First chain with end >= end_index: a few linear steps around the
+    // probe, binary search over the rest of the bucket if the ends there
+    // are far from uniform
+    uint64_t first = lo, last = hi;
+    if (ends[i * stride] < end_index) {
+        first = i + 1;
+        for (uint64_t stop = i + RADIX_SCAN < hi ? i + RADIX_SCAN : hi;
+             first < stop && ends[first * stride] < end_index; first++);
+        if (first < hi && ends[first * stride] < end_index) last = hi;
+        else last = first;
+    } else {
+        last = i;
+        for (uint64_t stop = i > lo + RADIX_SCAN ? i - RADIX_SCAN : lo;
+             last > stop && ends[(last - 1) * stride] >= end_index; last--);
+        first = last > lo && ends[(last - 1) * stride] >= end_index ? lo : last;
+    }
+    while (first < last) {
+        uint64_t mid = first + (last - first) / 2;
+        if (ends[mid * stride] < end_index) first = mid + 1;
+        else last = mid;
+    }
+
+    i = first;
+    if (i == hi || ends[i * stride] != end_index) return 0;
+    return match_start(table, i, found);
+}
 
 uint64_t table_search(rt_table *table, uint64_t end_index, int *found) {
     *found = 0;
     if (table->num_chains == 0) return 0;
+    if (table->paged) return paged_search(table, end_index, found);
+    if (table->format == TABLE_FORMAT_EF) return ef_search(table, end_index, found);
+    if (table->format == TABLE_FORMAT_RTC) {
+        uint64_t chain;
+        if (!rtc_find(&table->rtc, end_index, &chain)) return 0;
+        return match_start(table, chain, found);
+    }
+    if (table->stree.header) {
+        uint64_t i = stree_lower_bound(&table->stree, table->ends, table->stride, end_index);
+        if (i == table->num_chains || table->ends[i * table->stride] != end_index) return 0;
+        return match_start(table, i, found);
+    }
+    if (table->radix) return radix_search(table, end_index, found);
 
+    const uint64_t *ends = table->ends;
+    uint32_t stride = table->stride;
     uint64_t left = 0;
     uint64_t right = table->num_chains - 1;
 
     while (left <= right) {
         uint64_t mid = left + (right - left) / 2;
-        uint64_t mid_end = table->data[mid * 2 + 1];
+        uint64_t mid_end = ends[mid * stride];
         
-        if (mid_end == end_index) {
-            *found = 1;
-            return table->data[mid * 2];  // return start
-        }
+        if (mid_end == end_index) return match_start(table, mid, found);
         
         if (mid_end < end_index) {
             left = mid + 1;
@@ -64,4 +786,577 @@ uint64_t table_search(rt_table *table, uint64_t end_index, int *found) {
         }
     }
     return 0;
+}
+
+// ============ Batched Search ============
+
+// Appends a match for query pos if the chain at idx has its end and its
+// start can be read
+static inline void batch_emit(rt_table *table, uint64_t idx, uint64_t end_index, uint32_t pos,
+                              uint64_t *start_indices, uint32_t *positions,
+                              uint32_t *num_candidates, uint32_t max_candidates) {
+    if (idx >= table->num_chains || table->ends[idx * table->stride] != end_index) return;
+    if (*num_candidates >= max_candidates) return;
+    if (table_start(table, idx, &start_indices[*num_candidates]) != 0) return;
+    positions[*num_candidates] = pos;
+    (*num_candidates)++;
+}
+
+// Every search in a group takes the same log2(n) branchless steps over the
+// same shrinking length, so the group advances in lockstep: one pass
+// issues a prefetch of each search's next midpoint, the next pass consumes
+// them, and the group's misses overlap instead of serializing.
+static void batch_binary(rt_table *table, const uint64_t *end_indices, uint32_t first,
+                         uint32_t count, uint64_t *start_indices, uint32_t *positions,
+                         uint32_t *num_candidates, uint32_t max_candidates) {
+    const uint64_t *ends = table->ends;
+    uint32_t stride = table->stride;
+    uint64_t base[SEARCH_BATCH_GROUP];
+    const uint64_t *keys = end_indices + first;
+
+    for (uint32_t j = 0; j < count; j++) base[j] = 0;
+
+    uint64_t len = table->num_chains;
+    while (len > 1) {
+        uint64_t half = len / 2;
+        for (uint32_t j = 0; j < count; j++) {
+            base[j] += ends[(base[j] + half) * stride] < keys[j] ? half : 0;
+        }
+        len -= half;
+        for (uint32_t j = 0; j < count; j++) {
+            __builtin_prefetch(&ends[(base[j] + len / 2) * stride]);
+        }
+    }
+
+    for (uint32_t j = 0; j < count; j++) {
+        uint64_t idx = base[j] + (ends[base[j] * stride] < keys[j]);
+        batch_emit(table, idx, keys[j], first + j, start_indices, positions,
+                   num_candidates, max_candidates);
+    }
+}
+
+// Radix directory in three passes over the group: prefetch each bucket's
+// directory entry, then each interpolation probe, then finish every search
+// (the probe and its neighbours are in cache by then).
+static void batch_radix(rt_table *table, const uint64_t *end_indices, uint32_t first,
+                        uint32_t count, uint64_t *start_indices, uint32_t *positions,
+                        uint32_t *num_candidates, uint32_t max_candidates) {
+    const uint64_t *keys = end_indices + first;
+    uint32_t shift = table->radix_shift;
+
+    for (uint32_t j = 0; j < count; j++) {
+        if (keys[j] <= table->radix_max) __builtin_prefetch(&table->radix[keys[j] >> shift]);
+    }
+    for (uint32_t j = 0; j < count; j++) {
+        if (keys[j] > table->radix_max) continue;
+        uint64_t bucket = keys[j] >> shift;
+        uint64_t lo = table->radix[bucket], hi = table->radix[bucket + 1];
+        if (lo < hi) {
+            __builtin_prefetch(&table->ends[radix_guess(table, keys[j], lo, hi) * table->stride]);
+        }
+    }
+    for (uint32_t j = 0; j < count && *num_candidates < max_candidates; j++) {
+        int found = 0;
+        uint64_t start = radix_search(table, keys[j], &found);
+        if (found) {
+            start_indices[*num_candidates] = start;
+            positions[*num_candidates] = first + j;
+            (*num_candidates)++;
+        }
+    }
+}
+
+// Search tree lower bounds for the group, all descending in lockstep
+static void batch_stree(rt_table *table, const uint64_t *end_indices, uint32_t first,
+                        uint32_t count, uint64_t *start_indices, uint32_t *positions,
+                        uint32_t *num_candidates, uint32_t max_candidates) {
+    uint64_t chains[SEARCH_BATCH_GROUP];
+    stree_lower_bound_batch(&table->stree, table->ends, table->stride, end_indices + first,
+                            count, chains);
+    for (uint32_t j = 0; j < count; j++) {
+        batch_emit(table, chains[j], end_indices[first + j], first + j, start_indices,
+                   positions, num_candidates, max_candidates);
+    }
+}
+
+int table_search_batch(rt_table *table, const uint64_t *end_indices, uint32_t num_indices,
+                       uint64_t *start_indices, uint32_t *positions,
+                       uint32_t *num_candidates, uint32_t max_candidates) {
+    uint32_t before = *num_candidates;
+    if (table->num_chains == 0) return 0;
+
+    // Paged, EF and RTC tables have no resident end column to prefetch
+    if (!table->ends) {
+        for (uint32_t pos = 0; pos < num_indices && *num_candidates < max_candidates; pos++) {
+            int found;
+            uint64_t start = table_search(table, end_indices[pos], &found);
+            if (found) {
+                start_indices[*num_candidates] = start;
+                positions[*num_candidates] = pos;
+                (*num_candidates)++;
+            }
+        }
+        return *num_candidates - before;
+    }
+
+    for (uint32_t first = 0; first < num_indices && *num_candidates < max_candidates;
+         first += SEARCH_BATCH_GROUP) {
+        uint32_t count = num_indices - first < SEARCH_BATCH_GROUP ?
+                         num_indices - first : SEARCH_BATCH_GROUP;
+        if (table->stree.header) {
+            batch_stree(table, end_indices, first, count, start_indices, positions,
+                        num_candidates, max_candidates);
+        } else if (table->radix) {
+            batch_radix(table, end_indices, first, count, start_indices, positions,
+                        num_candidates, max_candidates);
+        } else {
+            batch_binary(table, end_indices, first, count, start_indices, positions,
+                         num_candidates, max_candidates);
+        }
+    }
+    return *num_candidates - before;
+}
+
+// ============ Streaming Join ============
+
+rt_query *queries_build(const uint64_t *end_indices, uint32_t num_indices) {
+    rt_query *queries = malloc((size_t)num_indices * sizeof(rt_query));
+    rt_query *tmp = malloc((size_t)num_indices * sizeof(rt_query));
+    uint32_t (*counts)[256] = calloc(8, sizeof(*counts));
+    if (!queries || !tmp || !counts) {
+        free(queries);
+        free(tmp);
+        free(counts);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < num_indices; i++) {
+        queries[i].end = end_indices[i];
+        queries[i].pos = i;
+        for (int d = 0; d < 8; d++) counts[d][(end_indices[i] >> (d * 8)) & 0xff]++;
+    }
+
+    // LSD radix sort by end, one byte per pass. Each pass is stable and
+    // positions start in order, so ties stay sorted by position. Bytes
+    // that are the same in every end (the top byte of a 56-bit keyspace)
+    // are skipped.
+    for (int d = 0; d < 8; d++) {
+        uint32_t *c = counts[d];
+        if (num_indices == 0 || c[(end_indices[0] >> (d * 8)) & 0xff] == num_indices) continue;
+
+        uint32_t sum = 0;
+        for (int b = 0; b < 256; b++) {
+            uint32_t v = c[b];
+            c[b] = sum;
+            sum += v;
+        }
+        for (uint32_t i = 0; i < num_indices; i++) {
+            tmp[c[(queries[i].end >> (d * 8)) & 0xff]++] = queries[i];
+        }
+        rt_query *swap = queries;
+        queries = tmp;
+        tmp = swap;
+    }
+
+    free(tmp);
+    free(counts);
+    return queries;
+}
+
+// First chain in [lo, n) with end >= key. Checks the next 8 ends with a
+// branchless count (one cache line of a split end column, which GCC turns
+// into SIMD compares where the target has them). Past that it starts from
+// hint, the interpolated position of key (0 for none), and gallops with
+// doubling steps forward or back towards lo before a binary search of the
+// last step, so a gap of g chains costs O(log g) probes instead of g and
+// a good hint costs one or two.
+#define GALLOP_BLOCK 8
+#define JOIN_PREFETCH_AHEAD 16
+static inline uint64_t gallop_lower_bound(const uint64_t *ends, uint32_t stride,
+                                          uint64_t lo, uint64_t n, uint64_t key,
+                                          uint64_t hint) {
+    if (lo + GALLOP_BLOCK <= n && ends[(lo + GALLOP_BLOCK - 1) * stride] >= key) {
+        uint64_t count = 0;
+        for (uint32_t k = 0; k < GALLOP_BLOCK; k++) count += ends[(lo + k) * stride] < key;
+        return lo + count;
+    }
+
+    uint64_t hi;
+    if (hint > lo && hint < n && ends[hint * stride] >= key) {
+        // Answer in [lo, hint]: gallop back while ends stay >= key
+        uint64_t step = GALLOP_BLOCK;
+        hi = hint;
+        while (hi - lo > step && ends[(hi - step) * stride] >= key) {
+            hi -= step;
+            step *= 2;
+        }
+        if (hi - lo > step) lo = hi - step + 1;
+    } else {
+        if (hint > lo && hint < n) lo = hint + 1;
+        uint64_t step = GALLOP_BLOCK;
+        hi = lo + step;
+        while (hi < n && ends[hi * stride] < key) {
+            lo = hi + 1;
+            step *= 2;
+            hi = lo + step;
+        }
+        if (hi > n) hi = n;
+    }
+
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (ends[mid * stride] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Emits every query equal to end; leaves *q on the first such query in
+// case the next chain has the same end.
+static int join_emit(rt_table *table, uint64_t chain, uint64_t end,
+                     const rt_query *queries, uint32_t num_queries, uint32_t *q,
+                     uint64_t *start_indices, uint32_t *positions,
+                     uint32_t *num_candidates, uint32_t max_candidates) {
+    while (*q < num_queries && queries[*q].end < end) (*q)++;
+
+    // A start that cannot be read drops the chain's candidates
+    uint64_t start;
+    if (*q < num_queries && queries[*q].end == end && table_start(table, chain, &start) != 0) {
+        return 0;
+    }
+
+    int found = 0;
+    for (uint32_t j = *q; j < num_queries && queries[j].end == end; j++) {
+        if (*num_candidates >= max_candidates) break;
+        start_indices[*num_candidates] = start;
+        positions[*num_candidates] = queries[j].pos;
+        (*num_candidates)++;
+        found++;
+    }
+    return found;
+}
+
+int table_join_search(rt_table *table, const rt_query *queries, uint32_t num_queries,
+                      uint64_t *start_indices, uint32_t *positions,
+                      uint32_t *num_candidates, uint32_t max_candidates) {
+    int found = 0;
+    uint32_t q = 0;
+
+    if (table->num_chains == 0) return 0;
+
+    if (table->paged) {
+        // One lower bound per distinct end (a page read unless the last
+        // one already holds it), then the run of chains sharing it
+        while (q < num_queries && queries[q].end < table->meta->first_end) q++;
+        while (q < num_queries && queries[q].end <= table->meta->last_end &&
+               *num_candidates < max_candidates) {
+            uint64_t key = queries[q].end, chain, end;
+            if (paged_lower_bound(table, key, &chain) != 0) break;
+            for (; chain < table->num_chains; chain++) {
+                if (paged_end(table, chain, &end) != 0 || end != key) break;
+                found += join_emit(table, chain, key, queries, num_queries, &q,
+                                   start_indices, positions, num_candidates, max_candidates);
+            }
+            while (q < num_queries && queries[q].end == key) q++;
+        }
+        return found;
+    }
+
+    if (table->format == TABLE_FORMAT_RTC) {
+        const rtc_view *v = &table->rtc;
+        for (uint64_t p = 0; p < v->num_prefixes && q < num_queries &&
+                             *num_candidates < max_candidates; p++) {
+            // Skip prefixes whose whole end range lies below the next query
+            if (p + 1 < v->num_prefixes &&
+                ((p + 1) << v->header->end_point_bits) <= queries[q].end) continue;
+
+            for (uint64_t i = v->index[p]; i < v->index[p + 1] && q < num_queries; i++) {
+                uint64_t start, end;
+                rtc_chain(v, i, p, &start, &end);
+                found += join_emit(table, i, end, queries, num_queries, &q,
+                                   start_indices, positions, num_candidates, max_candidates);
+            }
+        }
+        return found;
+    }
+
+    if (table->format != TABLE_FORMAT_EF) {
+        const uint64_t *ends = table->ends;
+        uint32_t stride = table->stride;
+        uint64_t n = table->num_chains;
+        uint64_t i = 0;
+        // Ends are close to uniform, so a query's chain is about
+        // (end - current end) * density chains ahead; the gallop starts
+        // there, and the spot for a query a few ahead is prefetched so the
+        // sweep's misses overlap
+        double density = (double)n / ((double)ends[(n - 1) * stride] + 1.0);
+        while (q < num_queries && *num_candidates < max_candidates) {
+            uint64_t key = queries[q].end;
+            uint64_t cur = i < n ? ends[i * stride] : 0;
+            if (q + JOIN_PREFETCH_AHEAD < num_queries) {
+                uint64_t ahead = i + (uint64_t)((queries[q + JOIN_PREFETCH_AHEAD].end - cur) * density);
+                if (ahead < n) __builtin_prefetch(&ends[ahead * stride]);
+            }
+            uint64_t hint = key > cur ? i + (uint64_t)((key - cur) * density) : 0;
+            i = gallop_lower_bound(ends, stride, i, n, key, hint);
+            if (i == n) break;
+            if (ends[i * stride] != key) {
+                uint64_t next = ends[i * stride];
+                while (q < num_queries && queries[q].end < next) q++;
+                continue;
+            }
+            for (; i < n && ends[i * stride] == key; i++) {
+                found += join_emit(table, i, key, queries, num_queries, &q,
+                                   start_indices, positions, num_candidates, max_candidates);
+            }
+            while (q < num_queries && queries[q].end == key) q++;
+        }
+        return found;
+    }
+
+    const ef_block *blocks = table->ef_blocks;
+    uint64_t num_blocks = table->ef->num_blocks;
+    uint64_t decoded[EF_BLOCK_SIZE];
+
+    for (uint64_t b = 0; b < num_blocks && q < num_queries && *num_candidates < max_candidates; b++) {
+        // Skip blocks that end below the next query without touching their data
+        if (b + 1 < num_blocks && blocks[b + 1].first_end < queries[q].end) continue;
+        if (blocks[b].count > EF_BLOCK_SIZE) break;
+
+        ef_decode_block(&blocks[b], (const uint64_t *)(table->ef_data + blocks[b].offset), decoded);
+        uint64_t base = b * table->ef->block_size;
+        for (uint32_t i = 0; i < blocks[b].count && q < num_queries; i++) {
+            found += join_emit(table, base + i, decoded[i], queries, num_queries, &q,
+                               start_indices, positions, num_candidates, max_candidates);
+        }
+    }
+    return found;
+}
+
+// Joins one chunk of n entries starting at chain chunk_base. Split tables
+// read each matching start from the start column; a chain whose start
+// cannot be read is dropped, as in join_emit.
+static int stream_join_chunk(const uint64_t *chunk, size_t n, int split, uint64_t chunk_base,
+                             int starts_fd, const rt_query *queries, uint32_t num_queries,
+                             uint32_t *q, uint64_t *start_indices, uint32_t *positions,
+                             uint32_t *num_candidates, uint32_t max_candidates) {
+    uint32_t stride = split ? 1 : 2;
+    const uint64_t *ends = split ? chunk : chunk + 1;
+    int found = 0;
+
+    // Skip chunks that end below the next query
+    if (n == 0 || ends[(n - 1) * stride] < queries[*q].end) return 0;
+
+    size_t i = 0;
+    uint64_t first_end = ends[0];
+    double density = (double)n / ((double)(ends[(n - 1) * stride] - first_end) + 1.0);
+    while (*q < num_queries && *num_candidates < max_candidates) {
+        uint64_t key = queries[*q].end;
+        uint64_t hint = key > first_end ? (uint64_t)((key - first_end) * density) : 0;
+        i = gallop_lower_bound(ends, stride, i, n, key, hint);
+        if (i == n) break;
+        if (ends[i * stride] != key) {
+            uint64_t next = ends[i * stride];
+            while (*q < num_queries && queries[*q].end < next) (*q)++;
+            continue;
+        }
+
+        // Every query with this end matches every chain with it; leave q
+        // on the first of them in case the next chunk starts with the same end
+        for (; i < n && ends[i * stride] == key; i++) {
+            uint64_t start = split ? 0 : chunk[i * 2];
+            if (split && read_u64_at(starts_fd, (chunk_base + i) * 8, &start) != 0) continue;
+            for (uint32_t j = *q; j < num_queries && queries[j].end == key; j++) {
+                if (*num_candidates >= max_candidates) break;
+                start_indices[*num_candidates] = start;
+                positions[*num_candidates] = queries[j].pos;
+                (*num_candidates)++;
+                found++;
+            }
+        }
+        if (i == n) break;
+        while (*q < num_queries && queries[*q].end == key) (*q)++;
+    }
+    return found;
+}
+
+#ifdef __linux__
+// Keeps queue_depth block reads in flight into registered buffers; block
+// b lives in slot b % depth and is joined once it and every block before
+// it have completed, then the slot is reused for block b + depth.
+static int stream_direct(const char *filename, int split, int starts_fd,
+                         const rt_query *queries, uint32_t num_queries,
+                         uint64_t *start_indices, uint32_t *positions,
+                         uint32_t *num_candidates, uint32_t max_candidates) {
+    int fd = open_direct(filename);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    uring ring;
+    if (fstat(fd, &st) != 0 || uring_init(&ring, io_queue_depth) != 0) {
+        close(fd);
+        return -2;
+    }
+
+    size_t entry_size = split ? 8 : 16;
+    size_t block = io_block_size;      // 4 KB multiple, so whole entries
+    uint64_t size = st.st_size;
+    uint64_t num_blocks = (size + block - 1) / block;
+    unsigned depth = io_queue_depth;
+    if (depth > num_blocks) depth = num_blocks ? num_blocks : 1;
+
+    uint8_t *buf = NULL;
+    int *result = malloc(depth * sizeof(int));
+    struct iovec *iov = malloc(depth * sizeof(struct iovec));
+    if (!result || !iov || posix_memalign((void **)&buf, IO_ALIGN, (size_t)depth * block) != 0) {
+        free(result);
+        free(iov);
+        uring_exit(&ring);
+        close(fd);
+        return -1;
+    }
+
+    for (unsigned s = 0; s < depth; s++) {
+        iov[s].iov_base = buf + (size_t)s * block;
+        iov[s].iov_len = block;
+        result[s] = INT32_MIN;
+    }
+    // Registered buffers skip the per-read page pinning; plain reads if
+    // the memlock limit is too small
+    int fixed = uring_register_buffers(&ring, iov, depth) == 0;
+
+    uint64_t submitted = 0, inflight = 0;
+    for (; submitted < depth && submitted < num_blocks; submitted++, inflight++) {
+        unsigned s = submitted % depth;
+        uring_prep_read(&ring, fd, iov[s].iov_base, block, submitted * block,
+                        fixed ? (int)s : -1, submitted);
+    }
+
+    int found = 0, err = 0;
+    uint32_t q = 0;
+    for (uint64_t b = 0; b < num_blocks && !err && q < num_queries &&
+                         *num_candidates < max_candidates; b++) {
+        unsigned s = b % depth;
+        while (result[s] == INT32_MIN) {
+            if (uring_submit(&ring, 1) != 0) {
+                err = 1;
+                break;
+            }
+            uint64_t done;
+            int res;
+            while (uring_reap(&ring, &done, &res)) {
+                result[done % depth] = res;
+                inflight--;
+            }
+        }
+        if (err) break;
+
+        uint64_t expect = b + 1 < num_blocks ? block : size - b * block;
+        if (result[s] < 0 || (uint64_t)result[s] != expect) {
+            err = 1;
+            break;
+        }
+        found += stream_join_chunk(iov[s].iov_base, expect / entry_size, split,
+                                   b * block / entry_size, starts_fd, queries, num_queries, &q,
+                                   start_indices, positions, num_candidates, max_candidates);
+
+        result[s] = INT32_MIN;
+        if (submitted < num_blocks) {
+            uring_prep_read(&ring, fd, iov[s].iov_base, block, submitted * block,
+                            fixed ? (int)s : -1, submitted);
+            submitted++;
+            inflight++;
+        }
+    }
+
+    // Stopped early or failed: wait out reads still targeting the buffers
+    while (inflight > 0 && uring_submit(&ring, 1) == 0) {
+        uint64_t done;
+        int res;
+        while (uring_reap(&ring, &done, &res)) inflight--;
+    }
+
+    uring_exit(&ring);
+    close(fd);
+    free(buf);
+    free(iov);
+    free(result);
+    return err ? -1 : found;
+}
+#endif
+
+int table_stream_search(const char *filename, const rt_query *queries, uint32_t num_queries,
+                        size_t chunk_size, uint64_t *start_indices, uint32_t *positions,
+                        uint32_t *num_candidates, uint32_t max_candidates) {
+    table_format format = table_format_of(filename);
+
+    // Compressed tables are small enough to load whole; the join reads them
+    // front to back and never touches blocks that hold no query. The mmap
+    // backend and tables in the resident cache are joined the same way.
+    if (format == TABLE_FORMAT_EF || format == TABLE_FORMAT_RTC || io_backend == TABLE_IO_MMAP ||
+        (cache_open && table_cache_has(&cache, filename))) {
+        rt_table table = {0};
+        if (table_load(&table, filename) != 0) return -1;
+#ifndef _WIN32
+        if (table.mapped) madvise(table.data, table.size, MADV_SEQUENTIAL);
+#endif
+        int found = table_join_search(&table, queries, num_queries, start_indices, positions,
+                                      num_candidates, max_candidates);
+        table_free(&table);
+        return found;
+    }
+
+    int split = format == TABLE_FORMAT_SPLIT;
+    size_t entry_size = split ? 8 : 16;
+
+    int starts_fd = -1;
+    if (split && (starts_fd = open_starts(filename)) < 0) return -1;
+
+#ifdef __linux__
+    if (io_backend == TABLE_IO_URING) {
+        int found = stream_direct(filename, split, starts_fd, queries, num_queries,
+                                  start_indices, positions, num_candidates, max_candidates);
+        // -2: no io_uring on this kernel, fall through to buffered reads
+        if (found != -2) {
+            if (split) close(starts_fd);
+            return found;
+        }
+    }
+#endif
+
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+        if (split) close(starts_fd);
+        return -1;
+    }
+    setvbuf(f, NULL, _IONBF, 0);
+#ifndef _WIN32
+    posix_fadvise(fileno(f), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    size_t chunk_chains = chunk_size / entry_size;
+    if (chunk_chains == 0) chunk_chains = 1;
+    uint64_t *chunk = malloc(chunk_chains * entry_size);
+    if (!chunk) {
+        if (split) close(starts_fd);
+        fclose(f);
+        return -1;
+    }
+
+    int found = 0;
+    int err = 0;
+    uint32_t q = 0;
+    uint64_t chunk_base = 0;
+    size_t n;
+    for (; !err && q < num_queries && *num_candidates < max_candidates &&
+           (n = fread(chunk, entry_size, chunk_chains, f)) > 0; chunk_base += n) {
+        found += stream_join_chunk(chunk, n, split, chunk_base, starts_fd, queries, num_queries,
+                                   &q, start_indices, positions, num_candidates, max_candidates);
+    }
+
+    if (ferror(f)) err = 1;
+    free(chunk);
+    if (split) close(starts_fd);
+    fclose(f);
+    return err ? -1 : found;
 }
\ No newline at end of file
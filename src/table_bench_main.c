@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+#include "table.h"
+
+// Compares the in-memory search strategies on one table with a synthetic
+// query set shaped like a real lookup: CHAIN_LEN - 1 end indices, mostly
+// misses spread over the table's end range plus a share of hits.
+
+#define DEFAULT_HIT_PERCENT 10
+// The join emits every chain sharing a matching end, so give it headroom
+#define JOIN_CAPACITY_FACTOR 4
+#define NUM_METHODS 7
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t rng_next(void) {
+    uint64_t z = (rng_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t table_end(rt_table *table, uint64_t chain) {
+    return table->ends[chain * table->stride];
+}
+
+typedef struct {
+    uint64_t *starts;
+    uint8_t *found;
+    uint32_t hits;
+    int truncated;
+    double seconds;
+} bench_result;
+
+static void run_search(rt_table *table, const uint64_t *queries, uint32_t num_queries,
+                       bench_result *r) {
+    double t0 = get_time_sec();
+    r->hits = 0;
+    for (uint32_t i = 0; i < num_queries; i++) {
+        int found;
+        r->starts[i] = table_search(table, queries[i], &found);
+        r->found[i] = found;
+        r->hits += found;
+    }
+    r->seconds = get_time_sec() - t0;
+}
+
+// Batched search appends (start, position) pairs; spread them back out
+static void run_batch(rt_table *table, const uint64_t *queries, uint32_t num_queries,
+                      bench_result *r, uint64_t *starts, uint32_t *positions) {
+    uint32_t count = 0;
+    double t0 = get_time_sec();
+    table_search_batch(table, queries, num_queries, starts, positions, &count, num_queries);
+    r->seconds = get_time_sec() - t0;
+
+    memset(r->found, 0, num_queries);
+    for (uint32_t i = 0; i < count; i++) {
+        r->starts[positions[i]] = starts[i];
+        r->found[positions[i]] = 1;
+    }
+    r->hits = count;
+}
+
+// Merge join over queries sorted once up front (as per ciphertext in
+// gpu_lookup); duplicate ends can emit more than one chain per query
+static void run_join(rt_table *table, const rt_query *sorted, uint32_t num_queries,
+                     bench_result *r, uint64_t *starts, uint32_t *positions) {
+    uint32_t count = 0;
+    double t0 = get_time_sec();
+    uint32_t capacity = num_queries * JOIN_CAPACITY_FACTOR;
+    table_join_search(table, sorted, num_queries, starts, positions, &count, capacity);
+    r->seconds = get_time_sec() - t0;
+    r->truncated = count == capacity;
+
+    memset(r->found, 0, num_queries);
+    r->hits = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        r->hits += !r->found[positions[i]];
+        r->starts[positions[i]] = starts[i];
+        r->found[positions[i]] = 1;
+    }
+}
+
+static void report(const char *name, const bench_result *r, uint32_t num_queries,
+                   const bench_result *base) {
+    printf("  %-22s %9.3f ms  %7.1f ns/query  %u hits", name, r->seconds * 1000,
+           r->seconds * 1e9 / num_queries, r->hits);
+    if (base) printf("  %5.2fx", base->seconds / r->seconds);
+    printf("\n");
+}
+
+// Results must agree on every query; with duplicate ends either chain is
+// a valid answer, so only the found flag is compared for those
+static int compare(rt_table *table, const uint64_t *queries, uint32_t num_queries,
+                   const bench_result *a, const bench_result *b) {
+    if (b->truncated) {
+        printf("  (candidate buffer filled by duplicate ends, join not compared)\n");
+        return 0;
+    }
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < num_queries; i++) {
+        if (a->found[i] != b->found[i]) bad++;
+        else if (a->found[i] && a->starts[i] != b->starts[i]) {
+            int dup = 0;
+            for (uint64_t c = 0; c < table->num_chains && !dup; c++) {
+                uint64_t start;
+                dup = table_end(table, c) == queries[i] && table_start(table, c, &start) == 0 &&
+                      start == b->starts[i];
+            }
+            if (!dup) bad++;
+        }
+    }
+    if (bad) printf("  MISMATCH: %u queries differ from binary search\n", bad);
+    return bad ? -1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <table.rt | table.rte> [hit_percent]\n", argv[0]);
+        return 1;
+    }
+    int hit_percent = argc > 2 ? atoi(argv[2]) : DEFAULT_HIT_PERCENT;
+
+    rt_table table = {0};
+    if (table_load(&table, argv[1]) != 0) {
+        fprintf(stderr, "Cannot load %s\n", argv[1]);
+        return 1;
+    }
+    if (!table.ends || table.num_chains == 0) {
+        fprintf(stderr, "%s: only .rt and .rte tables have a searchable end column\n", argv[1]);
+        table_free(&table);
+        return 1;
+    }
+    table_populate(&table);
+
+    uint32_t num_queries = CHAIN_LEN - 1;
+    uint64_t max_end = table_end(&table, table.num_chains - 1);
+    uint64_t *queries = malloc(num_queries * sizeof(uint64_t));
+    size_t capacity = (size_t)num_queries * JOIN_CAPACITY_FACTOR;
+    uint64_t *join_starts = malloc(capacity * sizeof(uint64_t));
+    uint32_t *join_positions = malloc(capacity * sizeof(uint32_t));
+    bench_result results[NUM_METHODS] = {{0}};
+    int ok = queries && join_starts && join_positions;
+    for (int i = 0; i < NUM_METHODS && ok; i++) {
+        results[i].starts = malloc(num_queries * sizeof(uint64_t));
+        results[i].found = malloc(num_queries);
+        ok = results[i].starts && results[i].found;
+    }
+    if (!ok) {
+        fprintf(stderr, "malloc failed\n");
+        return 1;
+    }
+    bench_result *binary = &results[0], *binary_batch = &results[1];
+    bench_result *join = &results[2];
+    bench_result *radix = &results[3], *radix_batch = &results[4];
+    bench_result *stree = &results[5], *stree_batch = &results[6];
+
+    // A search tree sidecar takes precedence in table_search; set it aside
+    // until its own rows
+    stree_view tree = table.stree;
+    memset(&table.stree, 0, sizeof(stree_view));
+
+    for (uint32_t i = 0; i < num_queries; i++) {
+        if ((int)(rng_next() % 100) < hit_percent) {
+            queries[i] = table_end(&table, rng_next() % table.num_chains);
+        } else {
+            queries[i] = rng_next() % (max_end + 1);
+        }
+    }
+
+    printf("%s: %llu chains, %u queries (%d%% drawn from the table)\n\n", argv[1],
+           (unsigned long long)table.num_chains, num_queries, hit_percent);
+
+    double t0 = get_time_sec();
+    rt_query *sorted = queries_build(queries, num_queries);
+    double sort = get_time_sec() - t0;
+    if (!sorted) {
+        fprintf(stderr, "malloc failed\n");
+        return 1;
+    }
+
+    run_search(&table, queries, num_queries, binary);
+    report("binary search", binary, num_queries, NULL);
+    run_batch(&table, queries, num_queries, binary_batch, join_starts, join_positions);
+    report("batched binary", binary_batch, num_queries, binary);
+    run_join(&table, sorted, num_queries, join, join_starts, join_positions);
+    report("galloping merge join", join, num_queries, binary);
+    printf("  %-22s %9.3f ms  (once per ciphertext)\n", "query sort", sort * 1000);
+
+    t0 = get_time_sec();
+    table_build_index(&table);
+    double build = get_time_sec() - t0;
+    run_search(&table, queries, num_queries, radix);
+    report("radix + interpolation", radix, num_queries, binary);
+    run_batch(&table, queries, num_queries, radix_batch, join_starts, join_positions);
+    report("batched radix", radix_batch, num_queries, binary);
+    printf("  %-22s %9.3f ms  (%u-bit directory, groups of %d)\n", "directory build",
+           build * 1000,
+           64 - table.radix_shift - (table.radix_max ? __builtin_clzll(table.radix_max) : 63),
+           SEARCH_BATCH_GROUP);
+
+    int methods = 5;
+    if (tree.header) {
+        table.stree = tree;
+        run_search(&table, queries, num_queries, stree);
+        report("search tree (.rtst)", stree, num_queries, binary);
+        run_batch(&table, queries, num_queries, stree_batch, join_starts, join_positions);
+        report("batched search tree", stree_batch, num_queries, binary);
+        methods = NUM_METHODS;
+    } else {
+        printf("  (no .rtst search tree; build one with rtconvert stree)\n");
+    }
+
+    int ret = 0;
+    for (int i = 1; i < methods; i++) {
+        ret |= compare(&table, queries, num_queries, binary, &results[i]);
+    }
+
+    free(queries);
+    free(sorted);
+    free(join_starts);
+    free(join_positions);
+    for (int i = 0; i < NUM_METHODS; i++) {
+        free(results[i].starts);
+        free(results[i].found);
+    }
+    table_free(&table);
+    return ret ? 1 : 0;
+}
\ No newline at end of file
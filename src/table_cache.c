@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "table_cache.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+
+#define COPY_CHUNK (8 * 1024 * 1024)
+
+static size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+static void cache_path(table_cache *cache, const char *name, char *path, size_t size) {
+    snprintf(path, size, "%s/%s", cache->dir, name);
+}
+
+// Cached file name: FNV-1a of the canonical source path
+static void entry_name(const char *path, char *name, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const char *p = path; *p; p++) {
+        h ^= (uint8_t)*p;
+        h *= 0x100000001b3ULL;
+    }
+    snprintf(name, size, "%016llx", (unsigned long long)h);
+}
+
+static table_cache_entry *find_entry(table_cache *cache, const char *path) {
+    uint32_t count = __atomic_load_n(&cache->hdr->count, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < count && i < cache->hdr->capacity; i++) {
+        if (strcmp(cache->hdr->entries[i].path, path) == 0) return &cache->hdr->entries[i];
+    }
+    return NULL;
+}
+
+int table_cache_open(table_cache *cache, const char *dir, int create) {
+    memset(cache, 0, sizeof(table_cache));
+    cache->fd = -1;
+    snprintf(cache->dir, sizeof(cache->dir), "%s", dir);
+    if (create && mkdir(dir, 0755) != 0 && errno != EEXIST) return -1;
+
+    char path[1100];
+    cache_path(cache, TABLE_CACHE_REGISTRY, path, sizeof(path));
+    cache->fd = open(path, O_RDWR | (create ? O_CREAT : 0), 0644);
+    if (cache->fd < 0) return -1;
+
+    // hugetlbfs only accepts sizes that are a multiple of its page size
+    struct statfs sfs;
+    size_t page_size = statfs(dir, &sfs) == 0 && sfs.f_bsize > 0 ? (size_t)sfs.f_bsize : 4096;
+    cache->size = round_up(sizeof(table_cache_header) +
+                           TABLE_CACHE_MAX_TABLES * sizeof(table_cache_entry), page_size);
+
+    // Only setting up a new registry needs it exclusively; opening an
+    // existing one just waits out such a setup
+    struct stat st;
+    int lock = fstat(cache->fd, &st) == 0 && st.st_size > 0 ? LOCK_SH : LOCK_EX;
+    flock(cache->fd, lock);
+    int fresh = fstat(cache->fd, &st) == 0 && st.st_size == 0;
+    if (fresh && lock == LOCK_SH) {
+        flock(cache->fd, LOCK_EX);
+        fresh = fstat(cache->fd, &st) == 0 && st.st_size == 0;
+    }
+    if (fresh && (!create || ftruncate(cache->fd, cache->size) != 0)) goto fail;
+    if (!fresh) cache->size = st.st_size;
+
+    cache->hdr = mmap(NULL, cache->size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+    if (cache->hdr == MAP_FAILED) {
+        cache->hdr = NULL;
+        goto fail;
+    }
+
+    if (fresh) {
+        memcpy(cache->hdr->magic, TABLE_CACHE_MAGIC, 4);
+        cache->hdr->capacity = TABLE_CACHE_MAX_TABLES;
+        cache->hdr->page_size = page_size;
+    } else if (memcmp(cache->hdr->magic, TABLE_CACHE_MAGIC, 4) != 0 ||
+               sizeof(table_cache_header) +
+               (uint64_t)cache->hdr->capacity * sizeof(table_cache_entry) > cache->size) {
+        goto fail;
+    }
+    flock(cache->fd, LOCK_UN);
+    return 0;
+
+fail:
+    flock(cache->fd, LOCK_UN);
+    table_cache_close(cache);
+    return -1;
+}
+
+void table_cache_close(table_cache *cache) {
+    if (cache->hdr) munmap(cache->hdr, cache->size);
+    if (cache->fd >= 0) close(cache->fd);
+    cache->hdr = NULL;
+    cache->fd = -1;
+}
+
+// Reads the whole source file into a mapping of the cached file
+static int copy_table(int src, int dst, uint64_t size, size_t map_size) {
+    if (ftruncate(dst, map_size) != 0) return -1;
+
+    uint8_t *p = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, dst, 0);
+    if (p == MAP_FAILED) return -1;
+#ifdef MADV_HUGEPAGE
+    madvise(p, map_size, MADV_HUGEPAGE);
+#endif
+    posix_fadvise(src, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    uint64_t off = 0;
+    while (off < size) {
+        size_t want = size - off < COPY_CHUNK ? size - off : COPY_CHUNK;
+        ssize_t n = pread(src, p + off, want, off);
+        if (n <= 0) break;
+        off += n;
+    }
+    munmap(p, map_size);
+    // The copy is resident now; drop the source pages from the page cache
+    posix_fadvise(src, 0, 0, POSIX_FADV_DONTNEED);
+    return off == size ? 0 : -1;
+}
+
+int table_cache_add(table_cache *cache, const char *path) {
+    char real[1024];
+    struct stat st;
+    if (!realpath(path, real) || stat(real, &st) != 0) return -1;
+
+    flock(cache->fd, LOCK_EX);
+    table_cache_entry *e = find_entry(cache, real);
+    if (e && e->ready && e->size == (uint64_t)st.st_size && e->mtime == st.st_mtime) {
+        flock(cache->fd, LOCK_UN);
+        return 1;
+    }
+    if (!e) {
+        if (cache->hdr->count >= cache->hdr->capacity) {
+            flock(cache->fd, LOCK_UN);
+            return -1;
+        }
+        e = &cache->hdr->entries[cache->hdr->count];
+        memset(e, 0, sizeof(table_cache_entry));
+        snprintf(e->path, sizeof(e->path), "%s", real);
+        entry_name(real, e->name, sizeof(e->name));
+        __atomic_store_n(&cache->hdr->count, cache->hdr->count + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&e->ready, 0, __ATOMIC_RELEASE);
+    flock(cache->fd, LOCK_UN);
+
+    // The copy runs without the registry lock, so lookups keep opening the
+    // cache (and reading this table from disk) meanwhile. It goes into a
+    // temporary file of this process and is renamed over the old copy, so
+    // processes still mapping the old copy keep a valid mapping.
+    char tmp[1100], final[1100], tmp_name[48];
+    snprintf(tmp_name, sizeof(tmp_name), "%s.%d.tmp", e->name, (int)getpid());
+    cache_path(cache, tmp_name, tmp, sizeof(tmp));
+    cache_path(cache, e->name, final, sizeof(final));
+
+    int ret = -1;
+    int src = open(real, O_RDONLY);
+    int dst = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (src >= 0 && dst >= 0 &&
+        copy_table(src, dst, st.st_size, round_up(st.st_size, cache->hdr->page_size)) == 0 &&
+        rename(tmp, final) == 0) {
+        flock(cache->fd, LOCK_EX);
+        e->size = st.st_size;
+        e->mtime = st.st_mtime;
+        e->loaded = time(NULL);
+        __atomic_store_n(&e->ready, 1, __ATOMIC_RELEASE);
+        flock(cache->fd, LOCK_UN);
+        ret = 0;
+    } else if (dst >= 0) {
+        unlink(tmp);
+    }
+    if (src >= 0) close(src);
+    if (dst >= 0) close(dst);
+    return ret;
+}
+
+// Entry for path if its copy is complete and the source is unchanged
+static table_cache_entry *current_entry(table_cache *cache, const char *path) {
+    char real[1024];
+    struct stat st;
+    if (!realpath(path, real) || stat(real, &st) != 0) return NULL;
+
+    table_cache_entry *e = find_entry(cache, real);
+    if (!e || !__atomic_load_n(&e->ready, __ATOMIC_ACQUIRE) ||
+        e->size != (uint64_t)st.st_size || e->mtime != st.st_mtime) {
+        return NULL;
+    }
+    return e;
+}
+
+int table_cache_has(table_cache *cache, const char *path) {
+    return current_entry(cache, path) != NULL;
+}
+
+int table_cache_file(table_cache *cache, const char *path, uint64_t *size, size_t *map_size) {
+    table_cache_entry *e = current_entry(cache, path);
+    if (!e) return -1;
+
+    char cached[1100];
+    cache_path(cache, e->name, cached, sizeof(cached));
+    int fd = open(cached, O_RDONLY);
+    if (fd < 0) return -1;
+
+    __atomic_fetch_add(&e->hits, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->last_hit, (int64_t)time(NULL), __ATOMIC_RELAXED);
+    *size = e->size;
+    *map_size = round_up(e->size, cache->hdr->page_size);
+    return fd;
+}
+
+int table_cache_drop(table_cache *cache) {
+    char path[1100];
+    flock(cache->fd, LOCK_EX);
+    for (uint32_t i = 0; i < cache->hdr->count && i < cache->hdr->capacity; i++) {
+        cache_path(cache, cache->hdr->entries[i].name, path, sizeof(path));
+        unlink(path);
+    }
+    cache->hdr->count = 0;
+    cache_path(cache, TABLE_CACHE_REGISTRY, path, sizeof(path));
+    unlink(path);
+    flock(cache->fd, LOCK_UN);
+    table_cache_close(cache);
+    rmdir(cache->dir);
+    return 0;
+}
+
+double table_cache_residency(table_cache *cache, const table_cache_entry *entry) {
+    char path[1100];
+    cache_path(cache, entry->name, path, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    size_t map_size = round_up(entry->size, cache->hdr->page_size);
+    void *p = map_size ? mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED) return 0;
+
+    size_t pages = (map_size + 4095) / 4096;
+    unsigned char *vec = malloc(pages);
+    size_t resident = 0;
+    if (vec && mincore(p, map_size, vec) == 0) {
+        for (size_t i = 0; i < pages; i++) resident += vec[i] & 1;
+    }
+    free(vec);
+    munmap(p, map_size);
+    return pages ? (double)resident / pages : 0;
+}
+
+#else
+
+int table_cache_open(table_cache *cache, const char *dir, int create) {
+    (void)dir; (void)create;
+    memset(cache, 0, sizeof(table_cache));
+    cache->fd = -1;
+    return -1;
+}
+
+void table_cache_close(table_cache *cache) {
+    (void)cache;
+}
+
+int table_cache_add(table_cache *cache, const char *path) {
+    (void)cache; (void)path;
+    return -1;
+}
+
+int table_cache_file(table_cache *cache, const char *path, uint64_t *size, size_t *map_size) {
+    (void)cache; (void)path; (void)size; (void)map_size;
+    return -1;
+}
+
+int table_cache_has(table_cache *cache, const char *path) {
+    (void)cache; (void)path;
+    return 0;
+}
+
+int table_cache_drop(table_cache *cache) {
+    (void)cache;
+    return -1;
+}
+
+double table_cache_residency(table_cache *cache, const table_cache_entry *entry) {
+    (void)cache; (void)entry;
+    return 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "table.h"
+#include "table_cache.h"
+
+#define DEFAULT_CACHE_DIR "/dev/shm/destroy"
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-d cache_dir] <command> [args]\n", prog);
+    fprintf(stderr, "Commands:\n");
+    fprintf(stderr, "  load [-m max_mb] <table ...>  Copy tables into the cache\n");
+    fprintf(stderr, "  status                         Residency report, hottest tables first\n");
+    fprintf(stderr, "  drop                           Remove every cached table\n");
+    fprintf(stderr, "Cache dir defaults to %s; use a hugetlbfs mount for huge pages.\n",
+            DEFAULT_CACHE_DIR);
+}
+
+static int cmd_load(table_cache *cache, int argc, char **argv) {
+    uint64_t max_bytes = 0;
+    int opt;
+    optind = 1;
+    while ((opt = getopt(argc, argv, "m:")) != -1) {
+        if (opt != 'm') return -1;
+        max_bytes = strtoull(optarg, NULL, 10) * 1024 * 1024;
+    }
+
+    uint64_t cached_bytes = 0;
+    for (uint32_t i = 0; i < cache->hdr->count; i++) {
+        if (cache->hdr->entries[i].ready) cached_bytes += cache->hdr->entries[i].size;
+    }
+
+    int loaded = 0, present = 0, failed = 0;
+    for (int i = optind; i < argc; i++) {
+        // Split and EF tables read their start column on demand too
+        const char *files[2] = {argv[i], NULL};
+        char starts_path[1024];
+        table_format format = table_format_of(argv[i]);
+        if (format == TABLE_FORMAT_SPLIT || format == TABLE_FORMAT_EF) {
+            table_starts_path(argv[i], starts_path, sizeof(starts_path));
+            files[1] = starts_path;
+        }
+
+        for (int f = 0; f < 2 && files[f]; f++) {
+            FILE *fp = fopen(files[f], "rb");
+            if (!fp) {
+                fprintf(stderr, "Cannot open %s\n", files[f]);
+                failed++;
+                continue;
+            }
+            fseeko(fp, 0, SEEK_END);
+            uint64_t size = ftello(fp);
+            fclose(fp);
+
+            int ret = table_cache_has(cache, files[f]) ? 1 : 0;
+            if (ret == 0 && max_bytes && cached_bytes + size > max_bytes) {
+                printf("Budget of %llu MB reached, %s left on disk\n",
+                       (unsigned long long)(max_bytes / (1024 * 1024)), files[f]);
+                continue;
+            }
+            if (ret == 0) ret = table_cache_add(cache, files[f]);
+
+            if (ret < 0) {
+                fprintf(stderr, "Failed to cache %s\n", files[f]);
+                failed++;
+            } else if (ret == 1) {
+                present++;
+            } else {
+                cached_bytes += size;
+                loaded++;
+                printf("[%d/%d] %s (%.1f MB)\n", i - optind + 1, argc - optind, files[f],
+                       size / (1024.0 * 1024.0));
+            }
+        }
+    }
+
+    printf("%d loaded, %d already cached, %d failed; %.1f GB resident in %s\n",
+           loaded, present, failed, cached_bytes / (1024.0 * 1024.0 * 1024.0), cache->dir);
+    return failed ? 1 : 0;
+}
+
+static int hits_cmp(const void *a, const void *b) {
+    const table_cache_entry *x = *(const table_cache_entry * const *)a;
+    const table_cache_entry *y = *(const table_cache_entry * const *)b;
+    if (x->hits != y->hits) return x->hits > y->hits ? -1 : 1;
+    return (x->last_hit < y->last_hit) - (x->last_hit > y->last_hit);
+}
+
+static void format_age(int64_t t, char *buf, size_t size) {
+    if (t == 0) {
+        snprintf(buf, size, "never");
+        return;
+    }
+    int64_t age = time(NULL) - t;
+    if (age < 60) snprintf(buf, size, "%llds ago", (long long)age);
+    else if (age < 3600) snprintf(buf, size, "%lldm ago", (long long)age / 60);
+    else if (age < 86400) snprintf(buf, size, "%lldh ago", (long long)age / 3600);
+    else snprintf(buf, size, "%lldd ago", (long long)age / 86400);
+}
+
+static int cmd_status(table_cache *cache) {
+    uint32_t count = cache->hdr->count;
+    const table_cache_entry **order = malloc((count ? count : 1) * sizeof(*order));
+    if (!order) return 1;
+    for (uint32_t i = 0; i < count; i++) order[i] = &cache->hdr->entries[i];
+    qsort(order, count, sizeof(*order), hits_cmp);
+
+    uint64_t total = 0, resident = 0;
+    printf("%8s  %-10s  %10s  %9s  %s\n", "Hits", "Last used", "Size (MB)", "Resident", "Table");
+    for (uint32_t i = 0; i < count; i++) {
+        const table_cache_entry *e = order[i];
+        char age[32];
+        format_age(e->last_hit, age, sizeof(age));
+        double frac = e->ready ? table_cache_residency(cache, e) : 0;
+        printf("%8llu  %-10s  %10.1f  %8.0f%%  %s%s\n", (unsigned long long)e->hits, age,
+               e->size / (1024.0 * 1024.0), 100.0 * frac, e->path, e->ready ? "" : " (loading)");
+        total += e->size;
+        resident += (uint64_t)(frac * e->size);
+    }
+    printf("\n%u table file(s), %.1f GB cached, %.1f GB resident (page size %llu KB)\n",
+           count, total / (1024.0 * 1024.0 * 1024.0), resident / (1024.0 * 1024.0 * 1024.0),
+           (unsigned long long)(cache->hdr->page_size / 1024));
+    free(order);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = DEFAULT_CACHE_DIR;
+    int argi = 1;
+    if (argi + 1 < argc && strcmp(argv[argi], "-d") == 0) {
+        dir = argv[argi + 1];
+        argi += 2;
+    }
+    if (argi >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const char *cmd = argv[argi];
+    int load = strcmp(cmd, "load") == 0;
+    if (!load && strcmp(cmd, "status") != 0 && strcmp(cmd, "drop") != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    table_cache cache;
+    if (table_cache_open(&cache, dir, load) != 0) {
+        fprintf(stderr, "No table cache in %s\n", dir);
+        return 1;
+    }
+
+    int ret;
+    if (load) {
+        ret = cmd_load(&cache, argc - argi, argv + argi);
+        if (ret < 0) {
+            usage(argv[0]);
+            ret = 1;
+        }
+    } else if (strcmp(cmd, "status") == 0) {
+        ret = cmd_status(&cache);
+    } else {
+        ret = table_cache_drop(&cache);
+        printf("Dropped %s\n", dir);
+        return ret ? 1 : 0;
+    }
+    table_cache_close(&cache);
+    return ret;
+}
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include "table_filter.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define TABLE_FILTER_VERSION 1
+#define PROBE_GROUP 32
+#define CONFIRM_BATCH 256        // regions read per round
+#define CONFIRM_HITS 1024
+#define CONFIRM_QUEUE_DEPTH 64
+
+// ============ Build ============
+
+// Builds one table's fences and filter and appends them at *offset
+static int build_entry(FILE *out, const rt_table *table, const char *path, void *entry,
+                       uint64_t *offset, void *arg) {
+    table_filter_entry *e = entry;
+    uint32_t fp_bits = *(const uint32_t *)arg;
+    int ret = -1;
+    uint8_t *fingerprints = NULL;
+    uint64_t *fences = NULL;
+    const uint64_t *ends = table->ends;
+    uint64_t n = table->num_chains;
+
+    e->num_keys = fuse_count_distinct(ends, table->stride, n);
+    e->num_fences = (n + TABLE_FILTER_FENCE - 1) / TABLE_FILTER_FENCE;
+    if (fuse_init(&e->fuse, e->num_keys, fp_bits) != 0) {
+        fprintf(stderr, "%s: too many chains for one filter\n", path);
+        goto done;
+    }
+
+    fences = malloc(e->num_fences * sizeof(uint64_t));
+    fingerprints = malloc(fuse_bytes(&e->fuse) ? fuse_bytes(&e->fuse) : 1);
+    if (!fences || !fingerprints) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        goto done;
+    }
+    for (uint64_t b = 0; b < e->num_fences; b++) {
+        fences[b] = ends[b * TABLE_FILTER_FENCE * table->stride];
+    }
+    if (fuse_build(&e->fuse, ends, table->stride, n, fingerprints) != 0) {
+        fprintf(stderr, "%s: filter construction failed\n", path);
+        goto done;
+    }
+
+    e->fence_offset = set_file_align(*offset);
+    e->filter_offset = set_file_align(e->fence_offset + e->num_fences * sizeof(uint64_t));
+    if (set_file_write_at(out, e->fence_offset, fences, e->num_fences * sizeof(uint64_t)) != 0 ||
+        set_file_write_at(out, e->filter_offset, fingerprints, fuse_bytes(&e->fuse)) != 0) {
+        fprintf(stderr, "Write failed\n");
+        goto done;
+    }
+    *offset = e->filter_offset + fuse_bytes(&e->fuse);
+    ret = 0;
+
+done:
+    free(fences);
+    free(fingerprints);
+    return ret;
+}
+
+int table_filter_build(const char *out_path, char **table_paths, int num_tables,
+                       uint32_t fp_bits) {
+    uint64_t total_chains;
+    int64_t size = set_file_build(out_path, TABLE_FILTER_MAGIC, TABLE_FILTER_VERSION,
+                                  TABLE_FILTER_FENCE, table_paths, num_tables,
+                                  sizeof(table_filter_entry), build_entry, &fp_bits,
+                                  &total_chains);
+    if (size < 0) return -1;
+
+    printf("%s: %d tables, %llu chains, %.1f MB (%.2f bits/chain, false positive rate 1/%u)\n",
+           out_path, num_tables, (unsigned long long)total_chains, size / (1024.0 * 1024.0),
+           total_chains ? size * 8.0 / total_chains : 0.0, 1U << fp_bits);
+    return 0;
+}
+
+// ============ Lookup ============
+
+int table_filter_open(table_filter_set *fs, const char *path) {
+    memset(fs, 0, sizeof(table_filter_set));
+    if (set_file_open(path, TABLE_FILTER_MAGIC, TABLE_FILTER_VERSION, TABLE_FILTER_FENCE,
+                      sizeof(table_filter_entry), &fs->data, &fs->size) != 0) {
+        return -1;
+    }
+    fs->header = (const set_file_header *)fs->data;
+    fs->entries = (const table_filter_entry *)(fs->header + 1);
+
+    int ok = 1;
+    for (uint32_t i = 0; ok && i < fs->header->num_tables; i++) {
+        const table_filter_entry *e = &fs->entries[i];
+        ok = e->fence_offset + e->num_fences * sizeof(uint64_t) <= fs->size &&
+             e->filter_offset + fuse_bytes(&e->fuse) <= fs->size &&
+             (e->fuse.fp_bits == 8 || e->fuse.fp_bits == 16) &&
+             e->fuse.segment_count_length + 2ULL * e->fuse.segment_length <= e->fuse.array_length;
+    }
+    if (!ok) {
+        table_filter_close(fs);
+        return -1;
+    }
+    return 0;
+}
+
+void table_filter_close(table_filter_set *fs) {
+    set_file_close(fs->data, fs->size);
+    memset(fs, 0, sizeof(table_filter_set));
+}
+
+const table_filter_entry *table_filter_find(const table_filter_set *fs, const char *table_path) {
+    return set_file_find(fs->data, sizeof(table_filter_entry), table_path);
+}
+
+// Chains [first, last) that a filter hit has to read, and where they go
+typedef struct {
+    uint64_t first;
+    uint64_t last;
+    uint8_t *buf;
+} hit_region;
+
+typedef struct {
+    uint32_t query;
+    uint32_t region;
+} filter_hit;
+
+// Chains that can hold key: from the last region starting below key up to
+// the last region starting at or below it (more than one region only when
+// duplicate ends straddle a fence)
+static void hit_range(const table_filter_entry *e, const uint64_t *fences, uint64_t key,
+                      hit_region *r) {
+    uint64_t lo = 0, hi = e->num_fences;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (fences[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    uint64_t first = lo > 0 ? lo - 1 : 0;
+    uint64_t last = lo;
+    while (last < e->num_fences && fences[last] == key) last++;
+    if (last == first) last = first + 1;
+
+    r->first = first * TABLE_FILTER_FENCE;
+    r->last = last * TABLE_FILTER_FENCE;
+    if (r->last > e->table.num_chains) r->last = e->table.num_chains;
+}
+
+typedef struct {
+    int fd;                    // table file (.rt pairs or .rte ends)
+    int starts_fd;             // .rts for split tables, else -1
+    uint32_t record;           // bytes per chain in fd
+    uint32_t end_word;         // index of the end within a record
+    uring ring;
+    int use_ring;
+} confirm_io;
+
+// Reads every region into its buffer (CONFIRM_QUEUE_DEPTH reads in flight
+// through io_uring where available, one pread at a time otherwise)
+static int read_regions(confirm_io *io, const hit_region *regions, uint32_t count) {
+    set_file_read reads[CONFIRM_BATCH];
+    for (uint32_t i = 0; i < count; i++) {
+        reads[i] = (set_file_read){
+            .buf = regions[i].buf,
+            .len = (uint32_t)((regions[i].last - regions[i].first) * io->record),
+            .offset = regions[i].first * io->record,
+        };
+    }
+    return set_file_read_batch(io->use_ring ? &io->ring : NULL, CONFIRM_QUEUE_DEPTH, io->fd,
+                               reads, count);
+}
+
+// Emits every chain in a read region whose end equals the query's
+static int confirm_hit(confirm_io *io, const hit_region *r, const rt_query *query,
+                       uint64_t *start_indices, uint32_t *positions,
+                       uint32_t *num_candidates, uint32_t max_candidates) {
+    const uint64_t *words = (const uint64_t *)r->buf;
+    uint32_t stride = io->record / 8;
+    uint64_t count = r->last - r->first;
+
+    uint64_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (words[mid * stride + io->end_word] < query->end) lo = mid + 1;
+        else hi = mid;
+    }
+
+    int found = 0;
+    for (uint64_t i = lo; i < count && words[i * stride + io->end_word] == query->end; i++) {
+        if (*num_candidates >= max_candidates) break;
+        uint64_t start = words[i * stride];
+        if (io->starts_fd >= 0 &&
+            set_file_read_at(io->starts_fd, &start, 8, (r->first + i) * 8) != 0) {
+            continue;
+        }
+        start_indices[*num_candidates] = start;
+        positions[*num_candidates] = query->pos;
+        (*num_candidates)++;
+        found++;
+    }
+    return found;
+}
+
+int table_filter_search(const table_filter_set *fs, const table_filter_entry *e,
+                        const char *table_path, const rt_query *queries, uint32_t num_queries,
+                        uint64_t *start_indices, uint32_t *positions,
+                        uint32_t *num_candidates, uint32_t max_candidates,
+                        table_filter_stats *stats) {
+    fuse_filter filter = {e->fuse, fs->data + e->filter_offset};
+    const uint64_t *fences = (const uint64_t *)(fs->data + e->fence_offset);
+
+    confirm_io io;
+    memset(&io, 0, sizeof(io));
+    io.starts_fd = -1;
+    io.fd = open(table_path, O_RDONLY | O_BINARY);
+    if (io.fd < 0) return -1;
+    int split = table_format_of(table_path) == TABLE_FORMAT_SPLIT;
+    if (split) {
+        char starts_path[1024];
+        table_starts_path(table_path, starts_path, sizeof(starts_path));
+        io.starts_fd = open(starts_path, O_RDONLY | O_BINARY);
+    }
+    io.record = split ? 8 : 16;
+    io.end_word = split ? 0 : 1;
+    io.use_ring = uring_init(&io.ring, CONFIRM_QUEUE_DEPTH) == 0;
+
+    // Regions are two fences at most, except for a run of one end longer
+    // than that, which gets a buffer of its own
+    size_t region_bytes = (size_t)TABLE_FILTER_FENCE * 2 * io.record;
+    hit_region *regions = malloc(CONFIRM_BATCH * sizeof(hit_region));
+    filter_hit *hits = malloc(CONFIRM_HITS * sizeof(filter_hit));
+    uint8_t *buf_data = malloc(CONFIRM_BATCH * region_bytes);
+    if (!regions || !hits || !buf_data || (split && io.starts_fd < 0)) {
+        free(regions);
+        free(hits);
+        free(buf_data);
+        if (io.use_ring) uring_exit(&io.ring);
+        close(io.fd);
+        if (io.starts_fd >= 0) close(io.starts_fd);
+        return -1;
+    }
+
+    uint32_t q, q_end;
+    set_file_query_range(&e->table, queries, num_queries, &q, &q_end);
+
+    int found = 0, err = 0;
+    uint64_t hashes[PROBE_GROUP];
+    uint32_t num_regions = 0, num_hits = 0;
+    while (q < q_end && !err && *num_candidates < max_candidates) {
+        // Hash a group, prefetch its slots, then probe
+        uint32_t group = q_end - q < PROBE_GROUP ? q_end - q : PROBE_GROUP;
+        for (uint32_t j = 0; j < group; j++) {
+            hashes[j] = fuse_hash(&filter.p, queries[q + j].end);
+            fuse_prefetch(&filter, hashes[j]);
+        }
+        stats->probes += group;
+        for (uint32_t j = 0; j < group; j++) {
+            if (!fuse_contains_hash(&filter, hashes[j])) continue;
+            stats->filter_hits++;
+
+            // Sorted queries that land in the same region share its read
+            hit_region r;
+            hit_range(e, fences, queries[q + j].end, &r);
+            if (num_regions == 0 || regions[num_regions - 1].first != r.first ||
+                regions[num_regions - 1].last != r.last) {
+                size_t bytes = (r.last - r.first) * io.record;
+                r.buf = bytes <= region_bytes ? buf_data + num_regions * region_bytes :
+                        malloc(bytes);
+                if (!r.buf) {
+                    err = 1;
+                    break;
+                }
+                regions[num_regions++] = r;
+            }
+            hits[num_hits].query = q + j;
+            hits[num_hits].region = num_regions - 1;
+            num_hits++;
+        }
+        q += group;
+
+        // Confirm a full batch, or whatever is left at the end
+        if (num_regions > CONFIRM_BATCH - PROBE_GROUP || num_hits > CONFIRM_HITS - PROBE_GROUP ||
+            q >= q_end || err) {
+            if (!err && read_regions(&io, regions, num_regions) != 0) err = 1;
+            for (uint32_t i = 0; i < num_hits && !err; i++) {
+                int n = confirm_hit(&io, &regions[hits[i].region], &queries[hits[i].query],
+                                    start_indices, positions, num_candidates, max_candidates);
+                found += n;
+                stats->confirmed += n;
+            }
+            for (uint32_t i = 0; i < num_regions; i++) {
+                stats->reads++;
+                stats->read_bytes += (regions[i].last - regions[i].first) * io.record;
+                if (regions[i].buf != buf_data + i * region_bytes) free(regions[i].buf);
+            }
+            num_regions = num_hits = 0;
+        }
+    }
+
+    free(regions);
+    free(hits);
+    free(buf_data);
+    if (io.use_ring) uring_exit(&io.ring);
+    close(io.fd);
+    if (io.starts_fd >= 0) close(io.starts_fd);
+    return err ? -1 : found;
+}
\ No newline at end of file
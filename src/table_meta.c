@@ -0,0 +1,83 @@
+#include <string.h>
+#include "table_meta.h"
+
+#define TABLE_META_VERSION 2
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static uint64_t fnv_update(uint64_t h, const void *data, size_t size) {
+    const uint8_t *p = data;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * FNV_PRIME;
+    }
+    for (; i < size; i++) h = (h ^ p[i]) * FNV_PRIME;
+    return h;
+}
+
+uint64_t table_meta_checksum(const void *data, size_t size) {
+    return fnv_update(FNV_OFFSET, data, size);
+}
+
+int64_t table_meta_write(FILE *out, size_t size, const uint64_t *ends, uint32_t stride,
+                         uint64_t n, uint32_t *flags) {
+    table_meta_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TABLE_META_MAGIC, 4);
+    h.version = TABLE_META_VERSION;
+    h.file_size = size;
+    h.num_chains = n;
+    h.first_end = n ? ends[0] : 0;
+    h.last_end = n ? ends[(n - 1) * stride] : 0;
+    h.record_size = stride * 8;
+    h.chains_per_page = TABLE_META_PAGE / h.record_size;
+    h.num_fences = (n + h.chains_per_page - 1) / h.chains_per_page;
+
+    h.flags = TABLE_META_SORTED;
+    for (uint64_t i = 1; i < n; i++) {
+        if (ends[i * stride] < ends[(i - 1) * stride]) {
+            h.flags &= ~TABLE_META_SORTED;
+            break;
+        }
+    }
+    *flags = h.flags;
+
+    // The header (checksum still 0) is rewritten once the fences are hashed;
+    // it is a whole number of words, so hashing it first and then the
+    // fences is the same as hashing the file
+    if (fwrite(&h, sizeof(h), 1, out) != 1) return -1;
+    uint64_t sum = table_meta_checksum(&h, sizeof(h));
+    for (uint64_t p = 0; p < h.num_fences; p++) {
+        uint64_t fence = ends[p * h.chains_per_page * stride];
+        if (fwrite(&fence, 8, 1, out) != 1) return -1;
+        sum = fnv_update(sum, &fence, 8);
+    }
+    h.checksum = sum;
+    if (fseek(out, 0, SEEK_SET) != 0 || fwrite(&h, sizeof(h), 1, out) != 1) return -1;
+    return (int64_t)(sizeof(h) + h.num_fences * 8);
+}
+
+int table_meta_open(const void *data, size_t size, const table_meta_header **header,
+                    const uint64_t **fences) {
+    const table_meta_header *h = data;
+    if (size < sizeof(table_meta_header) || memcmp(h->magic, TABLE_META_MAGIC, 4) != 0 ||
+        h->version != TABLE_META_VERSION ||
+        (h->record_size != 8 && h->record_size != 16) ||
+        h->chains_per_page != TABLE_META_PAGE / h->record_size ||
+        h->num_fences != (h->num_chains + h->chains_per_page - 1) / h->chains_per_page ||
+        sizeof(table_meta_header) + h->num_fences * 8 != size ||
+        h->num_chains * h->record_size != h->file_size) {
+        return -1;
+    }
+
+    // A torn or edited sidecar fails its checksum
+    table_meta_header copy = *h;
+    copy.checksum = 0;
+    uint64_t sum = fnv_update(table_meta_checksum(&copy, sizeof(copy)), h + 1, h->num_fences * 8);
+    if (sum != h->checksum) return -1;
+    *header = h;
+    *fences = (const uint64_t *)(h + 1);
+    return 0;
+}
\ No newline at end of file
@@ -11,6 +11,7 @@
 #define mkdir(path, mode) _mkdir(path)
 #else
 #include <sys/file.h>
+#include <sys/time.h>
 #include <unistd.h>
 #endif
 
@@ -41,6 +42,30 @@ static void ensure_dir(const char *dir) {
     mkdir(dir, 0755);
 }
 
+double get_time_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+#endif
+}
+
+int cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
 uint64_t get_plaintext_space(void) {
     uint64_t space = 1;
     for (int i = 0; i < PLAINTEXT_LEN_MAX; i++) space *= CHARSET_LEN;